@@ -14,6 +14,7 @@
 #include <fmt/core.h>
 
 #include <kep3/core_astro/convert_anomalies.hpp>
+#include <kep3/core_astro/convert_anomalies_batch.hpp>
 
 using kep3::e2m;
 using kep3::m2e;
@@ -24,7 +25,7 @@ using std::chrono::microseconds;
 // In this benchmark we test the speed and accuracy of the Kepler's equation
 // solvers
 
-void perform_test_speed(double min_ecc, double max_ecc, unsigned N)
+void perform_test_speed(double min_ecc, double max_ecc, unsigned N, kep3::kepler_solver solver)
 {
     //
     // Engines
@@ -51,14 +52,44 @@ void perform_test_speed(double min_ecc, double max_ecc, unsigned N)
 
     auto start = high_resolution_clock::now();
     for (auto i = 0u; i < N; ++i) {
-        m2e(mean_anomalies[i], eccenricities[i]);
+        m2e(mean_anomalies[i], eccenricities[i], solver);
     }
     auto stop = high_resolution_clock::now();
     auto duration = duration_cast<microseconds>(stop - start);
     fmt::print("{:.3f}s\n", (static_cast<double>(duration.count()) / 1e6));
 }
 
-void perform_test_accuracy(double min_ecc, double max_ecc, unsigned N)
+// Throughput of the scalar solver called in a loop vs the batch kernel (Mega conversions per second).
+void perform_test_throughput(double min_ecc, double max_ecc, unsigned N)
+{
+    // NOLINTNEXTLINE(cert-msc32-c, cert-msc51-cpp)
+    std::mt19937 rng_engine(122012203u);
+    std::uniform_real_distribution<double> ecc_d(min_ecc, max_ecc);
+    std::uniform_real_distribution<double> M_d(-1e8, 1e8);
+    std::vector<double> eccenricities(N);
+    std::vector<double> mean_anomalies(N);
+    std::vector<double> eccentric_anomalies(N);
+    for (auto i = 0u; i < N; ++i) {
+        mean_anomalies[i] = M_d(rng_engine);
+        eccenricities[i] = ecc_d(rng_engine);
+    }
+
+    fmt::print("{:.2f} min_ecc, {:.2f} max_ecc, on {} data points: ", min_ecc, max_ecc, N);
+    auto start = high_resolution_clock::now();
+    for (auto i = 0u; i < N; ++i) {
+        eccentric_anomalies[i] = m2e(mean_anomalies[i], eccenricities[i]);
+    }
+    auto stop = high_resolution_clock::now();
+    auto scalar = static_cast<double>(duration_cast<microseconds>(stop - start).count());
+    start = high_resolution_clock::now();
+    kep3::m2e_batch(mean_anomalies, eccenricities, eccentric_anomalies);
+    stop = high_resolution_clock::now();
+    auto batch = static_cast<double>(duration_cast<microseconds>(stop - start).count());
+    fmt::print("m2e {:.1f} Mconv/s, m2e_batch {:.1f} Mconv/s ({:.1f}x)\n", static_cast<double>(N) / scalar,
+               static_cast<double>(N) / batch, scalar / batch);
+}
+
+void perform_test_accuracy(double min_ecc, double max_ecc, unsigned N, kep3::kepler_solver solver)
 {
     //
     // Engines
@@ -84,7 +115,7 @@ void perform_test_accuracy(double min_ecc, double max_ecc, unsigned N)
     fmt::print("{:.2f} min_ecc, {:.2f} max_ecc, on {} data points: ", min_ecc, max_ecc, N);
     std::vector<double> err(N);
     for (auto i = 0u; i < N; ++i) {
-        auto res = e2m(m2e(mean_anomalies[i], eccenricities[i]), eccenricities[i]);
+        auto res = e2m(m2e(mean_anomalies[i], eccenricities[i], solver), eccenricities[i]);
         // error is arbitrarily: (|sinM-sinMtrue| +|cosM-cosMtrue|)/2
         err[i] = (std::abs(std::sin(res) - std::sin(mean_anomalies[i]))
                   + std::abs(std::cos(res) - std::cos(mean_anomalies[i])))
@@ -98,12 +129,23 @@ void perform_test_accuracy(double min_ecc, double max_ecc, unsigned N)
 
 int main()
 {
-    fmt::print("\nComputes speed at different eccentricity ranges:\n");
-    perform_test_speed(0, 0.5, 1000000);
-    perform_test_speed(0.5, 0.9, 1000000);
-    perform_test_speed(0.9, 0.99, 1000000);
-    fmt::print("\nComputes error at different eccentricity ranges:\n");
-    perform_test_accuracy(0, 0.5, 100000);
-    perform_test_accuracy(0.5, 0.9, 100000);
-    perform_test_accuracy(0.9, 0.99, 100000);
+    using kep3::kepler_solver;
+    for (auto solver : {kepler_solver::newton, kepler_solver::fixed}) {
+        fmt::print("\nComputes speed at different eccentricity ranges ({} solver):\n",
+                   solver == kepler_solver::newton ? "newton" : "fixed");
+        perform_test_speed(0, 0.5, 1000000, solver);
+        perform_test_speed(0.5, 0.9, 1000000, solver);
+        perform_test_speed(0.9, 0.99, 1000000, solver);
+    }
+    fmt::print("\nComputes the throughput of the batch kernel at different eccentricity ranges:\n");
+    perform_test_throughput(0, 0.5, 1000000);
+    perform_test_throughput(0.5, 0.9, 1000000);
+    perform_test_throughput(0.9, 0.99, 1000000);
+    for (auto solver : {kepler_solver::newton, kepler_solver::fixed}) {
+        fmt::print("\nComputes error at different eccentricity ranges ({} solver):\n",
+                   solver == kepler_solver::newton ? "newton" : "fixed");
+        perform_test_accuracy(0, 0.5, 100000, solver);
+        perform_test_accuracy(0.5, 0.9, 100000, solver);
+        perform_test_accuracy(0.9, 0.99, 100000, solver);
+    }
 }
\ No newline at end of file
@@ -0,0 +1,91 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include <fmt/core.h>
+
+#include <kep3/detail/lambert_batch_buffers.hpp>
+#include <kep3/lambert_batch.hpp>
+#include <kep3/lambert_problem.hpp>
+
+using std::chrono::duration_cast;
+using std::chrono::high_resolution_clock;
+using std::chrono::microseconds;
+
+// In this benchmark we compare the batch Lambert solver with the
+// object-per-problem loop (zero revolutions only).
+
+void perform_test_speed(unsigned N)
+{
+    //
+    // Engines
+    //
+    // NOLINTNEXTLINE(cert-msc32-c, cert-msc51-cpp)
+    std::mt19937 rng_engine(122012203u);
+    //
+    // Distributions
+    //
+    std::uniform_int_distribution<unsigned> cw_d(0, 1);
+    std::uniform_real_distribution<double> r_d(-2, 2);
+    std::uniform_real_distribution<double> tof_d(2., 40.);
+    std::uniform_real_distribution<double> mu_d(0.9, 1.1);
+
+    // We generate the random dataset (structure of arrays)
+    kep3::detail::lambert_batch_buffers data(N);
+    for (auto i = 0u; i < N; ++i) {
+        for (auto j = 0u; j < 3u; ++j) {
+            data.r0[j][i] = r_d(rng_engine);
+            data.r1[j][i] = r_d(rng_engine);
+        }
+        data.tof[i] = tof_d(rng_engine);
+        data.cw[i] = static_cast<std::uint8_t>(cw_d(rng_engine));
+        data.mu[i] = mu_d(rng_engine);
+    }
+
+    // We log progress
+    fmt::print("{} zero revolutions Lambert problems:\n", N);
+
+    // 1 - One kep3::lambert_problem per problem.
+    double checksum = 0.;
+    auto start = high_resolution_clock::now();
+    for (auto i = 0u; i < N; ++i) {
+        kep3::lambert_problem lp({data.r0[0][i], data.r0[1][i], data.r0[2][i]},
+                                 {data.r1[0][i], data.r1[1][i], data.r1[2][i]}, data.tof[i], data.mu[i],
+                                 data.cw[i] != 0u, 0u);
+        checksum += lp.get_x()[0];
+    }
+    auto stop = high_resolution_clock::now();
+    auto duration = duration_cast<microseconds>(stop - start);
+    fmt::print("lambert_problem loop: {:.3f}s (checksum {:.6e})\n", (static_cast<double>(duration.count()) / 1e6),
+               checksum);
+
+    // 2 - The batch solver.
+    start = high_resolution_clock::now();
+    kep3::lambert_solve_batch(data.input(), data.output());
+    stop = high_resolution_clock::now();
+    auto duration_batch = duration_cast<microseconds>(stop - start);
+    checksum = 0.;
+    for (auto item : data.x) {
+        checksum += item;
+    }
+    fmt::print("lambert_solve_batch:  {:.3f}s (checksum {:.6e})\n",
+               (static_cast<double>(duration_batch.count()) / 1e6), checksum);
+    fmt::print("Speedup: {:.2f}x\n",
+               static_cast<double>(duration.count()) / static_cast<double>(duration_batch.count()));
+}
+
+int main()
+{
+    perform_test_speed(1000000u);
+}
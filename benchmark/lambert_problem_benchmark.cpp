@@ -1,101 +1,395 @@
-/*****************************************************************************
- *   Copyright (C) 2004-2018 The pykep development team,                     *
- *   Advanced Concepts Team (ACT), European Space Agency (ESA)               *
- *                                                                           *
- *   https://gitter.im/esa/pykep                                             *
- *   https://github.com/esa/pykep                                            *
- *                                                                           *
- *   act@esa.int                                                             *
- *                                                                           *
- *   This program is free software; you can redistribute it and/or modify    *
- *   it under the terms of the GNU General Public License as published by    *
- *   the Free Software Foundation; either version 2 of the License, or       *
- *   (at your option) any later version.                                     *
- *                                                                           *
- *   This program is distributed in the hope that it will be useful,         *
- *   but WITHOUT ANY WARRANTY; without even the implied warranty of          *
- *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the           *
- *   GNU General Public License for more details.                            *
- *                                                                           *
- *   You should have received a copy of the GNU General Public License       *
- *   along with this program; if not, write to the                           *
- *   Free Software Foundation, Inc.,                                         *
- *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.               *
- *****************************************************************************/
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
 
+#include <algorithm>
 #include <array>
 #include <chrono>
-#include <iomanip>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <functional>
 #include <iostream>
+#include <limits>
 #include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <boost/program_options.hpp>
 
 #include <fmt/core.h>
 #include <fmt/ranges.h>
 
 #include <kep3/core_astro/constants.hpp>
-#include <kep3/core_astro/propagate_lagrangian.hpp>
+#include <kep3/detail/lambert_batch_buffers.hpp>
+#include <kep3/detail/lambert_math.hpp>
+#include <kep3/lambert_batch.hpp>
 #include <kep3/lambert_problem.hpp>
-#include <stdexcept>
 
-using std::chrono::duration_cast;
+using std::chrono::duration;
 using std::chrono::high_resolution_clock;
-using std::chrono::microseconds;
 
-int main()
-{
-    // Number of trials
-    const unsigned trials = 50000u;
+// In this benchmark we time kep3::lambert_problem (and the batch and single branch
+// solvers) on datasets representative of different use cases, reporting the time per
+// solution and the histogram of the Householder iterations. The results can also be
+// written as JSON, to track performance regressions across releases:
+//
+//   lambert_problem_benchmark --trials 100000 --json results.json
+
+// A dataset of Lambert problems (structure of arrays, as needed by the batch solver).
+struct dataset : kep3::detail::lambert_batch_buffers {
+    std::string name;
+    unsigned multi_revs = 0u;
+
+    dataset(std::string n, unsigned N, unsigned revs)
+        : kep3::detail::lambert_batch_buffers(N), name(std::move(n)), multi_revs(revs)
+    {
+    }
+    [[nodiscard]] unsigned size() const
+    {
+        return static_cast<unsigned>(tof.size());
+    }
+    [[nodiscard]] std::array<double, 3> get_r0(unsigned i) const
+    {
+        return {r0[0][i], r0[1][i], r0[2][i]};
+    }
+    [[nodiscard]] std::array<double, 3> get_r1(unsigned i) const
+    {
+        return {r1[0][i], r1[1][i], r1[2][i]};
+    }
+    [[nodiscard]] bool get_cw(unsigned i) const
+    {
+        return cw[i] != 0u;
+    }
+    void set(unsigned i, const std::array<double, 3> &p0, const std::array<double, 3> &p1, double t, double m, bool c)
+    {
+        for (auto j = 0u; j < 3u; ++j) {
+            r0[j][i] = p0[j];
+            r1[j][i] = p1[j];
+        }
+        tof[i] = t;
+        mu[i] = m;
+        cw[i] = c;
+    }
+};
+
+// The timing of one solver on one dataset.
+struct result {
+    std::string dataset, solver;
+    unsigned long problems = 0u, solutions = 0u;
+    double seconds = 0.;
+    // iters_histogram[k] counts the solutions found in k iterations.
+    std::vector<unsigned long> iters_histogram = std::vector<unsigned long>(16u, 0u);
+    double checksum = 0.;
 
-    std::array<std::array<double, 3>, trials> r1s{}, r2s{};
-    std::array<double, trials> tof{};
-    std::array<bool, trials> cw{};
-    std::array<double, trials> mu{};
+    [[nodiscard]] double ns_per_solution() const
+    {
+        return seconds * 1e9 / static_cast<double>(solutions);
+    }
+};
 
+std::array<double, 3> random_unit_vector(std::mt19937 &rng_engine)
+{
+    std::normal_distribution<double> n_d;
+    std::array<double, 3> u = {{n_d(rng_engine), n_d(rng_engine), n_d(rng_engine)}};
+    const double norm = std::sqrt(u[0] * u[0] + u[1] * u[1] + u[2] * u[2]);
+    for (auto &item : u) {
+        item /= norm;
+    }
+    return u;
+}
+
+// Uniformly distributed positions in a box, non dimensional units.
+dataset make_uniform(unsigned N, unsigned multi_revs)
+{
     // NOLINTNEXTLINE(cert-msc32-c, cert-msc51-cpp)
     std::mt19937 rng_engine(122012203u);
     std::uniform_int_distribution<unsigned> cw_d(0, 1);
     std::uniform_real_distribution<double> r_d(-2, 2);
     std::uniform_real_distribution<double> tof_d(2., 40.);
     std::uniform_real_distribution<double> mu_d(0.9, 1.1);
-    unsigned revs_max = 20u;
-    unsigned long count = 0lu;
-
-    for (auto i = 0u; i < trials; ++i) {
-        // 1 - generate a random problem geometry
-        r1s[i][0] = r_d(rng_engine);
-        r1s[i][1] = r_d(rng_engine);
-        r1s[i][2] = r_d(rng_engine);
-        r2s[i][0] = r_d(rng_engine);
-        r2s[i][1] = r_d(rng_engine);
-        r2s[i][2] = r_d(rng_engine);
-        tof[i] = tof_d(rng_engine);
-        cw[i] = static_cast<bool>(cw_d(rng_engine));
-        mu[i] = mu_d(rng_engine);
-    }
-
-    auto start = high_resolution_clock::now();
-    for (auto i = 0u; i < trials; ++i) {
-        // 2 - Solve the lambert problem
-        kep3::lambert_problem lp(r1s[i], r2s[i], tof[i], mu[i], cw[i], revs_max);
-        count = count + lp.get_vs().size();
-    }
-    auto stop = high_resolution_clock::now();
-    auto duration = duration_cast<microseconds>(stop - start);
-    fmt::print("Lambert:\n{} solutions computed in {:.3f}s\n", count, (static_cast<double>(duration.count()) / 1e6));
-    fmt::print("Projected number of solutions per second: {}\n",
-               static_cast<double>(count) / ((static_cast<double>(duration.count()) / 1e6)));
-
-    count = 0; // reset counter
-    start = high_resolution_clock::now();
-    for (auto i = 0u; i < trials; ++i) {
-        // 3 - Solve the lambert problem for the singe rev case
-        kep3::lambert_problem lp(r1s[i], r2s[i], tof[i], mu[i], cw[i], 0u);
-        count += 1u;
-    }
-    stop = high_resolution_clock::now();
-    duration = duration_cast<microseconds>(stop - start);
-    fmt::print("\nLambert (0 revs only):\n{} solutions computed in {:.3f}s\n", count,
-               (static_cast<double>(duration.count()) / 1e6));
-    fmt::print("Projected number of solutions per second: {}\n",
-               static_cast<double>(count) / ((static_cast<double>(duration.count()) / 1e6)));
-}
\ No newline at end of file
+    dataset d(fmt::format("uniform, multi_revs = {}", multi_revs), N, multi_revs);
+    for (auto i = 0u; i < N; ++i) {
+        const std::array<double, 3> p0 = {{r_d(rng_engine), r_d(rng_engine), r_d(rng_engine)}};
+        const std::array<double, 3> p1 = {{r_d(rng_engine), r_d(rng_engine), r_d(rng_engine)}};
+        d.set(i, p0, p1, tof_d(rng_engine), mu_d(rng_engine), static_cast<bool>(cw_d(rng_engine)));
+    }
+    return d;
+}
+
+// Transfer angles within 1e-6 - 1e-2 radians of 180 degrees (lambda close to 0).
+dataset make_near_180(unsigned N)
+{
+    // NOLINTNEXTLINE(cert-msc32-c, cert-msc51-cpp)
+    std::mt19937 rng_engine(23423u);
+    std::uniform_int_distribution<unsigned> cw_d(0, 1);
+    std::uniform_real_distribution<double> R_d(0.5, 2.);
+    std::uniform_real_distribution<double> log_angle_d(-6., -2.);
+    std::uniform_real_distribution<double> tof_d(2., 10.);
+    dataset d("near 180 degrees", N, 0u);
+    for (auto i = 0u; i < N; ++i) {
+        const auto u0 = random_unit_vector(rng_engine);
+        auto w = random_unit_vector(rng_engine);
+        // w is made orthogonal to u0.
+        const double proj = u0[0] * w[0] + u0[1] * w[1] + u0[2] * w[2];
+        double norm = 0.;
+        for (auto j = 0u; j < 3u; ++j) {
+            w[j] -= proj * u0[j];
+            norm += w[j] * w[j];
+        }
+        norm = std::sqrt(norm);
+        const double delta = std::pow(10., log_angle_d(rng_engine));
+        const double R0 = R_d(rng_engine), R1 = R_d(rng_engine);
+        std::array<double, 3> p0{}, p1{};
+        for (auto j = 0u; j < 3u; ++j) {
+            p0[j] = R0 * u0[j];
+            p1[j] = R1 * (-u0[j] * std::cos(delta) + w[j] / norm * std::sin(delta));
+        }
+        d.set(i, p0, p1, tof_d(rng_engine), 1., static_cast<bool>(cw_d(rng_engine)));
+    }
+    return d;
+}
+
+// Times of flight within a relative 1e-8 - 1e-2 of the parabolic one (x close to 1).
+dataset make_near_parabolic(unsigned N)
+{
+    // NOLINTNEXTLINE(cert-msc32-c, cert-msc51-cpp)
+    std::mt19937 rng_engine(872342u);
+    std::uniform_int_distribution<unsigned> cw_d(0, 1);
+    std::uniform_int_distribution<unsigned> sign_d(0, 1);
+    std::uniform_real_distribution<double> r_d(-2, 2);
+    std::uniform_real_distribution<double> log_delta_d(-8., -2.);
+    dataset d("near parabolic", N, 0u);
+    for (auto i = 0u; i < N; ++i) {
+        const std::array<double, 3> p0 = {{r_d(rng_engine), r_d(rng_engine), r_d(rng_engine)}};
+        const std::array<double, 3> p1 = {{r_d(rng_engine), r_d(rng_engine), r_d(rng_engine)}};
+        const bool cw = static_cast<bool>(cw_d(rng_engine));
+        const auto geo = kep3::detail::lambert_make_geometry(p0, p1, cw);
+        const double lambda = geo.lambda;
+        // The parabolic non dimensional time of flight.
+        const double T_p = 2. / 3. * (1. - lambda * lambda * lambda);
+        const double delta = (sign_d(rng_engine) != 0u ? 1. : -1.) * std::pow(10., log_delta_d(rng_engine));
+        const double tof = T_p * (1. + delta) / std::sqrt(2. / (geo.s * geo.s * geo.s));
+        d.set(i, p0, p1, tof, 1., cw);
+    }
+    return d;
+}
+
+// Long times of flight, with tens of revolutions.
+dataset make_high_multirev(unsigned N)
+{
+    // NOLINTNEXTLINE(cert-msc32-c, cert-msc51-cpp)
+    std::mt19937 rng_engine(3453u);
+    std::uniform_int_distribution<unsigned> cw_d(0, 1);
+    std::uniform_real_distribution<double> r_d(-2, 2);
+    std::uniform_real_distribution<double> tof_d(100., 300.);
+    dataset d("high multi revs, multi_revs = 100", N, 100u);
+    for (auto i = 0u; i < N; ++i) {
+        const std::array<double, 3> p0 = {{r_d(rng_engine), r_d(rng_engine), r_d(rng_engine)}};
+        const std::array<double, 3> p1 = {{r_d(rng_engine), r_d(rng_engine), r_d(rng_engine)}};
+        d.set(i, p0, p1, tof_d(rng_engine), 1., static_cast<bool>(cw_d(rng_engine)));
+    }
+    return d;
+}
+
+// Earth - Mars like transfers in SI units.
+dataset make_interplanetary(unsigned N)
+{
+    // NOLINTNEXTLINE(cert-msc32-c, cert-msc51-cpp)
+    std::mt19937 rng_engine(98723u);
+    std::uniform_real_distribution<double> angle_d(0., 2. * kep3::pi);
+    std::uniform_real_distribution<double> incl_d(-0.03, 0.03);
+    std::uniform_real_distribution<double> R0_d(0.98, 1.02);
+    std::uniform_real_distribution<double> R1_d(1.38, 1.67);
+    std::uniform_real_distribution<double> tof_d(100., 400.);
+    dataset d("interplanetary (SI)", N, 0u);
+    for (auto i = 0u; i < N; ++i) {
+        const double th0 = angle_d(rng_engine), th1 = angle_d(rng_engine);
+        const double i0 = incl_d(rng_engine), i1 = incl_d(rng_engine);
+        const double R0 = R0_d(rng_engine) * kep3::AU, R1 = R1_d(rng_engine) * kep3::AU;
+        const std::array<double, 3> p0
+            = {{R0 * std::cos(th0) * std::cos(i0), R0 * std::sin(th0) * std::cos(i0), R0 * std::sin(i0)}};
+        const std::array<double, 3> p1
+            = {{R1 * std::cos(th1) * std::cos(i1), R1 * std::sin(th1) * std::cos(i1), R1 * std::sin(i1)}};
+        d.set(i, p0, p1, tof_d(rng_engine) * kep3::DAY2SEC, kep3::MU_SUN, false);
+    }
+    return d;
+}
+
+// Runs f repeats times, returning the best time.
+double best_time(unsigned repeats, const std::function<void()> &f)
+{
+    double best = std::numeric_limits<double>::max();
+    for (auto k = 0u; k < repeats; ++k) {
+        const auto start = high_resolution_clock::now();
+        f();
+        const auto stop = high_resolution_clock::now();
+        best = std::min(best, duration<double>(stop - start).count());
+    }
+    return best;
+}
+
+void add_iters(result &res, unsigned iters)
+{
+    if (iters >= res.iters_histogram.size()) {
+        res.iters_histogram.resize(iters + 1u, 0u);
+    }
+    ++res.iters_histogram[iters];
+}
+
+// One kep3::lambert_problem per problem, all branches up to multi_revs.
+result time_lambert_problem(const dataset &d, unsigned repeats)
+{
+    result res{d.name, "lambert_problem"};
+    res.problems = d.size();
+    res.seconds = best_time(repeats, [&d, &res]() {
+        res.checksum = 0.;
+        for (auto i = 0u; i < d.size(); ++i) {
+            const kep3::lambert_problem lp(d.get_r0(i), d.get_r1(i), d.tof[i], d.mu[i], d.get_cw(i), d.multi_revs);
+            res.checksum += lp.get_x().back();
+        }
+    });
+    // The solutions and iterations are collected outside of the timed loop.
+    for (auto i = 0u; i < d.size(); ++i) {
+        const kep3::lambert_problem lp(d.get_r0(i), d.get_r1(i), d.tof[i], d.mu[i], d.get_cw(i), d.multi_revs);
+        res.solutions += lp.get_x().size();
+        for (auto it : lp.get_iters()) {
+            add_iters(res, it);
+        }
+    }
+    return res;
+}
+
+// The batch solver (zero revolutions only).
+result time_batch(const dataset &d, unsigned repeats)
+{
+    result res{d.name, "lambert_solve_batch"};
+    const auto N = d.size();
+    // The solutions are written to the outputs of sol, as d is const.
+    kep3::detail::lambert_batch_buffers sol(N);
+    res.problems = N;
+    res.solutions = N;
+    res.seconds = best_time(repeats, [&]() { kep3::lambert_solve_batch(d.input(), sol.output()); });
+    for (auto i = 0u; i < N; ++i) {
+        res.checksum += sol.x[i];
+        add_iters(res, sol.iters[i]);
+    }
+    return res;
+}
+
+// The single branch solver, for the right branch with the largest number of revolutions.
+result time_last_branch(const dataset &d, unsigned repeats)
+{
+    result res{d.name, "lambert_solve_branch (N_max, right)"};
+    std::vector<unsigned> Nmax(d.size());
+    for (auto i = 0u; i < d.size(); ++i) {
+        const kep3::lambert_problem lp(d.get_r0(i), d.get_r1(i), d.tof[i], d.mu[i], d.get_cw(i), d.multi_revs);
+        Nmax[i] = lp.get_Nmax();
+    }
+    const auto solve = [&](unsigned i) {
+        return kep3::lambert_solve_branch(d.get_r0(i), d.get_r1(i), d.tof[i], d.mu[i], d.get_cw(i), Nmax[i], true);
+    };
+    res.problems = d.size();
+    res.solutions = d.size();
+    res.seconds = best_time(repeats, [&]() {
+        res.checksum = 0.;
+        for (auto i = 0u; i < d.size(); ++i) {
+            res.checksum += solve(i).x;
+        }
+    });
+    for (auto i = 0u; i < d.size(); ++i) {
+        add_iters(res, solve(i).iters);
+    }
+    return res;
+}
+
+void print(const result &res)
+{
+    // The histogram is printed without its trailing zeros.
+    auto last = res.iters_histogram.size();
+    while (last > 0u && res.iters_histogram[last - 1u] == 0u) {
+        --last;
+    }
+    fmt::print("{:<36} {:<38} {:>10.1f} ns/solution ({} solutions, checksum {:.6e})\n", res.dataset, res.solver,
+               res.ns_per_solution(), res.solutions, res.checksum);
+    fmt::print("{:<36} iterations histogram: {}\n", "",
+               std::vector<unsigned long>(res.iters_histogram.begin(),
+                                          res.iters_histogram.begin() + static_cast<std::ptrdiff_t>(last)));
+}
+
+void write_json(const std::vector<result> &results, const std::string &filename)
+{
+    std::FILE *f = std::fopen(filename.c_str(), "w");
+    if (f == nullptr) {
+        fmt::print(stderr, "Could not open {} for writing\n", filename);
+        return;
+    }
+    fmt::print(f, "{{\n  \"benchmark\": \"lambert_problem\",\n  \"results\": [\n");
+    for (decltype(results.size()) i = 0u; i < results.size(); ++i) {
+        const auto &res = results[i];
+        fmt::print(f,
+                   "    {{\"dataset\": \"{}\", \"solver\": \"{}\", \"problems\": {}, \"solutions\": {}, "
+                   "\"seconds\": {}, \"ns_per_solution\": {}, \"iters_histogram\": [{}]}}{}\n",
+                   res.dataset, res.solver, res.problems, res.solutions, res.seconds, res.ns_per_solution(),
+                   fmt::join(res.iters_histogram, ", "), (i + 1u < results.size()) ? "," : "");
+    }
+    fmt::print(f, "  ]\n}}\n");
+    std::fclose(f);
+    fmt::print("\nResults written to {}\n", filename);
+}
+
+int main(int argc, char *argv[])
+{
+    namespace po = boost::program_options;
+
+    unsigned trials = 0u, repeats = 0u;
+    std::string json;
+
+    po::options_description desc("Options");
+    desc.add_options()("help", "produce help message")(
+        "trials", po::value<unsigned>(&trials)->default_value(50000u), "number of problems per dataset")(
+        "repeats", po::value<unsigned>(&repeats)->default_value(5u), "number of timed runs (the best is reported)")(
+        "json", po::value<std::string>(&json), "write the results as JSON to this file");
+    po::variables_map vm;
+    po::store(po::parse_command_line(argc, argv, desc), vm);
+    po::notify(vm);
+    if (vm.count("help") != 0u) {
+        std::cout << desc << "\n";
+        return 0;
+    }
+
+    std::vector<result> results;
+    auto run = [&results](result res) {
+        print(res);
+        results.push_back(std::move(res));
+    };
+
+    // Zero revolutions: the object and the batch APIs.
+    std::vector<dataset> zero_revs;
+    zero_revs.push_back(make_uniform(trials, 0u));
+    zero_revs.push_back(make_near_180(trials));
+    zero_revs.push_back(make_near_parabolic(trials));
+    zero_revs.push_back(make_interplanetary(trials));
+    for (const auto &d : zero_revs) {
+        run(time_lambert_problem(d, repeats));
+        run(time_batch(d, repeats));
+    }
+    // Multiple revolutions: all the branches or only one.
+    std::vector<dataset> multi_revs;
+    multi_revs.push_back(make_uniform(trials, 20u));
+    multi_revs.push_back(make_high_multirev(trials / 10u));
+    for (const auto &d : multi_revs) {
+        run(time_lambert_problem(d, repeats));
+        run(time_last_branch(d, repeats));
+    }
+
+    if (!json.empty()) {
+        write_json(results, json);
+    }
+}
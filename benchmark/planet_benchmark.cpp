@@ -0,0 +1,125 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <random>
+#include <span>
+#include <string>
+#include <vector>
+
+#include <fmt/core.h>
+
+#include <kep3/epoch.hpp>
+#include <kep3/planet.hpp>
+#include <kep3/planets/jpl_lp.hpp>
+#include <kep3/planets/keplerian.hpp>
+
+using std::chrono::duration_cast;
+using std::chrono::high_resolution_clock;
+using std::chrono::nanoseconds;
+
+// In this benchmark we measure the overhead of the type erasure in kep3::planet, comparing
+// the ephemerides computed by calling the udpla directly with those computed through the
+// planet interface, one epoch per call (eph) and many epochs per call (eph_v, eph_into).
+
+// A udpla whose ephemerides cost (almost) nothing: the timings are then those of the calls.
+struct circular_udpla {
+    [[nodiscard]] std::array<std::array<double, 3>, 2> eph(double mjd2000) const
+    {
+        const double s = std::sin(mjd2000), c = std::cos(mjd2000);
+        return {{{c, s, 0.}, {-s, c, 0.}}};
+    }
+};
+
+template <typename Time>
+double ns_per_epoch(Time start, Time stop, std::size_t N)
+{
+    return static_cast<double>(duration_cast<nanoseconds>(stop - start).count()) / static_cast<double>(N);
+}
+
+template <typename UDPLA>
+void perform_test_speed(const UDPLA &udpla, const std::string &name, unsigned N)
+{
+    // NOLINTNEXTLINE(cert-msc32-c, cert-msc51-cpp)
+    std::mt19937 rng_engine(122012203u);
+    std::uniform_real_distribution<double> mjd2000_d(0., 10000.);
+    std::vector<double> mjd2000s(N);
+    std::vector<kep3::epoch> epochs;
+    epochs.reserve(N);
+    for (auto &mjd2000 : mjd2000s) {
+        mjd2000 = mjd2000_d(rng_engine);
+        epochs.emplace_back(mjd2000);
+    }
+    const kep3::planet pla{udpla};
+    std::vector<double> out(6u * N);
+
+    // We log progress
+    fmt::print("{}, {} epochs (ns per epoch, checksum):\n", name, N);
+
+    // 1 - The udpla called directly.
+    double checksum = 0.;
+    auto start = high_resolution_clock::now();
+    for (const auto mjd2000 : mjd2000s) {
+        checksum += udpla.eph(mjd2000)[0][0];
+    }
+    auto stop = high_resolution_clock::now();
+    fmt::print("udpla.eph(double):         {:8.2f} ({:.6e})\n", ns_per_epoch(start, stop, N), checksum);
+
+    // 2 - One virtual call per epoch.
+    checksum = 0.;
+    start = high_resolution_clock::now();
+    for (const auto mjd2000 : mjd2000s) {
+        checksum += pla.eph(mjd2000)[0][0];
+    }
+    stop = high_resolution_clock::now();
+    fmt::print("planet.eph(double):        {:8.2f} ({:.6e})\n", ns_per_epoch(start, stop, N), checksum);
+
+    checksum = 0.;
+    start = high_resolution_clock::now();
+    for (const auto &ep : epochs) {
+        checksum += pla.eph(ep)[0][0];
+    }
+    stop = high_resolution_clock::now();
+    fmt::print("planet.eph(epoch):         {:8.2f} ({:.6e})\n", ns_per_epoch(start, stop, N), checksum);
+
+    // 3 - One virtual call for all the epochs.
+    start = high_resolution_clock::now();
+    const auto values = pla.eph_v(mjd2000s);
+    stop = high_resolution_clock::now();
+    fmt::print("planet.eph_v:              {:8.2f} ({:.6e})\n", ns_per_epoch(start, stop, N), values[6u * (N - 1u)]);
+
+    start = high_resolution_clock::now();
+    pla.eph_into(mjd2000s, out);
+    stop = high_resolution_clock::now();
+    fmt::print("planet.eph_into:           {:8.2f} ({:.6e})\n", ns_per_epoch(start, stop, N), out[6u * (N - 1u)]);
+
+    // 4 - One virtual call per chunk of epochs, reusing the output buffer.
+    constexpr std::size_t chunk = 64u;
+    checksum = 0.;
+    start = high_resolution_clock::now();
+    for (std::size_t i = 0u; i < N; i += chunk) {
+        const auto n = std::min(chunk, N - i);
+        pla.eph_into(std::span<const double>(mjd2000s.data() + i, n), std::span<double>(out.data(), 6u * n));
+        checksum += out[0];
+    }
+    stop = high_resolution_clock::now();
+    fmt::print("planet.eph_into ({} each): {:8.2f} ({:.6e})\n\n", chunk, ns_per_epoch(start, stop, N), checksum);
+}
+
+int main()
+{
+    perform_test_speed(circular_udpla{}, "Trivial udpla", 1000000u);
+    perform_test_speed(kep3::udpla::keplerian{kep3::epoch(0.), std::array<double, 6>{1., 0.1, 0.2, 0.3, 0.4, 0.5}, 1.},
+                       "keplerian", 1000000u);
+    perform_test_speed(kep3::udpla::jpl_lp{"earth"}, "jpl_lp", 1000000u);
+}
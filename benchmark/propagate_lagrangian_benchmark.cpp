@@ -11,6 +11,8 @@
 #include <iostream>
 #include <kep3/core_astro/ic2par2ic.hpp>
 #include <kep3/core_astro/propagate_lagrangian.hpp>
+#include <kep3/core_astro/propagate_lagrangian_batch.hpp>
+#include <kep3/instrumentation.hpp>
 #include <random>
 
 #include <fmt/core.h>
@@ -74,6 +76,128 @@ void perform_test_speed(double min_ecc, double max_ecc, unsigned N,
     fmt::print("{:.3f}s\n", (static_cast<double>(duration.count()) / 1e6));
 }
 
+void perform_test_speed_batch(double min_ecc, double max_ecc, unsigned N, bool stm = false)
+{
+    //
+    // Engines
+    //
+    // NOLINTNEXTLINE(cert-msc32-c, cert-msc51-cpp)
+    std::mt19937 rng_engine(122012203u);
+    //
+    // Distributions
+    //
+    std::uniform_real_distribution<double> sma_d(0.5, 20.);
+    std::uniform_real_distribution<double> ecc_d(min_ecc, max_ecc);
+    std::uniform_real_distribution<double> incl_d(0., pi);
+    std::uniform_real_distribution<double> Omega_d(0, 2 * pi);
+    std::uniform_real_distribution<double> omega_d(0., 2 * pi);
+    std::uniform_real_distribution<double> f_d(0, 2 * pi);
+    std::uniform_real_distribution<double> tof_d(10., 100.);
+
+    // We generate the random dataset (same as perform_test_speed), in SoA layout
+    std::array<std::vector<double>, 3> r{std::vector<double>(N), std::vector<double>(N), std::vector<double>(N)};
+    std::array<std::vector<double>, 3> v{r};
+    std::vector<double> tofs(N);
+    for (auto i = 0u; i < N; ++i) {
+        auto ecc = ecc_d(rng_engine);
+        auto sma = sma_d(rng_engine);
+        ecc > 1. ? sma = -sma : sma;
+        double f = pi;
+        while (std::cos(f) < -1. / ecc && sma < 0.) {
+            f = f_d(rng_engine);
+        }
+        const auto pos_vel
+            = kep3::par2ic({sma, ecc, incl_d(rng_engine), Omega_d(rng_engine), omega_d(rng_engine), f}, 1.);
+        for (auto j = 0u; j < 3u; ++j) {
+            r[j][i] = pos_vel[0][j];
+            v[j][i] = pos_vel[1][j];
+        }
+        tofs[i] = tof_d(rng_engine);
+    }
+
+    // We log progress
+    fmt::print("{:.2f} min_ecc, {:.2f} max_ecc, on {} data points: ", min_ecc, max_ecc, N);
+
+    std::vector<double> stms(stm ? 36u * N : 0u);
+    auto start = high_resolution_clock::now();
+    if (stm) {
+        kep3::propagate_lagrangian_stm_batch({{r[0], r[1], r[2]}, {v[0], v[1], v[2]}}, tofs, 1., stms);
+    } else {
+        kep3::propagate_lagrangian_batch({{r[0], r[1], r[2]}, {v[0], v[1], v[2]}}, tofs, 1.);
+    }
+    auto stop = high_resolution_clock::now();
+    auto duration = duration_cast<microseconds>(stop - start);
+    fmt::print("{:.3f}s\n", (static_cast<double>(duration.count()) / 1e6));
+}
+
+// Mean number of Newton iterations recorded for the solver s (needs kep3_ENABLE_INSTRUMENTATION).
+double mean_iterations(kep3::instrumentation::solver s)
+{
+    const auto snap = kep3::instrumentation::get_snapshot();
+    const auto &hist = snap.iters[static_cast<unsigned>(s)];
+    double calls = 0., iters = 0.;
+    for (decltype(hist.size()) k = 0u; k < hist.size(); ++k) {
+        calls += static_cast<double>(hist[k]);
+        iters += static_cast<double>(k * hist[k]);
+    }
+    return iters / calls;
+}
+
+void perform_test_hyperbolic(double min_ecc, double max_ecc, unsigned N)
+{
+    //
+    // Engines
+    //
+    // NOLINTNEXTLINE(cert-msc32-c, cert-msc51-cpp)
+    std::mt19937 rng_engine(122012203u);
+    //
+    // Distributions
+    //
+    std::uniform_real_distribution<double> sma_d(0.5, 20.);
+    std::uniform_real_distribution<double> ecc_d(min_ecc, max_ecc);
+    std::uniform_real_distribution<double> incl_d(0., pi);
+    std::uniform_real_distribution<double> Omega_d(0, 2 * pi);
+    std::uniform_real_distribution<double> omega_d(0., 2 * pi);
+    std::uniform_real_distribution<double> f_d(0, 2 * pi);
+    std::uniform_real_distribution<double> tof_d(10., 100.);
+
+    // We generate the random dataset (flybys and escapes, within the asymptotes)
+    std::vector<std::array<std::array<double, 3>, 2>> pos_vels(N);
+    std::vector<double> tofs(N);
+    for (auto i = 0u; i < N; ++i) {
+        auto ecc = ecc_d(rng_engine);
+        double f = f_d(rng_engine);
+        while (std::cos(f) < -1. / ecc) {
+            f = f_d(rng_engine);
+        }
+        pos_vels[i] = kep3::par2ic(
+            {-sma_d(rng_engine), ecc, incl_d(rng_engine), Omega_d(rng_engine), omega_d(rng_engine), f}, 1.);
+        tofs[i] = tof_d(rng_engine);
+    }
+
+    // We log progress
+    fmt::print("{:.2f} min_ecc, {:.2f} max_ecc, on {} data points:", min_ecc, max_ecc, N);
+    for (const bool universal : {false, true}) {
+        kep3::instrumentation::reset();
+        auto start = high_resolution_clock::now();
+        for (auto i = 0u; i < N; ++i) {
+            auto pos_vel = pos_vels[i];
+            universal ? kep3::propagate_lagrangian_u(pos_vel, tofs[i], 1.)
+                      : kep3::propagate_lagrangian(pos_vel, tofs[i], 1.);
+        }
+        auto stop = high_resolution_clock::now();
+        auto duration = duration_cast<microseconds>(stop - start);
+        fmt::print(" {} {:.3f}s", universal ? "propagate_lagrangian_u" : "propagate_lagrangian",
+                   (static_cast<double>(duration.count()) / 1e6));
+        if (kep3::instrumentation::enabled()) {
+            fmt::print(" ({:.2f} iterations)",
+                       mean_iterations(universal ? kep3::instrumentation::solver::propagate_lagrangian_u
+                                                 : kep3::instrumentation::solver::propagate_lagrangian_hyperbolic));
+        }
+    }
+    fmt::print("\n");
+}
+
 void perform_test_accuracy(double min_ecc, double max_ecc, unsigned N,
                            const std::function<void(std::array<std::array<double, 3>, 2> &, double, double)> &propagate)
 {
@@ -138,23 +262,49 @@ int main()
     perform_test_speed(0.9, 0.99, 1000000, &kep3::propagate_lagrangian);
     perform_test_speed(1.1, 10., 1000000, &kep3::propagate_lagrangian);
 
+    fmt::print("\nComputes speed at different eccentricity ranges [batch]:\n");
+    perform_test_speed_batch(0, 0.5, 1000000);
+    perform_test_speed_batch(0.5, 0.9, 1000000);
+    perform_test_speed_batch(0.9, 0.99, 1000000);
+    perform_test_speed_batch(1.1, 10., 1000000);
+
+    fmt::print("\nComputes speed at different eccentricity ranges [with STM]:\n");
+    auto propagate_stm = [](std::array<std::array<double, 3>, 2> &pos_vel, double dt, double mu) {
+        kep3::propagate_lagrangian_stm(pos_vel, dt, mu);
+    };
+    perform_test_speed(0, 0.5, 1000000, propagate_stm);
+    perform_test_speed(0.5, 0.9, 1000000, propagate_stm);
+    perform_test_speed(0.9, 0.99, 1000000, propagate_stm);
+    perform_test_speed(1.1, 10., 1000000, propagate_stm);
+
+    fmt::print("\nComputes speed at different eccentricity ranges [batch, with STM]:\n");
+    perform_test_speed_batch(0, 0.5, 1000000, true);
+    perform_test_speed_batch(0.5, 0.9, 1000000, true);
+    perform_test_speed_batch(0.9, 0.99, 1000000, true);
+    perform_test_speed_batch(1.1, 10., 1000000, true);
+
     fmt::print("\nComputes error at different eccentricity ranges:\n");
     perform_test_accuracy(0, 0.5, 100000, &kep3::propagate_lagrangian);
     perform_test_accuracy(0.5, 0.9, 100000, &kep3::propagate_lagrangian);
     perform_test_accuracy(0.9, 0.99, 100000, &kep3::propagate_lagrangian);
-    //
-    // fmt::print("\nComputes speed at different eccentricity ranges [Universal "
-    //           "Anomaly]:\n");
-    // perform_test_speed(0, 0.5, 1000000, &kep3::propagate_lagrangian_u);
-    // perform_test_speed(0.5, 0.9, 1000000, &kep3::propagate_lagrangian_u);
-    // perform_test_speed(0.9, 0.99, 1000000, &kep3::propagate_lagrangian_u);
-    // perform_test_speed(1.1, 10., 1000000, &kep3::propagate_lagrangian_u);
-    //
-    // fmt::print("\nComputes error at different eccentricity ranges [Universal "
-    //           "Anomaly]:\n");
-    // perform_test_accuracy(0, 0.5, 100000, &kep3::propagate_lagrangian_u);
-    // perform_test_accuracy(0.5, 0.9, 100000, &kep3::propagate_lagrangian_u);
-    // perform_test_accuracy(0.9, 0.99, 100000, &kep3::propagate_lagrangian_u);
+
+    fmt::print("\nComputes speed (and iterations, if instrumented) on hyperbolas [Lagrangian and Universal "
+               "Anomaly]:\n");
+    perform_test_hyperbolic(1.01, 1.1, 1000000);
+    perform_test_hyperbolic(1.1, 2., 1000000);
+    perform_test_hyperbolic(2., 10., 1000000);
+    perform_test_hyperbolic(10., 100., 1000000);
+
+    fmt::print("\nComputes speed at different eccentricity ranges [Universal Anomaly]:\n");
+    perform_test_speed(0, 0.5, 1000000, &kep3::propagate_lagrangian_u);
+    perform_test_speed(0.5, 0.9, 1000000, &kep3::propagate_lagrangian_u);
+    perform_test_speed(0.9, 0.99, 1000000, &kep3::propagate_lagrangian_u);
+    perform_test_speed(1.1, 10., 1000000, &kep3::propagate_lagrangian_u);
+
+    fmt::print("\nComputes error at different eccentricity ranges [Universal Anomaly]:\n");
+    perform_test_accuracy(0, 0.5, 100000, &kep3::propagate_lagrangian_u);
+    perform_test_accuracy(0.5, 0.9, 100000, &kep3::propagate_lagrangian_u);
+    perform_test_accuracy(0.9, 0.99, 100000, &kep3::propagate_lagrangian_u);
     //
     // fmt::print("\nComputes speed at different eccentricity ranges [keplerian "
     //           "propagation]:\n");
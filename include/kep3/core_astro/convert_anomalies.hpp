@@ -19,10 +19,20 @@
 
 #include <kep3/core_astro/constants.hpp>
 #include <kep3/core_astro/kepler_equations.hpp>
+#include <kep3/detail/m2e_fixed.hpp>
+#include <kep3/instrumentation.hpp>
 
 namespace kep3
 {
 
+// Solvers for Kepler's equation in m2e and m2f.
+enum class kepler_solver {
+    // Newton-Raphson iterations to full precision (throws if not converged).
+    newton,
+    // Mikkola's starter and two Danby corrections: fixed cost and no convergence checks.
+    fixed
+};
+
 // mean to eccentric (only ellipses) e<1. Preserves the sign and integer number
 // of revolutions.
 // NOLINTNEXTLINE(bugprone-easily-swappable-parameters)
@@ -51,12 +61,24 @@ inline double m2e(double M, double ecc)
     double sol = boost::math::tools::newton_raphson_iterate(
         [M_cropped, ecc](double E) { return std::make_tuple(kepE(E, M_cropped, ecc), d_kepE(E, ecc)); }, IG,
         IG - kep3::pi, IG + kep3::pi, digits, max_iter);
+    instrumentation::record_iters(instrumentation::solver::m2e, max_iter);
     if (max_iter == 100u) {
+        instrumentation::record_event(instrumentation::event::m2e_throw);
         throw std::domain_error("Maximum number of iterations exceeded when solving Kepler's "
                                 "equation for the eccentric anomaly in m2e.");
     }
     return sol;
 }
+
+// mean to eccentric (only ellipses) e<1, using the chosen solver. kepler_solver::fixed does
+// not throw and has a data independent cost. Its error on E is within a few ulps times the
+// condition number of Kepler's equation 1 / (1 - ecc cosE), as for the Newton solver.
+// NOLINTNEXTLINE(bugprone-easily-swappable-parameters)
+inline double m2e(double M, double ecc, kepler_solver solver)
+{
+    return solver == kepler_solver::fixed ? detail::m2e_fixed(M, ecc) : m2e(M, ecc);
+}
+
 // eccentric to mean (only ellipses) e<1
 inline double e2m(double E, double ecc)
 {
@@ -93,6 +115,16 @@ inline double m2f(double M, double ecc)
     return e2f(m2e(M, ecc), ecc);
 }
 
+// mean to true (only ellipses) e<1, using the chosen solver (returns in range [-pi,pi])
+// NOLINTNEXTLINE(bugprone-easily-swappable-parameters)
+inline double m2f(double M, double ecc, kepler_solver solver)
+{
+    if (ecc >= 1) {
+        return std::numeric_limits<double>::quiet_NaN();
+    };
+    return e2f(m2e(M, ecc, solver), ecc);
+}
+
 // true to mean (only ellipses) e<1 (returns in range [-pi,pi])
 inline double f2m(double f, double ecc)
 {
@@ -127,17 +159,19 @@ inline double n2h(double N, double ecc)
     if (ecc <= 1) {
         return std::numeric_limits<double>::quiet_NaN();
     };
-    // The Initial guess (TODO(darioizo) improve)
-    double IG = 1.;
+    // The initial guess and bracket.
+    const auto [IG, lb, ub] = kepH_starter(N, ecc);
 
     const int digits = std::numeric_limits<double>::digits;
     std::uintmax_t max_iter = 100u;
 
     // Newton-raphson iterates.
     double sol = boost::math::tools::newton_raphson_iterate(
-        [N, ecc](double H) { return std::make_tuple(kepH(H, N, ecc), d_kepH(H, ecc)); }, IG, IG - 20 * kep3::pi,
-        IG + 20 * kep3::pi, digits, max_iter);
+        [N, ecc](double H) { return std::make_tuple(kepH(H, N, ecc), d_kepH(H, ecc)); }, IG, lb, ub, digits,
+        max_iter);
+    instrumentation::record_iters(instrumentation::solver::n2h, max_iter);
     if (max_iter == 100u) {
+        instrumentation::record_event(instrumentation::event::n2h_throw);
         throw std::domain_error("Maximum number of iterations exceeded when solving Kepler's "
                                 "equation for the hyperbolic anomaly in m2h.");
     }
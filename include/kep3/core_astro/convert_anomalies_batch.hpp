@@ -0,0 +1,53 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef kep3_CONVERT_ANOMALIES_BATCH_H
+#define kep3_CONVERT_ANOMALIES_BATCH_H
+
+#include <span>
+
+#include <kep3/detail/visibility.hpp>
+
+namespace kep3
+{
+
+/// Batch anomaly conversions
+/**
+ * Each function applies the homonymous conversion of convert_anomalies.hpp (e.g. kep3::m2e)
+ * to the pairs (x[i], ecc[i]), writing the result to out[i]. out may be the same span as x.
+ *
+ * No exception is thrown for invalid inputs: where the scalar version returns NaN (e.g. ecc >= 1
+ * in m2e) or throws (Kepler's equation not solved), NaN is written.
+ *
+ * m2e, m2f, n2h and n2f do not call the scalar Newton solvers: Kepler's equation is solved with
+ * a fixed number of fourth order (Danby) iterations starting from Mikkola's cubic approximation,
+ * which is accurate to ~1e-3 for all eccentricities. Being branch-free, the elliptic kernel
+ * (including sin and cos, evaluated via polynomials) is vectorised over the array, with the
+ * widest instruction set supported by the running CPU selected at runtime on x86.
+ *
+ * @throws std::invalid_argument if x, ecc and out do not have the same size.
+ */
+kep3_DLL_PUBLIC void m2e_batch(std::span<const double> x, std::span<const double> ecc, std::span<double> out);
+kep3_DLL_PUBLIC void e2m_batch(std::span<const double> x, std::span<const double> ecc, std::span<double> out);
+kep3_DLL_PUBLIC void m2f_batch(std::span<const double> x, std::span<const double> ecc, std::span<double> out);
+kep3_DLL_PUBLIC void f2m_batch(std::span<const double> x, std::span<const double> ecc, std::span<double> out);
+kep3_DLL_PUBLIC void e2f_batch(std::span<const double> x, std::span<const double> ecc, std::span<double> out);
+kep3_DLL_PUBLIC void f2e_batch(std::span<const double> x, std::span<const double> ecc, std::span<double> out);
+kep3_DLL_PUBLIC void n2h_batch(std::span<const double> x, std::span<const double> ecc, std::span<double> out);
+kep3_DLL_PUBLIC void h2n_batch(std::span<const double> x, std::span<const double> ecc, std::span<double> out);
+kep3_DLL_PUBLIC void n2f_batch(std::span<const double> x, std::span<const double> ecc, std::span<double> out);
+kep3_DLL_PUBLIC void f2n_batch(std::span<const double> x, std::span<const double> ecc, std::span<double> out);
+kep3_DLL_PUBLIC void h2f_batch(std::span<const double> x, std::span<const double> ecc, std::span<double> out);
+kep3_DLL_PUBLIC void f2h_batch(std::span<const double> x, std::span<const double> ecc, std::span<double> out);
+kep3_DLL_PUBLIC void zeta2f_batch(std::span<const double> x, std::span<const double> ecc, std::span<double> out);
+kep3_DLL_PUBLIC void f2zeta_batch(std::span<const double> x, std::span<const double> ecc, std::span<double> out);
+
+} // namespace kep3
+
+#endif // kep3_CONVERT_ANOMALIES_BATCH_H
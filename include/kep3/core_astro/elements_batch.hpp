@@ -0,0 +1,55 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef kep3_ELEMENTS_BATCH_H
+#define kep3_ELEMENTS_BATCH_H
+
+#include <array>
+#include <span>
+
+#include <kep3/detail/visibility.hpp>
+
+namespace kep3
+{
+
+/// Six components of a batch of Cartesian states or orbital elements
+/**
+ * Structure of arrays: the i-th state (x, y, z, vx, vy, vz) or set of elements (ordered as
+ * in the scalar conversions, e.g. [a, e, i, W, w, f] for kep3::ic2par) is defined by the i-th
+ * entry of each span.
+ */
+using elements_batch_input = std::array<std::span<const double>, 6>;
+using elements_batch_output = std::array<std::span<double>, 6>;
+
+/// Batch element conversions
+/**
+ * Each function applies the homonymous conversion of ic2par2ic.hpp, ic2eq2ic.hpp or eq2par2eq.hpp
+ * (e.g. kep3::ic2par) to every entry of the input, writing the result to the same entry of the output.
+ * The output may be the same spans as the input.
+ *
+ * The numerics are those of the scalar versions, written as plain arithmetic on the structure of arrays
+ * (no temporaries are allocated). The arithmetic is vectorised, the trigonometric functions are evaluated
+ * in separate loops.
+ *
+ * @throws std::invalid_argument if the spans do not all have the same size.
+ * @throws std::domain_error if, in par2ic_batch, some elements are not valid (see kep3::par2ic). The
+ * content of the output is then unspecified.
+ */
+kep3_DLL_PUBLIC void ic2par_batch(const elements_batch_input &pos_vel, double mu, const elements_batch_output &par);
+kep3_DLL_PUBLIC void par2ic_batch(const elements_batch_input &par, double mu, const elements_batch_output &pos_vel);
+kep3_DLL_PUBLIC void ic2eq_batch(const elements_batch_input &pos_vel, double mu, bool retrogade,
+                                 const elements_batch_output &eq);
+kep3_DLL_PUBLIC void eq2ic_batch(const elements_batch_input &eq, double mu, bool retrogade,
+                                 const elements_batch_output &pos_vel);
+kep3_DLL_PUBLIC void par2eq_batch(const elements_batch_input &par, bool retrogade, const elements_batch_output &eq);
+kep3_DLL_PUBLIC void eq2par_batch(const elements_batch_input &eq, bool retrogade, const elements_batch_output &par);
+
+} // namespace kep3
+
+#endif // kep3_ELEMENTS_BATCH_H
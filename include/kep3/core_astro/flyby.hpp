@@ -0,0 +1,54 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef kep3_FLYBY_H
+#define kep3_FLYBY_H
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace kep3
+{
+
+/// Delta-v of a powered flyby
+/**
+ * The minimum delta-v needed to turn the incoming relative velocity v_rel_in into the outgoing
+ * v_rel_out during a flyby of a planet with gravity parameter mu, the pericenter radius being at
+ * least rp. The maximum deflection of an unpowered hyperbola, 2 asin(1 / e_min) with
+ * e_min = 1 + rp |v_rel_in|^2 / mu, is given for free: only the missing deflection, and the change
+ * of magnitude of the relative velocity, cost delta-v.
+ *
+ * @param v_rel_in the incoming velocity relative to the planet.
+ * @param v_rel_out the outgoing velocity relative to the planet.
+ * @param mu the gravity parameter of the planet.
+ * @param rp the minimum pericenter radius (e.g. the safe radius of the planet).
+ *
+ * @return the delta-v.
+ */
+inline double fb_dv(const std::array<double, 3> &v_rel_in, const std::array<double, 3> &v_rel_out, double mu,
+                    double rp)
+{
+    const double vin2 = v_rel_in[0] * v_rel_in[0] + v_rel_in[1] * v_rel_in[1] + v_rel_in[2] * v_rel_in[2];
+    const double vout2 = v_rel_out[0] * v_rel_out[0] + v_rel_out[1] * v_rel_out[1] + v_rel_out[2] * v_rel_out[2];
+    const double vin_vout = std::sqrt(vin2 * vout2);
+    const double cos_alpha
+        = (v_rel_in[0] * v_rel_out[0] + v_rel_in[1] * v_rel_out[1] + v_rel_in[2] * v_rel_out[2]) / vin_vout;
+    const double e_min = 1. + rp / mu * vin2;
+    // The deflection that the unpowered hyperbola cannot provide.
+    const double missing = std::acos(std::clamp(cos_alpha, -1., 1.)) - 2. * std::asin(1. / e_min);
+    if (missing > 0.) {
+        return std::sqrt(vout2 + vin2 - 2. * vin_vout * std::cos(missing));
+    }
+    return std::abs(std::sqrt(vout2) - std::sqrt(vin2));
+}
+
+} // namespace kep3
+
+#endif // kep3_FLYBY_H
@@ -10,7 +10,10 @@
 #ifndef kep3_KEPLER_EQUATIONS_H
 #define kep3_KEPLER_EQUATIONS_H
 
+#include <algorithm>
+#include <array>
 #include <cmath>
+#include <limits>
 
 #include <kep3/core_astro/special_functions.hpp>
 
@@ -50,6 +53,35 @@ inline double dd_kepH(double H, double ecc)
 {
     return ecc * std::sinh(H);
 }
+
+// Initial guess and bracket for Kepler's equation in H, e sinhH - H = N (ecc > 1).
+struct kepH_start {
+    double guess, lb, ub;
+};
+
+inline kepH_start kepH_starter(double N, double ecc)
+{
+    const double Na = std::abs(N);
+    // Mikkola's cubic approximation, with the fifth order correction.
+    const double den = 4. * ecc + 0.5;
+    const double alpha = (ecc - 1.) / den;
+    const double beta = 0.5 * Na / den;
+    const double z = std::cbrt(beta + std::sqrt(beta * beta + alpha * alpha * alpha));
+    double s = z - alpha / z;
+    s += 0.071 * s * s * s * s * s / ((1. + 0.45 * s * s) * (1. + 4. * s * s) * ecc);
+    // For N >= 0, H >= 0 and e sinhH = N + H >= N, hence H >= asinh(N / e). As sinhH >= H + H^3 / 6,
+    // also (e - 1) sinhH <= N and e H^3 / 6 <= N, hence H <= u = min(asinh(N / (e - 1)), cbrt(6 N / e))
+    // and then H = asinh((N + H) / e) <= asinh((N + u) / e). On H >= 0 kepH is increasing and convex:
+    // Newton's iterations started from the upper bound converge monotonically.
+    // The bounds are widened by a few ulps, as they can be sharp (e.g., ub for small N), and ub by the
+    // smallest normal number, so that lb < ub also for N = 0.
+    const double lb = std::asinh(Na / ecc) * (1. - 1e-14);
+    const double ub
+        = std::asinh((Na + std::min(std::asinh(Na / (ecc - 1.)), std::cbrt(6. * Na / ecc))) / ecc) * (1. + 1e-14)
+          + std::numeric_limits<double>::min();
+    const double guess = std::clamp(3. * std::asinh(s), lb, ub);
+    return N < 0. ? kepH_start{-guess, -ub, -lb} : kepH_start{guess, lb, ub};
+}
 // -------------------------------------------
 
 // In terms of the eccentric anomaly difference (DE)
@@ -86,13 +118,25 @@ inline double dd_kepDH(double DH, double sigma0, double sqrta, double a, double
     return sigma0 / sqrta * std::cosh(DH) + (1 - R / a) * std::sinh(DH);
 }
 
+// Initial guess and bracket for Kepler's equation in DH, from those of the equation in the hyperbolic
+// anomaly H = H0 + DH (kep3::kepH_starter). s0 = e sinhH0 and c0 = e coshH0 are the coefficients
+// of kepDH (sigma0 / sqrta and 1 - R / a), hence e = sqrt(c0^2 - s0^2) and N = DN + s0 - H0.
+inline kepH_start kepDH_starter(double DN, double s0, double c0)
+{
+    const double ecc = std::sqrt((c0 - s0) * (c0 + s0));
+    const double H0 = std::asinh(s0 / ecc);
+    const auto [guess, lb, ub] = kepH_starter(DN + s0 - H0, ecc);
+    // The bracket is widened to cover the roundoff in H0 and N.
+    const double pad = 1e-8 * (1. + std::abs(H0));
+    return {guess - H0, lb - H0 - pad, ub - H0 + pad};
+}
+
 // In terms of the universal anomaly difference (DS)
 // -------------------------------------------
 inline double kepDS(const double &DS, const double &DT, const double &r0, const double &vr0, const double &alpha,
                     const double &mu)
 {
-    double S = stumpff_s(alpha * DS * DS);
-    double C = stumpff_c(alpha * DS * DS);
+    const auto [C, S] = stumpff(alpha * DS * DS);
     double retval
         = -std::sqrt(mu) * DT + r0 * vr0 * DS * DS * C / std::sqrt(mu) + (1 - alpha * r0) * DS * DS * DS * S + r0 * DS;
     return (retval);
@@ -100,20 +144,29 @@ inline double kepDS(const double &DS, const double &DT, const double &r0, const
 
 inline double d_kepDS(const double &DS, const double &r0, const double &vr0, const double &alpha, const double &mu)
 {
-    double S = stumpff_s(alpha * DS * DS);
-    double C = stumpff_c(alpha * DS * DS);
+    const auto [C, S] = stumpff(alpha * DS * DS);
     double retval = r0 * vr0 / std::sqrt(mu) * DS * (1 - alpha * DS * DS * S) + (1 - alpha * r0) * DS * DS * C + r0;
     return (retval);
 }
 
 inline double dd_kepDS(const double &DS, const double &r0, const double &vr0, const double &alpha, const double &mu)
 {
-    double S = stumpff_s(alpha * DS * DS);
-    double C = stumpff_c(alpha * DS * DS);
-    double retval = r0 * vr0 / std::sqrt(mu) * (1 - alpha * DS * DS * C) + (1 - alpha * r0) * (1 - DS * DS * S);
-
+    const auto [C, S] = stumpff(alpha * DS * DS);
+    double retval
+        = r0 * vr0 / std::sqrt(mu) * (1 - alpha * DS * DS * C) + (1 - alpha * r0) * DS * (1 - alpha * DS * DS * S);
     return (retval);
 }
 
+// Kepler's equation and its first derivative, sharing one evaluation of the Stumpff functions.
+// sigma0 = r0 * vr0 / sqrt(mu) and sqrt_mu are precomputed by the caller.
+inline std::array<double, 2> kepDS_d_kepDS(double DS, double DT, double r0, double sigma0, double alpha,
+                                           double sqrt_mu)
+{
+    const double DS2 = DS * DS;
+    const auto [C, S] = stumpff(alpha * DS2);
+    return {-sqrt_mu * DT + sigma0 * DS2 * C + (1 - alpha * r0) * DS2 * DS * S + r0 * DS,
+            sigma0 * DS * (1 - alpha * DS2 * S) + (1 - alpha * r0) * DS2 * C + r0};
+}
+
 } // namespace kep3
 #endif // kep3_KEPLER_EQUATIONS_H
@@ -11,6 +11,7 @@
 #define kep3_PROPAGATE_LAGRANGIAN_H
 
 #include <array>
+#include <span>
 
 #include <kep3/detail/visibility.hpp>
 
@@ -27,6 +28,30 @@ namespace kep3
 
 kep3_DLL_PUBLIC void propagate_lagrangian(std::array<std::array<double, 3>, 2> &pos_vel, double dt, double mu);
 
+/// Lagrangian propagation with state transition matrix
+/**
+ * As kep3::propagate_lagrangian, also returning the 6x6 state transition matrix d(r, v) / d(r0, v0)
+ * of the propagation in row major order. The matrix is assembled analytically from the Lagrange
+ * coefficients (Battin, Section 9.7): no additional solution of Kepler's equation is needed.
+ */
+kep3_DLL_PUBLIC std::array<double, 36> propagate_lagrangian_stm(std::array<std::array<double, 3>, 2> &pos_vel,
+                                                                double dt, double mu);
+
+/// Lagrangian propagation to many times
+/**
+ * Propagates pos_vel, as kep3::propagate_lagrangian does, by each of the times of flight dts, writing
+ * the N final states to out, a contiguous (N, 6) row major buffer ([x, y, z, vx, vy, vz] per row).
+ * The quantities of the initial state (energy, semi-major axis, R, sigma0) are computed once and each
+ * solution of Kepler's equation is warm started from the previous one: when dts is sorted (or otherwise
+ * finely spaced) this is faster than N calls to kep3::propagate_lagrangian. The results agree with those
+ * up to the tolerance of the solver.
+ *
+ * @throws std::invalid_argument if the size of out is not 6 times that of dts.
+ * @throws std::domain_error if Kepler's equation could not be solved (as kep3::propagate_lagrangian).
+ */
+kep3_DLL_PUBLIC void propagate_lagrangian_grid(const std::array<std::array<double, 3>, 2> &pos_vel,
+                                               std::span<const double> dts, double mu, std::span<double> out);
+
 kep3_DLL_PUBLIC void propagate_lagrangian_u(std::array<std::array<double, 3>, 2> &pos_vel, double dt, double mu);
 
 kep3_DLL_PUBLIC void propagate_keplerian(std::array<std::array<double, 3>, 2> &pos_vel, double dt, double mu);
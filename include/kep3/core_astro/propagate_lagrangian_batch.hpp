@@ -0,0 +1,96 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef kep3_PROPAGATE_LAGRANGIAN_BATCH_H
+#define kep3_PROPAGATE_LAGRANGIAN_BATCH_H
+
+#include <array>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <kep3/core_astro/propagate_lagrangian.hpp>
+#include <kep3/detail/visibility.hpp>
+
+namespace kep3
+{
+
+/// Cartesian states of a batch of objects
+/**
+ * Structure of arrays: the i-th state is defined by the i-th entry of each span.
+ * r and v hold the x, y and z components of the positions and velocities.
+ */
+struct pos_vel_batch {
+    std::array<std::span<double>, 3> r;
+    std::array<std::span<double>, 3> v;
+};
+
+/// Batch Lagrangian propagation
+/**
+ * Propagates, in place, the i-th state of pos_vel for a time dt[i] assuming a central body
+ * with gravity parameter mu and a keplerian motion. The numerics are those of kep3::propagate_lagrangian
+ * (Kepler's equation is solved in DE for ellipses and in DH for hyperbolae), but no memory is allocated
+ * and the states are processed in groups of 4 (AVX2) or 8 (AVX-512) lanes, the widest kernel supported
+ * by the running CPU being selected at runtime. Elsewhere, a scalar kernel is used.
+ *
+ * All spans must have the same size. A std::invalid_argument is thrown otherwise, before any state is
+ * modified. A std::domain_error is thrown, as in kep3::propagate_lagrangian, if Kepler's equation cannot
+ * be solved for some state: this happens after the whole batch has been processed, the states for which
+ * it could not be solved being left unchanged and all the others propagated.
+ */
+kep3_DLL_PUBLIC void propagate_lagrangian_batch(const pos_vel_batch &pos_vel, std::span<const double> dt, double mu);
+
+/// Batch Lagrangian propagation with state transition matrices
+/**
+ * As kep3::propagate_lagrangian_batch, also writing the state transition matrix of the i-th state
+ * (see kep3::propagate_lagrangian_stm) to stms[36 * i], ..., stms[36 * i + 35] in row major order.
+ *
+ * A std::invalid_argument is thrown if the state spans do not have the size of dt, or if stms
+ * does not have 36 times the size of dt. The state transition matrices of the states left unchanged
+ * on a std::domain_error are not written.
+ */
+kep3_DLL_PUBLIC void propagate_lagrangian_stm_batch(const pos_vel_batch &pos_vel, std::span<const double> dt,
+                                                    double mu, std::span<double> stms);
+
+/// Outcome of the propagation of one state by kep3::propagate_lagrangian_parallel()
+enum class propagate_status : std::uint8_t {
+    // The state was propagated.
+    success = 0,
+    // Kepler's equation could not be solved (a std::domain_error was thrown): the state is unchanged.
+    failure = 1
+};
+
+/// Parallel propagation of a catalog of states
+/**
+ * Propagates, in place and on all available cores, the i-th state of pos_vels for a time dt[i],
+ * calling propagate (e.g. kep3::propagate_lagrangian or kep3::propagate_lagrangian_u) once per state.
+ * The catalog is split into fixed-size chunks, so that the work done per state does not depend
+ * on the number of threads.
+ *
+ * A state for which propagate throws a std::domain_error is left unchanged and flagged in the
+ * returned status vector, the other states are propagated regardless.
+ *
+ * @param pos_vels the states.
+ * @param dt the propagation times.
+ * @param mu the gravity parameter of the central body.
+ * @param propagate the propagator.
+ *
+ * @return the status of each state.
+ *
+ * @throws std::invalid_argument if pos_vels and dt have different sizes.
+ */
+kep3_DLL_PUBLIC std::vector<propagate_status>
+propagate_lagrangian_parallel(std::span<std::array<std::array<double, 3>, 2>> pos_vels, std::span<const double> dt,
+                              double mu,
+                              void (*propagate)(std::array<std::array<double, 3>, 2> &, double, double)
+                              = &propagate_lagrangian);
+
+} // namespace kep3
+
+#endif // kep3_PROPAGATE_LAGRANGIAN_BATCH_H
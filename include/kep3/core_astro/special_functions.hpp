@@ -36,6 +36,37 @@ inline double stumpff_c(const double x)
         return 0.5;
     }
 }
+
+// The Stumpff functions C(z) and S(z), evaluated together.
+struct stumpff_cs {
+    double c;
+    double s;
+};
+
+// Evaluates C(z) and S(z) with a single square root and a single sin/cos (or exp) pair. Close to z = 0,
+// where the expressions of stumpff_c and stumpff_s lose digits to cancellation, the Taylor series are
+// used instead (truncated after z^10, well below the double precision roundoff for |z| < 1).
+inline stumpff_cs stumpff(const double z)
+{
+    if (std::abs(z) < 1.) {
+        // C(z) = 1/2! (1 - z/(3 4) (1 - z/(5 6) (1 - ...))), S(z) = 1/3! (1 - z/(4 5) (1 - z/(6 7) (1 - ...))).
+        double c = 1., s = 1.;
+        for (int k = 10; k >= 1; --k) {
+            c = 1. - z / ((2 * k + 1) * (2 * k + 2)) * c;
+            s = 1. - z / ((2 * k + 2) * (2 * k + 3)) * s;
+        }
+        return {c / 2., s / 6.};
+    }
+    if (z > 0.) {
+        const double x = std::sqrt(z);
+        return {(1. - std::cos(x)) / z, (x - std::sin(x)) / (z * x)};
+    }
+    const double x = std::sqrt(-z);
+    const double ex = std::exp(x);
+    const double sh = (ex - 1. / ex) / 2., ch = (ex + 1. / ex) / 2.;
+    return {(ch - 1.) / (-z), (sh - x) / (-z * x)};
+}
+
 } // namespace kep3
 
 #endif // kep3_SPECIAL_FUNCTIONS_H
\ No newline at end of file
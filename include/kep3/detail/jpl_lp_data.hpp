@@ -0,0 +1,99 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef kep3_DETAIL_JPL_LP_DATA_H
+#define kep3_DETAIL_JPL_LP_DATA_H
+
+#include <array>
+#include <cmath>
+#include <string_view>
+
+namespace kep3::detail
+{
+
+// The data of one of the planets of the JPL low-precision ephemerides.
+struct jpl_lp_body_data {
+    // a,e,i,L,W,w and their rates per century.
+    std::array<double, 6> elements;
+    std::array<double, 6> elements_dot;
+    std::string_view name;
+    double radius;
+    double safe_radius;
+    double mu_self;
+};
+
+// Data from: https://ssd.jpl.nasa.gov/planets/approx_pos.html
+// clang-format off
+inline constexpr std::array<jpl_lp_body_data, 8> jpl_lp_bodies = {{
+    {{0.38709927, 0.20563593, 7.00497902, 252.25032350, 77.45779628, 48.33076593},
+     {0.00000037, 0.00001906, -0.00594749, 149472.67411175, 0.16047689, -0.12534081},
+     "mercury", 2440000., 1.1 * 2440000., 22032e9},
+    {{0.72333566, 0.00677672, 3.39467605, 181.97909950, 131.60246718, 76.67984255},
+     {0.00000390, -0.00004107, -0.00078890, 58517.81538729, 0.00268329, -0.27769418},
+     "venus", 6052000., 1.1 * 6052000., 324859e9},
+    {{1.00000261, 0.01671123, -0.00001531, 100.46457166, 102.93768193, 0.0},
+     {0.00000562, -0.00004392, -0.01294668, 35999.37244981, 0.32327364, 0.0},
+     "earth", 6378000., 1.1 * 6378000., 398600.4418e9},
+    {{1.52371034, 0.09339410, 1.84969142, -4.55343205, -23.94362959, 49.55953891},
+     {0.00001847, 0.00007882, -0.00813131, 19140.30268499, 0.44441088, -0.29257343},
+     "mars", 3397000., 1.1 * 3397000., 42828e9},
+    {{5.20288700, 0.04838624, 1.30439695, 34.39644051, 14.72847983, 100.47390909},
+     {-0.00011607, -0.00013253, -0.00183714, 3034.74612775, 0.21252668, 0.20469106},
+     "jupiter", 71492000., 9. * 71492000., 126686534e9},
+    {{9.53667594, 0.05386179, 2.48599187, 49.95424423, 92.59887831, 113.66242448},
+     {-0.00125060, -0.00050991, 0.00193609, 1222.49362201, -0.41897216, -0.28867794},
+     "saturn", 60330000., 1.1 * 60330000., 37931187e9},
+    {{19.18916464, 0.04725744, 0.77263783, 313.23810451, 170.95427630, 74.01692503},
+     {-0.00196176, -0.00004397, -0.00242939, 428.48202785, 0.40805281, 0.04240589},
+     "uranus", 25362000., 1.1 * 25362000., 5793939e9},
+    {{30.06992276, 0.00859048, 1.77004347, -55.12002969, 44.96476227, 131.78422574},
+     {0.00026291, 0.00005105, 0.00035372, 218.45945325, -0.32241464, -0.00508664},
+     "neptune", 24622000., 1.1 * 24622000., 6836529e9},
+}};
+// clang-format on
+
+// Position and velocity (written to out as x, y, z, vx, vy, vz) on the ellipse of semi-major
+// axis sma, eccentricity ecc, inclination inc, RAAN omg and argument of pericentre omp, at the
+// eccentric anomaly E, given its sine and cosine. Same as kep3::par2ic, but it avoids the
+// conversion of E to the true anomaly.
+// NOLINTNEXTLINE(bugprone-easily-swappable-parameters)
+inline void jpl_lp_e2ic(double sma, double ecc, double inc, double omg, double omp, double sinE, double cosE,
+                        double mu, double *out)
+{
+    // 1 - We evaluate position and velocity in the perifocal reference system.
+    const double beta = std::sqrt(1. - ecc * ecc);
+    const double r = sma * (1. - ecc * cosE);
+    const double vfac = std::sqrt(mu * sma) / r;
+    const double x_per = sma * (cosE - ecc);
+    const double y_per = sma * beta * sinE;
+    const double xdot_per = -vfac * sinE;
+    const double ydot_per = vfac * beta * cosE;
+
+    // 2 - We rotate them to the inertial frame (only the first two columns of the rotation matrix are needed).
+    const double cosomg = std::cos(omg), sinomg = std::sin(omg);
+    const double cosomp = std::cos(omp), sinomp = std::sin(omp);
+    const double cosi = std::cos(inc), sini = std::sin(inc);
+    const double R00 = cosomg * cosomp - sinomg * sinomp * cosi;
+    const double R01 = -cosomg * sinomp - sinomg * cosomp * cosi;
+    const double R10 = sinomg * cosomp + cosomg * sinomp * cosi;
+    const double R11 = -sinomg * sinomp + cosomg * cosomp * cosi;
+    const double R20 = sinomp * sini;
+    const double R21 = cosomp * sini;
+
+    out[0] = R00 * x_per + R01 * y_per;
+    out[1] = R10 * x_per + R11 * y_per;
+    out[2] = R20 * x_per + R21 * y_per;
+    out[3] = R00 * xdot_per + R01 * ydot_per;
+    out[4] = R10 * xdot_per + R11 * ydot_per;
+    out[5] = R20 * xdot_per + R21 * ydot_per;
+}
+
+} // namespace kep3::detail
+
+#endif // kep3_DETAIL_JPL_LP_DATA_H
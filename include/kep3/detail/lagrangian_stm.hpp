@@ -0,0 +1,93 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef kep3_DETAIL_LAGRANGIAN_STM_HPP
+#define kep3_DETAIL_LAGRANGIAN_STM_HPP
+
+#include <array>
+#include <cmath>
+
+// The state transition matrix of Keplerian motion, assembled from the Lagrange
+// coefficients as described in:
+//
+// Battin, Richard H. "An Introduction to the Mathematics and Methods of
+// Astrodynamics", AIAA (1999), Section 9.7.
+//
+// It is shared by kep3::propagate_lagrangian_stm and by the batch propagator.
+namespace kep3::detail
+{
+
+// Battin's C function, here written in terms of the anomaly difference x (DE for ellipses, DH for
+// hyperbolae), which must include the full revolutions. C and S are cos(x) and sin(x) for ellipses
+// (a > 0) and cosh(x) and sinh(x) for hyperbolae. With the universal functions U_n, C reads
+// (3 U5 - chi U4) / sqrt(mu) - dt U2, where 3 U5 - chi U4 = |a|^(5/2) (3 S - 2 x - x C).
+inline double battin_c(double a, double x, double C, double S, double dt, double mu)
+{
+    double q = 0.;
+    if (std::abs(x) < 1.) {
+        // 3 S - 2 x - x C cancels down to -+x^5 / 60: we use its Taylor series instead,
+        // x^5 sum_{k>=2} (2 - 2k) / (2k+1)! y^(k-2), with y = -x^2 (ellipses) or x^2 (hyperbolae).
+        constexpr std::array<double, 10> coeffs
+            = {-0.016666666666666666,   -0.00079365079365079365, -1.6534391534391536e-05, -2.0041686708353376e-07,
+               -1.6059043836821615e-09, -9.1765964781837793e-12, -3.936040156083729e-14,  -1.3153016394598927e-16,
+               -3.5231293914104271e-19, -7.7363403412613678e-22};
+        const double y = (a > 0) ? -x * x : x * x;
+        for (auto it = coeffs.rbegin(); it != coeffs.rend(); ++it) {
+            q = q * y + *it;
+        }
+        q *= x * x * x * x * x;
+    } else {
+        q = 3. * S - 2. * x - x * C;
+    }
+    const double sqrta = std::sqrt(std::abs(a));
+    return sqrta * sqrta * sqrta * sqrta * sqrta * q / std::sqrt(mu) - dt * a * (1. - C);
+}
+
+// Writes to stm the 6x6 state transition matrix d(r, v) / d(r0, v0) (row major) of the Keplerian
+// propagation of (r0, v0) into (r, v), given the Lagrange coefficients and Battin's C.
+// NOLINTNEXTLINE(bugprone-easily-swappable-parameters)
+inline void lagrangian_stm(const std::array<double, 3> &r0, const std::array<double, 3> &v0,
+                           const std::array<double, 3> &r, const std::array<double, 3> &v, double F, double G,
+                           double Ft, double Gt, double C, double mu, double *stm)
+{
+    const double R0 = std::sqrt(r0[0] * r0[0] + r0[1] * r0[1] + r0[2] * r0[2]);
+    const double R = std::sqrt(r[0] * r[0] + r[1] * r[1] + r[2] * r[2]);
+    const double R03 = R0 * R0 * R0, R3 = R * R * R;
+    const double rv = r[0] * v[0] + r[1] * v[1] + r[2] * v[2];
+    // The scalar factors of the four blocks.
+    const double k_rr = R / mu, k_rr0 = R0 * (1. - F) / R03, k_vr0 = C / R03;
+    const double k_rv0 = R0 / mu * (1. - F), k_vv0 = C / mu;
+    const double k_dvr0 = 1. / (R0 * R0), k_rdv = 1. / (R * R), k_rr0_v = mu * C / (R3 * R03);
+    const double k_vv = R0 / mu, k_rr0_3 = R0 * (1. - F) / R3, k_rv0_3 = C / R3;
+    std::array<double, 3> dr{}, dv{}, w{};
+    for (auto i = 0u; i < 3u; ++i) {
+        dr[i] = r[i] - r0[i];
+        dv[i] = v[i] - v0[i];
+        // (r v^T - v r^T) r / (mu R)
+        w[i] = (r[i] * rv - v[i] * R * R) / (mu * R);
+    }
+    for (auto i = 0u; i < 3u; ++i) {
+        for (auto j = 0u; j < 3u; ++j) {
+            const double d = (i == j) ? 1. : 0.;
+            // dr / dr0
+            stm[6u * i + j] = k_rr * dv[i] * dv[j] + (k_rr0 * r[i] + k_vr0 * v[i]) * r0[j] + F * d;
+            // dr / dv0
+            stm[6u * i + 3u + j] = k_rv0 * (dr[i] * v0[j] - dv[i] * r0[j]) + k_vv0 * v[i] * v0[j] + G * d;
+            // dv / dr0
+            stm[6u * (i + 3u) + j] = -k_dvr0 * dv[i] * r0[j] - k_rdv * r[i] * dv[j] - k_rr0_v * r[i] * r0[j]
+                                     + Ft * (d - k_rdv * r[i] * r[j] + w[i] * dv[j]);
+            // dv / dv0
+            stm[6u * (i + 3u) + 3u + j] = k_vv * dv[i] * dv[j] + (k_rr0_3 * r0[j] - k_rv0_3 * v0[j]) * r[i] + Gt * d;
+        }
+    }
+}
+
+} // namespace kep3::detail
+
+#endif // kep3_DETAIL_LAGRANGIAN_STM_HPP
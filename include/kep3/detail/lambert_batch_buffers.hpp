@@ -0,0 +1,92 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef kep3_DETAIL_LAMBERT_BATCH_BUFFERS_HPP
+#define kep3_DETAIL_LAMBERT_BATCH_BUFFERS_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include <kep3/lambert_batch.hpp>
+
+namespace kep3::detail
+{
+
+// The inputs and outputs of n Lambert problems, stored as a structure of arrays,
+// to be solved with kep3::lambert_solve_batch().
+struct lambert_batch_buffers {
+    explicit lambert_batch_buffers(std::size_t n)
+        : r0{std::vector<double>(n), std::vector<double>(n), std::vector<double>(n)},
+          r1{std::vector<double>(n), std::vector<double>(n), std::vector<double>(n)}, tof(n), mu(n), cw(n),
+          v0{std::vector<double>(n), std::vector<double>(n), std::vector<double>(n)},
+          v1{std::vector<double>(n), std::vector<double>(n), std::vector<double>(n)}, x(n), iters(n)
+    {
+    }
+    [[nodiscard]] std::size_t size() const
+    {
+        return tof.size();
+    }
+    [[nodiscard]] lambert_batch_input input(std::size_t b, std::size_t n) const
+    {
+        return {{std::span(r0[0]).subspan(b, n), std::span(r0[1]).subspan(b, n), std::span(r0[2]).subspan(b, n)},
+                {std::span(r1[0]).subspan(b, n), std::span(r1[1]).subspan(b, n), std::span(r1[2]).subspan(b, n)},
+                std::span(tof).subspan(b, n),
+                std::span(mu).subspan(b, n),
+                std::span<const std::uint8_t>(cw).subspan(b, n)};
+    }
+    [[nodiscard]] lambert_batch_input input() const
+    {
+        return input(0u, size());
+    }
+    [[nodiscard]] lambert_batch_output output(std::size_t b, std::size_t n)
+    {
+        return {{std::span(v0[0]).subspan(b, n), std::span(v0[1]).subspan(b, n), std::span(v0[2]).subspan(b, n)},
+                {std::span(v1[0]).subspan(b, n), std::span(v1[1]).subspan(b, n), std::span(v1[2]).subspan(b, n)},
+                std::span(x).subspan(b, n),
+                std::span(iters).subspan(b, n)};
+    }
+    [[nodiscard]] lambert_batch_output output()
+    {
+        return output(0u, size());
+    }
+    // Solves the first n problems. If some of them are not defined (e.g. the direction of motion
+    // cannot be determined), they are solved one by one and the offending ones get NaN velocities.
+    void solve(std::size_t n)
+    {
+        try {
+            lambert_solve_batch(input(0u, n), output(0u, n));
+        } catch (const std::domain_error &) {
+            for (std::size_t j = 0u; j < n; ++j) {
+                try {
+                    lambert_solve_batch(input(j, 1u), output(j, 1u));
+                } catch (const std::domain_error &) {
+                    for (auto k = 0u; k < 3u; ++k) {
+                        v0[k][j] = std::numeric_limits<double>::quiet_NaN();
+                        v1[k][j] = std::numeric_limits<double>::quiet_NaN();
+                    }
+                }
+            }
+        }
+    }
+    std::array<std::vector<double>, 3> r0, r1;
+    std::vector<double> tof, mu;
+    std::vector<std::uint8_t> cw;
+    std::array<std::vector<double>, 3> v0, v1;
+    std::vector<double> x;
+    std::vector<unsigned> iters;
+};
+
+} // namespace kep3::detail
+
+#endif // kep3_DETAIL_LAMBERT_BATCH_BUFFERS_HPP
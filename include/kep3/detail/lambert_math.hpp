@@ -0,0 +1,421 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef kep3_DETAIL_LAMBERT_MATH_HPP
+#define kep3_DETAIL_LAMBERT_MATH_HPP
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <span>
+#include <stdexcept>
+
+#include <kep3/core_astro/constants.hpp>
+#include <kep3/instrumentation.hpp>
+
+// The building blocks of the Lambert solver described in:
+//
+// Izzo, Dario. "Revisiting Lambert’s problem." Celestial Mechanics and
+// Dynamical Astronomy 121 (2015): 1-15.
+//
+// They are shared by kep3::lambert_problem and by the batch solvers, so that
+// all the Lambert entry points run exactly the same numerics.
+namespace kep3::detail
+{
+
+// The geometry of a Lambert problem: chord, semi-perimeter, lambda and the
+// radial/tangential unit vectors at the two points.
+struct lambert_geometry {
+    double c, s, lambda, R0, R1;
+    std::array<double, 3> ir0, ir1, it0, it1;
+};
+
+// Computes the problem geometry using plain arithmetic on the input arrays.
+inline lambert_geometry lambert_make_geometry(const std::array<double, 3> &r0, const std::array<double, 3> &r1,
+                                              bool cw)
+{
+    lambert_geometry g{};
+    const std::array<double, 3> dr = {{r1[0] - r0[0], r1[1] - r0[1], r1[2] - r0[2]}};
+    g.c = std::sqrt(dr[0] * dr[0] + dr[1] * dr[1] + dr[2] * dr[2]);
+    g.R0 = std::sqrt(r0[0] * r0[0] + r0[1] * r0[1] + r0[2] * r0[2]);
+    g.R1 = std::sqrt(r1[0] * r1[0] + r1[1] * r1[1] + r1[2] * r1[2]);
+    g.s = (g.c + g.R0 + g.R1) / 2.0;
+
+    for (auto j = 0u; j < 3u; ++j) {
+        g.ir0[j] = r0[j] / g.R0;
+        g.ir1[j] = r1[j] / g.R1;
+    }
+    std::array<double, 3> ih = {{g.ir0[1] * g.ir1[2] - g.ir0[2] * g.ir1[1], g.ir0[2] * g.ir1[0] - g.ir0[0] * g.ir1[2],
+                                 g.ir0[0] * g.ir1[1] - g.ir0[1] * g.ir1[0]}};
+    const double H = std::sqrt(ih[0] * ih[0] + ih[1] * ih[1] + ih[2] * ih[2]);
+    for (auto &item : ih) {
+        item /= H;
+    }
+
+    if (ih[2] == 0) {
+        throw std::domain_error("lambert_problem: The angular momentum vector has no z component, "
+                                "impossible to define automatically clock or "
+                                "counterclockwise");
+    }
+    const double lambda2 = 1.0 - g.c / g.s;
+    g.lambda = std::sqrt(lambda2);
+
+    g.it0 = {{ih[1] * g.ir0[2] - ih[2] * g.ir0[1], ih[2] * g.ir0[0] - ih[0] * g.ir0[2],
+              ih[0] * g.ir0[1] - ih[1] * g.ir0[0]}};
+    g.it1 = {{ih[1] * g.ir1[2] - ih[2] * g.ir1[1], ih[2] * g.ir1[0] - ih[0] * g.ir1[2],
+              ih[0] * g.ir1[1] - ih[1] * g.ir1[0]}};
+    const double T0n = std::sqrt(g.it0[0] * g.it0[0] + g.it0[1] * g.it0[1] + g.it0[2] * g.it0[2]);
+    const double T1n = std::sqrt(g.it1[0] * g.it1[0] + g.it1[1] * g.it1[1] + g.it1[2] * g.it1[2]);
+    for (auto j = 0u; j < 3u; ++j) {
+        g.it0[j] /= T0n;
+        g.it1[j] /= T1n;
+    }
+
+    // Transfer angle is larger than 180 degrees as seen from above the z axis
+    // and/or retrograde motion is requested.
+    if ((ih[2] < 0.0) != cw) {
+        g.lambda = -g.lambda;
+        for (auto j = 0u; j < 3u; ++j) {
+            g.it0[j] = -g.it0[j];
+            g.it1[j] = -g.it1[j];
+        }
+    }
+    return g;
+}
+
+// Non dimensional time of flight.
+inline double lambert_T(const lambert_geometry &g, double tof, double mu)
+{
+    return std::sqrt(2.0 * mu / g.s / g.s / g.s) * tof;
+}
+
+// Initial guess for the zero revolution solution.
+inline double lambert_x0_guess(double T, double lambda)
+{
+    const double lambda2 = lambda * lambda;
+    const double lambda3 = lambda * lambda2;
+    const double T00 = std::acos(lambda) + lambda * std::sqrt(1.0 - lambda2);
+    const double T1 = 2.0 / 3.0 * (1.0 - lambda3);
+    if (T >= T00) {
+        return -(T - T00) / (T - T00 + 4);
+    } else if (T <= T1) {
+        return T1 * (T1 - T) / (2.0 / 5.0 * (1 - lambda2 * lambda3) * T) + 1;
+    } else {
+        return std::pow((T / T00), 0.69314718055994529 / std::log(T1 / T00)) - 1.0;
+    }
+}
+
+// Initial guesses for the left and right multiple revolutions solutions with N revolutions.
+inline double lambert_xN_guess(double T, unsigned N, bool right)
+{
+    const double tmp = right ? std::pow((8.0 * T) / (static_cast<double>(N) * kep3::pi), 2.0 / 3.0)
+                             : std::pow((static_cast<double>(N) * kep3::pi + kep3::pi) / (8.0 * T), 2.0 / 3.0);
+    return (tmp - 1) / (tmp + 1);
+}
+
+inline double lambert_hypergeometricF(double z, double tol) // NOLINT
+{
+    double Sj = 1.0;
+    double Cj = 1.0;
+    double err = 1.0;
+    double Cj1 = 0.0;
+    double Sj1 = 0.0;
+    int j = 0;
+    while (err > tol) {
+        Cj1 = Cj * (3.0 + j) * (1.0 + j) / (2.5 + j) * z / (j + 1);
+        Sj1 = Sj + Cj1;
+        err = std::abs(Cj1);
+        Sj = Sj1;
+        Cj = Cj1;
+        j = j + 1;
+    }
+    return Sj;
+}
+
+inline void lambert_dTdx(double &DT, double &DDT, double &DDDT, double x, double T, double lambda)
+{
+    double l2 = lambda * lambda;
+    double l3 = l2 * lambda;
+    double umx2 = 1.0 - x * x;
+    double y = std::sqrt(1.0 - l2 * umx2);
+    double y2 = y * y;
+    double y3 = y2 * y;
+    DT = 1.0 / umx2 * (3.0 * T * x - 2.0 + 2.0 * l3 * x / y);
+    DDT = 1.0 / umx2 * (3.0 * T + 5.0 * x * DT + 2.0 * (1.0 - l2) * l3 / y3);
+    DDDT = 1.0 / umx2 * (7.0 * x * DDT + 8.0 * DT - 6.0 * (1.0 - l2) * l2 * l3 * x / y3 / y2);
+}
+
+inline void lambert_x2tof2(double &tof, double x, unsigned N, double lambda) // NOLINT
+{
+    double a = 1.0 / (1.0 - x * x);
+    if (a > 0) // ellipse
+    {
+        double alfa = 2.0 * std::acos(x);
+        double beta = 2.0 * std::asin(std::sqrt(lambda * lambda / a));
+        if (lambda < 0.0) {
+            beta = -beta;
+        }
+        tof = ((a * std::sqrt(a) * ((alfa - std::sin(alfa)) - (beta - std::sin(beta)) + 2.0 * kep3::pi * N)) / 2.0);
+    } else {
+        double alfa = 2.0 * std::acosh(x);
+        double beta = 2.0 * std::asinh(std::sqrt(-lambda * lambda / a));
+        if (lambda < 0.0) {
+            beta = -beta;
+        }
+        tof = (-a * std::sqrt(-a) * ((beta - std::sinh(beta)) - (alfa - std::sinh(alfa))) / 2.0);
+    }
+}
+
+inline void lambert_x2tof(double &tof, double x, unsigned N, double lambda)
+{
+    double battin = 0.01;
+    double lagrange = 0.2;
+    double dist = std::abs(x - 1);
+    if (dist < lagrange && dist > battin) { // We use Lagrange tof expression
+        instrumentation::record_event(instrumentation::event::x2tof_lagrange);
+        lambert_x2tof2(tof, x, N, lambda);
+        return;
+    }
+    double K = lambda * lambda;
+    double E = x * x - 1.0;
+    double rho = std::abs(E);
+    double z = std::sqrt(1 + K * E);
+    if (dist < battin) { // We use Battin series tof expression
+        instrumentation::record_event(instrumentation::event::x2tof_battin);
+        double eta = z - lambda * x;
+        double S1 = 0.5 * (1.0 - lambda - x * eta);
+        double Q = lambert_hypergeometricF(S1, 1e-11);
+        Q = 4.0 / 3.0 * Q;
+        tof = (eta * eta * eta * Q + 4.0 * lambda * eta) / 2.0 + N * kep3::pi / std::pow(rho, 1.5);
+        return;
+    } else { // We use Lancaster tof expresion
+        instrumentation::record_event(instrumentation::event::x2tof_lancaster);
+        double y = std::sqrt(rho);
+        double g = x * z - lambda * E;
+        double d = 0.0;
+        if (E < 0) {
+            double l = std::acos(g);
+            d = N * kep3::pi + l;
+        } else {
+            double f = y * (z - lambda * x);
+            d = std::log(f + g);
+        }
+        tof = (x - lambda * z - d / y) / E;
+        return;
+    }
+}
+
+inline unsigned lambert_householder(double T, double &x0, unsigned N, // NOLINT
+                                    double eps, unsigned iter_max, double lambda)
+{
+    unsigned it = 0;
+    double err = 1.0;
+    double xnew = 0.0;
+    double tof = 0.0, delta = 0.0, DT = 0.0, DDT = 0.0, DDDT = 0.0;
+    while ((err > eps) && (it < iter_max)) {
+        lambert_x2tof(tof, x0, N, lambda);
+        lambert_dTdx(DT, DDT, DDDT, x0, tof, lambda);
+        delta = tof - T;
+        double DT2 = DT * DT;
+        xnew = x0 - delta * (DT2 - delta * DDT / 2.0) / (DT * (DT2 - delta * DDT) + DDDT * delta * delta / 6.0);
+        err = std::abs(x0 - xnew);
+        x0 = xnew;
+        it++;
+    }
+    instrumentation::record_iters(instrumentation::solver::lambert_householder, it);
+    return it;
+}
+
+// Reconstructs the terminal velocities from a converged x.
+inline void lambert_velocities(const lambert_geometry &g, double mu, double x, std::array<double, 3> &v0,
+                               std::array<double, 3> &v1)
+{
+    const double lambda2 = g.lambda * g.lambda;
+    const double gamma = std::sqrt(mu * g.s / 2.0);
+    const double rho = (g.R0 - g.R1) / g.c;
+    const double sigma = std::sqrt(1 - rho * rho);
+    const double y = std::sqrt(1.0 - lambda2 + lambda2 * x * x);
+    const double vr0 = gamma * ((g.lambda * y - x) - rho * (g.lambda * y + x)) / g.R0;
+    const double vr1 = -gamma * ((g.lambda * y - x) + rho * (g.lambda * y + x)) / g.R1;
+    const double vt = gamma * sigma * (y + g.lambda * x);
+    const double vt0 = vt / g.R0;
+    const double vt1 = vt / g.R1;
+    for (auto j = 0u; j < 3u; ++j) {
+        v0[j] = vr0 * g.ir0[j] + vt0 * g.it0[j];
+        v1[j] = vr1 * g.ir1[j] + vt1 * g.it1[j];
+    }
+}
+
+// Computes the Jacobians of the terminal velocities of lambert_velocities with respect to
+// (r0, r1, tof), writing them as 3x7 row major matrices. T is the non dimensional time of
+// flight and x the converged solution. The dependency of x on the inputs follows from
+// implicit differentiation of T(x, lambda) = T, using dT/dlambda = -2 lambda^2 / y at fixed x,
+// and the remaining quantities are differentiated along each of the 7 input directions.
+// NOLINTNEXTLINE(bugprone-easily-swappable-parameters)
+inline void lambert_velocities_jacobian(const lambert_geometry &g, double T, double tof, double mu, double x,
+                                        std::array<double, 21> &dv0, std::array<double, 21> &dv1)
+{
+    const double lambda = g.lambda, lambda2 = lambda * lambda;
+    const double gamma = std::sqrt(mu * g.s / 2.0);
+    const double rho = (g.R0 - g.R1) / g.c;
+    const double sigma = std::sqrt(1 - rho * rho);
+    const double y = std::sqrt(1.0 - lambda2 + lambda2 * x * x);
+    const double A = lambda * y - x, B = lambda * y + x;
+    const double vr0 = gamma * (A - rho * B) / g.R0;
+    const double vr1 = -gamma * (A + rho * B) / g.R1;
+    const double vt = gamma * sigma * (y + lambda * x);
+    const double vt0 = vt / g.R0;
+    const double vt1 = vt / g.R1;
+
+    // dT/dx at the solution.
+    double T_x = 0., DDT = 0., DDDT = 0.;
+    lambert_dTdx(T_x, DDT, DDDT, x, T, lambda);
+
+    // The transfer angle (it0 and it1 are built from ir0 and ir1, their sign being that of lambda).
+    const double cth = g.ir0[0] * g.ir1[0] + g.ir0[1] * g.ir1[1] + g.ir0[2] * g.ir1[2];
+    const std::array<double, 3> n = {{g.ir0[1] * g.ir1[2] - g.ir0[2] * g.ir1[1],
+                                      g.ir0[2] * g.ir1[0] - g.ir0[0] * g.ir1[2],
+                                      g.ir0[0] * g.ir1[1] - g.ir0[1] * g.ir1[0]}};
+    const double sth = std::sqrt(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+    const double sgn = (lambda < 0.) ? -1. : 1.;
+
+    for (auto k = 0u; k < 7u; ++k) {
+        // The input direction.
+        std::array<double, 3> dr0{}, dr1{};
+        if (k < 3u) {
+            dr0[k] = 1.;
+        } else if (k < 6u) {
+            dr1[k - 3u] = 1.;
+        }
+        const double dtof = (k == 6u) ? 1. : 0.;
+
+        // Geometry.
+        const double dR0 = g.ir0[0] * dr0[0] + g.ir0[1] * dr0[1] + g.ir0[2] * dr0[2];
+        const double dR1 = g.ir1[0] * dr1[0] + g.ir1[1] * dr1[1] + g.ir1[2] * dr1[2];
+        double dc = 0.;
+        for (auto j = 0u; j < 3u; ++j) {
+            dc += (g.R1 * g.ir1[j] - g.R0 * g.ir0[j]) * (dr1[j] - dr0[j]);
+        }
+        dc /= g.c;
+        const double ds = (dc + dR0 + dR1) / 2.0;
+        const double dlambda2 = (g.c * ds - g.s * dc) / (g.s * g.s);
+        const double dlambda = dlambda2 / (2.0 * lambda);
+        const double dT = T * (dtof / tof - 1.5 * ds / g.s);
+
+        // Implicit differentiation of T(x, lambda) = T (dT/dlambda * dlambda = -lambda * dlambda2 / y).
+        const double dx = (dT + lambda * dlambda2 / y) / T_x;
+
+        // Velocity components.
+        const double dy = (dlambda2 * (x * x - 1.0) + 2.0 * lambda2 * x * dx) / (2.0 * y);
+        const double dgamma = gamma * ds / (2.0 * g.s);
+        const double drho = (dR0 - dR1 - rho * dc) / g.c;
+        const double dsigma = -rho * drho / sigma;
+        const double dA = dlambda * y + lambda * dy - dx;
+        const double dB = dlambda * y + lambda * dy + dx;
+        const double dvr0 = (dgamma * (A - rho * B) + gamma * (dA - drho * B - rho * dB)) / g.R0 - vr0 * dR0 / g.R0;
+        const double dvr1 = -(dgamma * (A + rho * B) + gamma * (dA + drho * B + rho * dB)) / g.R1 - vr1 * dR1 / g.R1;
+        const double dvt = (dgamma * sigma + gamma * dsigma) * (y + lambda * x)
+                           + gamma * sigma * (dy + dlambda * x + lambda * dx);
+        const double dvt0 = dvt / g.R0 - vt0 * dR0 / g.R0;
+        const double dvt1 = dvt / g.R1 - vt1 * dR1 / g.R1;
+
+        // Directions: it0 = sgn (ir1 - cth ir0) / sth and it1 = sgn (cth ir1 - ir0) / sth.
+        std::array<double, 3> dir0{}, dir1{};
+        for (auto j = 0u; j < 3u; ++j) {
+            dir0[j] = (dr0[j] - g.ir0[j] * dR0) / g.R0;
+            dir1[j] = (dr1[j] - g.ir1[j] * dR1) / g.R1;
+        }
+        const double dcth = dir0[0] * g.ir1[0] + dir0[1] * g.ir1[1] + dir0[2] * g.ir1[2] + g.ir0[0] * dir1[0]
+                            + g.ir0[1] * dir1[1] + g.ir0[2] * dir1[2];
+        const double dsth = -cth * dcth / sth;
+        for (auto j = 0u; j < 3u; ++j) {
+            const double dit0 = sgn * (dir1[j] - dcth * g.ir0[j] - cth * dir0[j]) / sth - g.it0[j] * dsth / sth;
+            const double dit1 = sgn * (dcth * g.ir1[j] + cth * dir1[j] - dir0[j]) / sth - g.it1[j] * dsth / sth;
+            dv0[7u * j + k] = dvr0 * g.ir0[j] + vr0 * dir0[j] + dvt0 * g.it0[j] + vt0 * dit0;
+            dv1[7u * j + k] = dvr1 * g.ir1[j] + vr1 * dir1[j] + dvt1 * g.it1[j] + vt1 * dit1;
+        }
+    }
+}
+
+// Maximum number of revolutions for which a solution exists, cropped to multi_revs.
+inline unsigned lambert_nmax(double T, double lambda, unsigned multi_revs)
+{
+    const double lambda2 = lambda * lambda;
+    auto Nmax = static_cast<unsigned>(T / kep3::pi);
+    Nmax = std::min(multi_revs, Nmax);
+    const double T00 = std::acos(lambda) + lambda * std::sqrt(1.0 - lambda2);
+    const double T0 = (T00 + Nmax * kep3::pi);
+    double DT = 0.0, DDT = 0.0, DDDT = 0.0;
+    if (Nmax > 0) {
+        if (T < T0) { // We use Halley iterations to find xM and TM
+            int it = 0;
+            double err = 1.0;
+            double T_min = T0;
+            double x_old = 0.0, x_new = 0.0;
+            while (true) {
+                lambert_dTdx(DT, DDT, DDDT, x_old, T_min, lambda);
+                if (DT != 0.0) {
+                    x_new = x_old - DT * DDT / (DDT * DDT - DT * DDDT / 2.0);
+                }
+                err = std::abs(x_old - x_new);
+                if ((err < 1e-13) || (it > 12)) {
+                    break;
+                }
+                lambert_x2tof(T_min, x_new, Nmax, lambda);
+                x_old = x_new;
+                it++;
+            }
+            if (T_min > T) {
+                Nmax -= 1;
+            }
+        }
+    }
+    return Nmax;
+}
+
+// Finds all the 2 * Nmax + 1 solutions (0 revs, 1 left, 1 right, ..., Nmax right) and
+// writes them into the caller-provided x, iters, v0 and v1, which must have at least
+// 2 * Nmax + 1 elements. Nothing is allocated. The first x_guess.size() branches start
+// from x_guess (e.g. the solutions of a neighbouring problem) rather than from the analytic
+// initial guesses, unless the guess is outside the domain of the branch.
+// NOLINTNEXTLINE(bugprone-easily-swappable-parameters)
+inline void lambert_solve_all(const lambert_geometry &g, double T, double mu, unsigned Nmax, std::span<double> x,
+                              std::span<unsigned> iters, std::span<std::array<double, 3>> v0,
+                              std::span<std::array<double, 3>> v1, std::span<const double> x_guess = {})
+{
+    // x_guess[i] is used if finite and within (-1, inf) (0 revs) or (-1, 1) (multi revs).
+    auto warm_start = [x_guess](decltype(x.size()) i, double &xi) {
+        if (i < x_guess.size() && std::isfinite(x_guess[i]) && x_guess[i] > -1. && (i == 0u || x_guess[i] < 1.)) {
+            xi = x_guess[i];
+        }
+    };
+    // 0 rev solution
+    x[0] = lambert_x0_guess(T, g.lambda);
+    warm_start(0u, x[0]);
+    iters[0] = lambert_householder(T, x[0], 0, 1e-5, 15, g.lambda);
+    // multi rev solutions
+    for (decltype(x.size()) i = 1u; i < Nmax + 1u; ++i) {
+        // left Householder iterations
+        x[2 * i - 1] = lambert_xN_guess(T, static_cast<unsigned>(i), false);
+        warm_start(2 * i - 1, x[2 * i - 1]);
+        iters[2 * i - 1] = lambert_householder(T, x[2 * i - 1], static_cast<unsigned>(i), 1e-8, 15, g.lambda);
+        // right Householder iterations
+        x[2 * i] = lambert_xN_guess(T, static_cast<unsigned>(i), true);
+        warm_start(2 * i, x[2 * i]);
+        iters[2 * i] = lambert_householder(T, x[2 * i], static_cast<unsigned>(i), 1e-8, 15, g.lambda);
+    }
+    // terminal velocities
+    for (decltype(x.size()) i = 0u; i < 2u * Nmax + 1u; ++i) {
+        lambert_velocities(g, mu, x[i], v0[i], v1[i]);
+    }
+}
+
+} // namespace kep3::detail
+
+#endif // kep3_DETAIL_LAMBERT_MATH_HPP
@@ -0,0 +1,135 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef kep3_DETAIL_M2E_FIXED_HPP
+#define kep3_DETAIL_M2E_FIXED_HPP
+
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+#include <kep3/detail/simd_dispatch.hpp>
+
+// The solver of Kepler's equation with a fixed number of operations (kep3::kepler_solver::fixed).
+// It is shared by kep3::m2e and by kep3::m2e_batch: the kernel calls no libm function but
+// std::sqrt and has no branches, so that a loop over it can be vectorised.
+namespace kep3::detail
+{
+
+// 2 pi split in three parts, the first two with 26 significant bits, so that k * m2e_twopi_1
+// and k * m2e_twopi_2 are exact for |k| < 2^27 (Cody-Waite reduction).
+constexpr double m2e_twopi_1 = 0x1.921fb5p+2;
+constexpr double m2e_twopi_2 = 0x1.110b46p-24;
+constexpr double m2e_twopi_3 = 0x1.1a62633145c07p-52;
+constexpr double m2e_inv_twopi = 0x1.45f306dc9c883p-3;
+// Mean anomalies larger than this (|k| ~ 2^26) must be reduced to [-pi, pi] before calling
+// m2e_fixed_kernel(), as in kep3::m2e.
+constexpr double m2e_max_reduced_M = 4e8;
+// Adding and subtracting 1.5 * 2^52 rounds to the nearest integer (for |x| < 2^51).
+constexpr double m2e_round_magic = 0x1.8p52;
+// Number of Danby iterations. From Mikkola's starter two are enough to reach machine
+// precision for all eccentricities.
+constexpr unsigned m2e_n_iter = 2u;
+
+// Cephes coefficients of sin and cos in [-pi/4, pi/4].
+constexpr double m2e_sin_c0 = 1.58962301576546568060E-10, m2e_sin_c1 = -2.50507477628578072866E-8,
+                 m2e_sin_c2 = 2.75573136213857245213E-6, m2e_sin_c3 = -1.98412698295895385996E-4,
+                 m2e_sin_c4 = 8.33333333332211858878E-3, m2e_sin_c5 = -1.66666666666666307295E-1;
+constexpr double m2e_cos_c0 = -1.13585365213876817300E-11, m2e_cos_c1 = 2.08757008419747316778E-9,
+                 m2e_cos_c2 = -2.75573141792967388112E-7, m2e_cos_c3 = 2.48015872888517045348E-5,
+                 m2e_cos_c4 = -1.38888888888730564116E-3, m2e_cos_c5 = 4.16666666666665929218E-2;
+
+kep3_SIMD_INLINE double m2e_round_nearest(double x)
+{
+    return (x + m2e_round_magic) - m2e_round_magic;
+}
+
+// sin and cos of x, for |x| up to a few units (reduction to [-pi/4, pi/4] plus quadrant).
+kep3_SIMD_INLINE void m2e_sincos(double x, double &s, double &c)
+{
+    const double j = m2e_round_nearest(x * (4. * m2e_inv_twopi));
+    const double r = ((x - j * (m2e_twopi_1 / 4.)) - j * (m2e_twopi_2 / 4.)) - j * (m2e_twopi_3 / 4.);
+    const double z = r * r;
+    const double sr
+        = r
+          + r * z
+                * (((((m2e_sin_c0 * z + m2e_sin_c1) * z + m2e_sin_c2) * z + m2e_sin_c3) * z + m2e_sin_c4) * z
+                   + m2e_sin_c5);
+    const double cr
+        = 1. - 0.5 * z
+          + z * z
+                * (((((m2e_cos_c0 * z + m2e_cos_c1) * z + m2e_cos_c2) * z + m2e_cos_c3) * z + m2e_cos_c4) * z
+                   + m2e_cos_c5);
+    const auto q = static_cast<std::int32_t>(j) & 3;
+    const double s0 = (q & 1) != 0 ? cr : sr;
+    const double c0 = (q & 1) != 0 ? sr : cr;
+    s = (q & 2) != 0 ? -s0 : s0;
+    c = ((q + 1) & 2) != 0 ? -c0 : c0;
+}
+
+// Cube root of a positive normal x: bit-level first guess (~5 bits) refined by Halley's iterations.
+kep3_SIMD_INLINE double m2e_cbrt(double x)
+{
+    const auto hi = static_cast<std::uint32_t>(std::bit_cast<std::uint64_t>(x) >> 32);
+    double y = std::bit_cast<double>(static_cast<std::uint64_t>(hi / 3u + 0x2a9f7893u) << 32);
+    for (auto i = 0u; i < 3u; ++i) {
+        const double y3 = y * y * y;
+        y = y * (y3 + 2. * x) / (2. * y3 + x);
+    }
+    return y;
+}
+
+// Solves Kepler's equation E - e sinE = M for ecc in [0, 1) and |M| <= m2e_max_reduced_M, returning
+// E in [-pi, pi] (NaN for other eccentricities). M is reduced to [-pi, pi] and the equation is solved
+// for |M| in [0, pi]: Mikkola's cubic approximation (A cubic approximation for Kepler's equation,
+// Celestial Mechanics 40, 1987) is accurate to ~1e-3 for all eccentricities, and the fourth order
+// (Danby) corrections bring it to machine precision.
+kep3_SIMD_INLINE double m2e_fixed_kernel(double M, double ecc)
+{
+    const double k = m2e_round_nearest(M * m2e_inv_twopi);
+    const double Mc = ((M - k * m2e_twopi_1) - k * m2e_twopi_2) - k * m2e_twopi_3;
+    const double Ma = std::abs(Mc);
+
+    // 1 - Mikkola's starter.
+    const double den = 4. * ecc + 0.5;
+    const double alpha = (1. - ecc) / den;
+    const double beta = 0.5 * Ma / den;
+    const double z = m2e_cbrt(beta + std::sqrt(beta * beta + alpha * alpha * alpha));
+    double s = z - alpha / z;
+    s -= 0.078 * s * s * s * s * s / (1. + ecc);
+    double E = Ma + ecc * (3. * s - 4. * s * s * s);
+
+    // 2 - Danby's corrections.
+    for (auto i = 0u; i < m2e_n_iter; ++i) {
+        double sinE = 0., cosE = 0.;
+        m2e_sincos(E, sinE, cosE);
+        const double f2 = ecc * sinE, f3 = ecc * cosE;
+        const double f = E - f2 - Ma, f1 = 1. - f3;
+        const double d1 = -f / f1;
+        const double d2 = -f / (f1 + 0.5 * d1 * f2);
+        const double d3 = -f / (f1 + 0.5 * d2 * f2 + d2 * d2 * f3 / 6.);
+        E += d3;
+    }
+    E = Mc < 0. ? -E : E;
+    return (ecc >= 0. && ecc < 1.) ? E : std::numeric_limits<double>::quiet_NaN();
+}
+
+// As m2e_fixed_kernel(), for any M: beyond m2e_max_reduced_M we fall back to the atan2 of kep3::m2e.
+inline double m2e_fixed(double M, double ecc)
+{
+    if (std::abs(M) > m2e_max_reduced_M) [[unlikely]] {
+        M = std::atan2(std::sin(M), std::cos(M));
+    }
+    return m2e_fixed_kernel(M, ecc);
+}
+
+} // namespace kep3::detail
+
+#endif // kep3_DETAIL_M2E_FIXED_HPP
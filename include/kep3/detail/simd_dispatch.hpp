@@ -0,0 +1,91 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef kep3_DETAIL_SIMD_DISPATCH_HPP
+#define kep3_DETAIL_SIMD_DISPATCH_HPP
+
+#include <cstddef>
+
+// Runtime selection of the instruction set used by the batch kernels. On x86 with GCC/clang
+// a kernel is compiled once per instruction set and the widest variant supported by the
+// running CPU is selected at runtime. Elsewhere the scalar variant is used.
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define kep3_SIMD_X86_DISPATCH
+#endif
+
+// kep3_SIMD_INLINE must mark the functions called by a kernel, so that they are compiled
+// for the instruction set of each variant. kep3_SIMD_LOOP asks for the vectorisation of
+// the loop that follows (active with -fopenmp-simd), kep3_SIMD_LOOP_MAX(var) of a loop
+// computing the maximum var.
+#if defined(__GNUC__) || defined(__clang__)
+#define kep3_SIMD_INLINE [[gnu::always_inline]] inline
+#define kep3_SIMD_PRAGMA(x) _Pragma(#x)
+#define kep3_SIMD_LOOP kep3_SIMD_PRAGMA(omp simd)
+#define kep3_SIMD_LOOP_MAX(var) kep3_SIMD_PRAGMA(omp simd reduction(max : var))
+#else
+#define kep3_SIMD_INLINE inline
+#define kep3_SIMD_LOOP
+#define kep3_SIMD_LOOP_MAX(var)
+#endif
+
+namespace kep3::detail
+{
+
+// Dispatches a batch kernel. Kernel must provide a kep3_SIMD_INLINE static member function
+// template <std::size_t W> void run(Args...), W being the number of lanes of the variant:
+// 1 (scalar), 4 (AVX2) or 8 (AVX-512).
+template <typename Kernel, typename... Args>
+struct simd_dispatch {
+    using kernel_t = void (*)(Args...);
+
+    static void run_scalar(Args... args)
+    {
+        Kernel::template run<1>(args...);
+    }
+
+#if defined(kep3_SIMD_X86_DISPATCH)
+
+    __attribute__((target("avx2,fma"))) static void run_avx2(Args... args)
+    {
+        Kernel::template run<4>(args...);
+    }
+
+    __attribute__((target("avx512f"))) static void run_avx512(Args... args)
+    {
+        Kernel::template run<8>(args...);
+    }
+
+#endif
+
+    // Selects the widest variant supported by the running CPU.
+    static kernel_t select()
+    {
+#if defined(kep3_SIMD_X86_DISPATCH)
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f")) {
+            return &run_avx512;
+        }
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+            return &run_avx2;
+        }
+#endif
+        return &run_scalar;
+    }
+
+    // Runs the kernel, the variant being selected at the first call.
+    static void run(Args... args)
+    {
+        static const kernel_t kernel = select();
+        kernel(args...);
+    }
+};
+
+} // namespace kep3::detail
+
+#endif // kep3_DETAIL_SIMD_DISPATCH_HPP
@@ -0,0 +1,111 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef kep3_INSTRUMENTATION_H
+#define kep3_INSTRUMENTATION_H
+
+#include <array>
+#include <cstddef>
+
+#include <kep3/config.hpp>
+#include <kep3/detail/visibility.hpp>
+
+/// Instrumentation of the iterative solvers
+/**
+ * When kep3 is configured with kep3_ENABLE_INSTRUMENTATION, the iterative solvers record, in thread
+ * local counters, the number of iterations of each call, the branches selected and the number of
+ * failures (throws). A snapshot of the counters summed over all threads can then be taken and the
+ * counters reset. Otherwise, the recording functions are empty and compile to nothing, the
+ * snapshots being all zeros.
+ *
+ * Of the batch functions, only kep3::lambert_solve_batch is instrumented (as kep3::lambert_problem):
+ * the lane kernels of the batch propagators and anomaly conversions record nothing.
+ */
+namespace kep3::instrumentation
+{
+
+// The instrumented solvers.
+enum class solver : unsigned {
+    // kep3::m2e (Newton iterations).
+    m2e,
+    // kep3::n2h (Newton iterations).
+    n2h,
+    // kep3::propagate_lagrangian and kep3::propagate_lagrangian_stm, elliptic case.
+    propagate_lagrangian_elliptic,
+    // kep3::propagate_lagrangian and kep3::propagate_lagrangian_stm, hyperbolic case.
+    propagate_lagrangian_hyperbolic,
+    // kep3::propagate_lagrangian_u (universal variables).
+    propagate_lagrangian_u,
+    // Householder iterations of the Lambert solvers (kep3::lambert_problem, kep3::lambert_solve_branch,
+    // kep3::lambert_solve_batch).
+    lambert_householder
+};
+inline constexpr std::size_t n_solvers = 6u;
+
+// The instrumented events.
+enum class event : unsigned {
+    // Time of flight from x in the Lambert solvers: Battin's series, Lagrange's and Lancaster's expressions.
+    x2tof_battin,
+    x2tof_lagrange,
+    x2tof_lancaster,
+    // A solver threw as the maximum number of iterations was exceeded.
+    m2e_throw,
+    n2h_throw,
+    propagate_lagrangian_throw,
+    propagate_lagrangian_u_throw
+};
+inline constexpr std::size_t n_events = 7u;
+
+// The bins of the iterations histograms: calls taking n_bins - 1 iterations or more
+// are counted in the last bin.
+inline constexpr std::size_t n_bins = 32u;
+
+struct snapshot {
+    // iters[s][k]: number of calls of the solver s which took k iterations.
+    std::array<std::array<unsigned long long, n_bins>, n_solvers> iters{};
+    // events[e]: number of occurrences of the event e.
+    std::array<unsigned long long, n_events> events{};
+};
+
+// Returns true if kep3 was built with the instrumentation.
+kep3_DLL_PUBLIC bool enabled();
+
+// The counters, summed over all threads.
+kep3_DLL_PUBLIC snapshot get_snapshot();
+
+// Resets the counters of all threads. It should not be called while the solvers are running.
+kep3_DLL_PUBLIC void reset();
+
+namespace detail
+{
+
+kep3_DLL_PUBLIC void record_iters_impl(solver, unsigned long long);
+kep3_DLL_PUBLIC void record_event_impl(event);
+
+} // namespace detail
+
+// Records a call of the solver s which took n iterations.
+inline void record_iters([[maybe_unused]] solver s, [[maybe_unused]] unsigned long long n)
+{
+#if defined(kep3_WITH_INSTRUMENTATION)
+    detail::record_iters_impl(s, n);
+#endif
+}
+
+// Records an occurrence of the event e.
+inline void record_event([[maybe_unused]] event e)
+{
+#if defined(kep3_WITH_INSTRUMENTATION)
+    detail::record_event_impl(e);
+#endif
+}
+
+} // namespace kep3::instrumentation
+
+#endif // kep3_INSTRUMENTATION_H
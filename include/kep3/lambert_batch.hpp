@@ -0,0 +1,66 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef kep3_LAMBERT_BATCH_H
+#define kep3_LAMBERT_BATCH_H
+
+#include <array>
+#include <cstdint>
+#include <span>
+
+#include <kep3/detail/visibility.hpp>
+
+namespace kep3
+{
+
+/// Inputs of a batch of Lambert problems
+/**
+ * Structure of arrays: the i-th problem is defined by the i-th entry of each span.
+ * r0 and r1 hold the x, y and z components of the two positions. A non zero cw[i]
+ * selects the retrograde (clockwise) transfer for the i-th problem.
+ */
+struct lambert_batch_input {
+    std::array<std::span<const double>, 3> r0;
+    std::array<std::span<const double>, 3> r1;
+    std::span<const double> tof;
+    std::span<const double> mu;
+    std::span<const std::uint8_t> cw;
+};
+
+/// Outputs of a batch of Lambert problems
+/**
+ * Structure of arrays, caller-provided: the i-th entry of each span receives the
+ * zero revolutions solution of the i-th problem.
+ */
+struct lambert_batch_output {
+    std::array<std::span<double>, 3> v0;
+    std::array<std::span<double>, 3> v1;
+    std::span<double> x;
+    std::span<unsigned> iters;
+};
+
+/// Batch Lambert solver
+/**
+ * Solves many Lambert problems (zero revolutions only) in one call. The numerics are those of
+ * kep3::lambert_problem, but no memory is allocated per problem and the results are written directly
+ * into the caller-provided output spans.
+ *
+ * The problems are solved in groups of 4 (AVX2) or 8 (AVX-512) lanes, the widest kernel supported
+ * by the running CPU being selected at runtime. Elsewhere, a scalar kernel is used. All kernels
+ * return the same solutions as kep3::lambert_problem up to round-off.
+ *
+ * All spans must have the same size. A std::invalid_argument is thrown otherwise. A std::domain_error
+ * is thrown, as in kep3::lambert_problem, if a time of flight or a gravity parameter is not positive,
+ * or if the direction of motion cannot be determined. These checks are done before any output is written.
+ */
+kep3_DLL_PUBLIC void lambert_solve_batch(const lambert_batch_input &in, const lambert_batch_output &out);
+
+} // namespace kep3
+
+#endif // kep3_LAMBERT_BATCH_H
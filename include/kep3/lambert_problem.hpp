@@ -55,7 +55,8 @@ class kep3_DLL_PUBLIC lambert_problem
 public:
     friend kep3_DLL_PUBLIC std::ostream &operator<<(std::ostream &, const lambert_problem &);
     explicit lambert_problem(const std::array<double, 3> &r0  = default_r0, const std::array<double, 3> &r1 = default_r1,
-                             double tof = kep3::pi / 2, double mu = 1., bool cw = false, unsigned multi_revs = 1);
+                             double tof = kep3::pi / 2, double mu = 1., bool cw = false, unsigned multi_revs = 1,
+                             bool jacobians = false, const std::vector<double> &x_guess = {});
     [[nodiscard]] const std::vector<std::array<double, 3>> &get_v0() const;
     [[nodiscard]] const std::vector<std::array<double, 3>> &get_v1() const;
     [[nodiscard]] const std::array<double, 3> &get_r0() const;
@@ -65,16 +66,13 @@ public:
     [[nodiscard]] const std::vector<double> &get_x() const;
     [[nodiscard]] const std::vector<unsigned> &get_iters() const;
     [[nodiscard]] unsigned get_Nmax() const;
+    [[nodiscard]] const std::vector<std::array<double, 21>> &get_v0_jacobian() const;
+    [[nodiscard]] const std::vector<std::array<double, 21>> &get_v1_jacobian() const;
 
 private:
-    unsigned householder(double, double &, unsigned, double, unsigned) const;
-    void dTdx(double &, double &, double &, double, double) const;
-    void x2tof(double &tof, double x0, unsigned N) const;
-    void x2tof2(double &tof, double x0, unsigned N) const;
-    [[nodiscard]] static double hypergeometricF(double z, double tol);
     friend class boost::serialization::access;
     template <class Archive>
-    void serialize(Archive &ar, const unsigned int)
+    void serialize(Archive &ar, const unsigned int version)
     {
         ar & m_r0;
         ar & m_r1;
@@ -91,6 +89,14 @@ private:
         ar & m_Nmax;
         ar & m_has_converged;
         ar & m_multi_revs;
+        // Version 1 added the Jacobians. Older archives are loaded without them.
+        if (version >= 1u) {
+            ar & m_v0_jac;
+            ar & m_v1_jac;
+        } else {
+            m_v0_jac.clear();
+            m_v1_jac.clear();
+        }
     }
 
     std::array<double, 3> m_r0, m_r1;
@@ -104,11 +110,43 @@ private:
     unsigned m_Nmax;
     bool m_has_converged;
     unsigned m_multi_revs;
+    // 3x7 row major Jacobians of v0 and v1 with respect to (r0, r1, tof).
+    std::vector<std::array<double, 21>> m_v0_jac;
+    std::vector<std::array<double, 21>> m_v1_jac;
 };
 
 // Streaming operator for the class kep3::lambert_problem.
 kep3_DLL_PUBLIC std::ostream &operator<<(std::ostream &, const lambert_problem &);
 
+/// Solution of a single branch of a Lambert problem
+struct lambert_branch_solution {
+    std::array<double, 3> v0;
+    std::array<double, 3> v1;
+    double x;
+    unsigned iters;
+};
+
+/// Single branch Lambert solver
+/**
+ * Solves only the branch with N revolutions (left or right) of the Lambert problem defined as in
+ * kep3::lambert_problem, the numerics being the same. For N = 0 the zero revolutions solution is
+ * returned and the branch is ignored.
+ *
+ * When check_existence is true, it is first verified (finding the minimum time of flight of the N
+ * revolutions curve only when needed) that the branch exists, a std::domain_error being thrown
+ * otherwise. When false, this check is skipped: if the branch does not exist the Householder
+ * iterations do not converge, and the returned iters equals their maximum number (15).
+ *
+ * A std::domain_error is also thrown if tof or mu are not positive, or if the direction of motion
+ * cannot be determined.
+ */
+kep3_DLL_PUBLIC lambert_branch_solution lambert_solve_branch(const std::array<double, 3> &r0,
+                                                             const std::array<double, 3> &r1, double tof, double mu,
+                                                             bool cw, unsigned N, bool right = false,
+                                                             bool check_existence = true);
+
 } // namespace kep3
 
+BOOST_CLASS_VERSION(kep3::lambert_problem, 1)
+
 #endif // kep3_LAMBERT_PROBLEM_H
\ No newline at end of file
@@ -0,0 +1,127 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef kep3_LAMBERT_PROBLEM_FIXED_H
+#define kep3_LAMBERT_PROBLEM_FIXED_H
+
+#include <array>
+#include <cstddef>
+#include <span>
+#include <stdexcept>
+
+#include <kep3/core_astro/constants.hpp>
+#include <kep3/detail/lambert_math.hpp>
+
+namespace kep3
+{
+
+/// Lambert Problem (fixed capacity)
+/**
+ * Same as kep3::lambert_problem, but the solutions are stored inline in arrays sized
+ * for at most MaxRevs revolutions, so that constructing and solving a problem never
+ * touches the allocator. This is meant for tight loops (e.g. inside optimizers) where
+ * many Lambert problems are solved and immediately discarded.
+ *
+ * The getters return spans over the 2 * get_Nmax() + 1 solutions actually found,
+ * ordered as in kep3::lambert_problem (0 revs, 1 left, 1 right, ..., N right).
+ *
+ * @tparam MaxRevs the maximum number of revolutions that can be stored.
+ */
+template <unsigned MaxRevs>
+class lambert_problem_fixed
+{
+    static constexpr std::size_t max_solutions = 2u * static_cast<std::size_t>(MaxRevs) + 1u;
+
+public:
+    /// Constructor
+    /** Constructs and solves a Lambert problem.
+     *
+     * \param[in] r0 start cartesian position
+     * \param[in] r1 final cartesian position
+     * \param[in] tof time of flight
+     * \param[in] mu gravity parameter
+     * \param[in] cw when true a retrograde orbit is assumed
+     * \param[in] multi_revs maximum number of multirevolutions to compute (cropped to MaxRevs)
+     */
+    explicit lambert_problem_fixed(const std::array<double, 3> &r0 = {{1.0, 0.0, 0.0}},
+                                   const std::array<double, 3> &r1 = {{0.0, 1.0, 0.0}}, double tof = kep3::pi / 2,
+                                   double mu = 1., bool cw = false, unsigned multi_revs = MaxRevs)
+        : m_r0(r0), m_r1(r1), m_tof(tof), m_mu(mu)
+    {
+        // 0 - Sanity checks
+        if (tof <= 0) {
+            throw std::domain_error("lambert_problem: Time of flight is negative!");
+        }
+        if (mu <= 0) {
+            throw std::domain_error("lambert_problem: Gravity parameter is zero or negative!");
+        }
+        // 1 - Getting lambda and T
+        const auto geo = detail::lambert_make_geometry(r0, r1, cw);
+        const double T = detail::lambert_T(geo, m_tof, m_mu);
+        // 2 - Maximum number of revolutions and solutions
+        m_Nmax = detail::lambert_nmax(T, geo.lambda, multi_revs < MaxRevs ? multi_revs : MaxRevs);
+        detail::lambert_solve_all(geo, T, m_mu, m_Nmax, m_x, m_iters, m_v0, m_v1);
+    }
+
+    [[nodiscard]] std::span<const std::array<double, 3>> get_v0() const
+    {
+        return std::span(m_v0).first(n_solutions());
+    }
+    [[nodiscard]] std::span<const std::array<double, 3>> get_v1() const
+    {
+        return std::span(m_v1).first(n_solutions());
+    }
+    [[nodiscard]] const std::array<double, 3> &get_r0() const
+    {
+        return m_r0;
+    }
+    [[nodiscard]] const std::array<double, 3> &get_r1() const
+    {
+        return m_r1;
+    }
+    [[nodiscard]] double get_tof() const
+    {
+        return m_tof;
+    }
+    [[nodiscard]] double get_mu() const
+    {
+        return m_mu;
+    }
+    [[nodiscard]] std::span<const double> get_x() const
+    {
+        return std::span(m_x).first(n_solutions());
+    }
+    [[nodiscard]] std::span<const unsigned> get_iters() const
+    {
+        return std::span(m_iters).first(n_solutions());
+    }
+    [[nodiscard]] unsigned get_Nmax() const
+    {
+        return m_Nmax;
+    }
+
+private:
+    [[nodiscard]] std::size_t n_solutions() const
+    {
+        return 2u * static_cast<std::size_t>(m_Nmax) + 1u;
+    }
+
+    std::array<double, 3> m_r0, m_r1;
+    double m_tof;
+    double m_mu;
+    std::array<std::array<double, 3>, max_solutions> m_v0{};
+    std::array<std::array<double, 3>, max_solutions> m_v1{};
+    std::array<unsigned, max_solutions> m_iters{};
+    std::array<double, max_solutions> m_x{};
+    unsigned m_Nmax = 0u;
+};
+
+} // namespace kep3
+
+#endif // kep3_LAMBERT_PROBLEM_FIXED_H
@@ -0,0 +1,71 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef kep3_MGA_H
+#define kep3_MGA_H
+
+#include <span>
+#include <vector>
+
+#include <kep3/detail/visibility.hpp>
+#include <kep3/planet.hpp>
+
+namespace kep3
+{
+
+/// The delta-v of a multiple gravity assist (MGA) trajectory
+struct mga_dv {
+    // Total delta-v, the sum of the entries of dvs.
+    double total = 0.;
+    // One entry per planet of the sequence: the departure relative velocity |v0 - v_pl|, the delta-v of
+    // each powered flyby (see kep3::fb_dv()) and the arrival relative velocity |v1 - v_pl|.
+    std::vector<double> dvs;
+};
+
+/// Multiple gravity assist trajectory
+/**
+ * Evaluates the MGA trajectory visiting the planets of seq, each leg being the zero revolutions
+ * Lambert transfer between consecutive planets. The decision vector x is [t0, T1, ..., Tn-1]:
+ * the departure epoch (mjd2000) and the times of flight of the legs (days). The flybys are
+ * powered: their delta-v is kep3::fb_dv() computed with the mu_self and the safe radius of
+ * the planet.
+ *
+ * @param seq the planets, at least two.
+ * @param x the decision vector, with one entry per planet.
+ * @param mu the gravity parameter of the central body.
+ * @param cw when true a retrograde orbit is assumed.
+ *
+ * @return the total delta-v and its breakdown.
+ *
+ * @throws std::invalid_argument if seq has less than two planets or x does not have seq.size() entries.
+ * @throws std::domain_error if mu or a time of flight is not positive, if a flyby planet does not have a
+ * positive mu_self and safe radius, or if a Lambert problem is not defined (see kep3::lambert_problem).
+ */
+kep3_DLL_PUBLIC mga_dv mga(const std::vector<planet> &seq, const std::vector<double> &x, double mu, bool cw = false);
+
+/// Multiple gravity assist trajectories (batch version)
+/**
+ * Evaluates, as kep3::mga() does, N decision vectors stored row-major in xs (N x seq.size()), writing
+ * the total delta-v of the i-th one in dv[i] and its breakdown in the i-th row of dvs (N x seq.size()).
+ *
+ * The ephemerides are computed with one call to planet::eph_into() per planet of the sequence, and the
+ * Lambert problems are then solved leg by leg with kep3::lambert_solve_batch(), in parallel over blocks
+ * of decision vectors. The entries of a decision vector for which a Lambert problem is not defined
+ * (e.g. the direction of motion cannot be determined) are NaN.
+ *
+ * @throws std::invalid_argument if seq has less than two planets or the sizes of the spans are not consistent.
+ * @throws std::domain_error if mu or a time of flight is not positive, or if a flyby planet does not have a
+ * positive mu_self and safe radius.
+ */
+kep3_DLL_PUBLIC void mga_batch(const std::vector<planet> &seq, std::span<const double> xs, double mu, bool cw,
+                               std::span<double> dv, std::span<double> dvs);
+
+} // namespace kep3
+
+#endif // kep3_MGA_H
@@ -10,7 +10,11 @@
 #ifndef kep3_PLANET_H
 #define kep3_PLANET_H
 
+#include <algorithm>
 #include <concepts>
+#include <cstddef>
+#include <span>
+#include <stdexcept>
 #include <string>
 #include <typeinfo>
 
@@ -66,6 +70,13 @@ concept udpla_has_eph_v = requires(const T &p, const std::vector<double> &mjd200
                                   } -> std::same_as<std::vector<double>>;
                           };
 
+template <typename T>
+concept udpla_has_eph_into = requires(const T &p, std::span<const double> mjd2000s, std::span<double> out) {
+                                 {
+                                     p.eph_into(mjd2000s, out)
+                                     } -> std::same_as<void>;
+                             };
+
 template <typename T>
 concept udpla_has_period = requires(const T &p, double mjd2000) {
                                {
@@ -104,6 +115,9 @@ struct planet_iface<void, void> {
 
     [[nodiscard]] virtual std::array<std::array<double, 3>, 2> eph(double) const = 0;
     [[nodiscard]] virtual std::vector<double> eph_v(const std::vector<double> &) const = 0;
+    // Writes the ephemerides at the epochs (mjd2000) into a buffer of 6 values per epoch, as eph_v does,
+    // but into caller provided memory and with a single virtual call for all epochs.
+    virtual void eph_into(std::span<const double>, std::span<double>) const = 0;
     // NOLINTNEXTLINE(google-default-arguments)
     [[nodiscard]] virtual double period(double = 0.) const = 0;
     // NOLINTNEXTLINE(google-default-arguments)
@@ -145,23 +159,31 @@ struct planet_iface<void, void> {
 kep3_DLL_PUBLIC double period_from_energy(const std::array<double, 3> &, const std::array<double, 3> &, double);
 kep3_DLL_PUBLIC std::array<double, 6> elements_from_posvel(const std::array<std::array<double, 3>, 2> &, double,
                                                            kep3::elements_type);
+// Throws std::invalid_argument unless the output of eph_into holds 6 values per epoch.
+kep3_DLL_PUBLIC void check_eph_into_sizes(std::size_t, std::size_t);
+
 template <typename T>
-std::vector<double> default_eph_vectorization(const T *self, const std::vector<double> &mjd2000s)
+void default_eph_into(const T *self, std::span<const double> mjd2000s, std::span<double> out)
 {
     // We simply call a for loop.
-    const auto size = mjd2000s.size();
+    for (decltype(mjd2000s.size()) i = 0u; i < mjd2000s.size(); ++i) {
+        const auto values = self->eph(mjd2000s[i]);
+        out[6 * i] = values[0][0];
+        out[6 * i + 1] = values[0][1];
+        out[6 * i + 2] = values[0][2];
+        out[6 * i + 3] = values[1][0];
+        out[6 * i + 4] = values[1][1];
+        out[6 * i + 5] = values[1][2];
+    }
+}
+
+template <typename T>
+std::vector<double> default_eph_vectorization(const T *self, const std::vector<double> &mjd2000s)
+{
     using size_type = std::vector<double>::size_type;
     std::vector<double> retval;
-    retval.resize(boost::safe_numerics::safe<size_type>(size) * 6);
-    for (decltype(mjd2000s.size()) i = 0u; i < size; ++i) {
-        auto values = self->eph(mjd2000s[i]);
-        retval[6 * i] = values[0][0];
-        retval[6 * i + 1] = values[0][1];
-        retval[6 * i + 2] = values[0][2];
-        retval[6 * i + 3] = values[1][0];
-        retval[6 * i + 4] = values[1][1];
-        retval[6 * i + 5] = values[1][2];
-    }
+    retval.resize(boost::safe_numerics::safe<size_type>(mjd2000s.size()) * 6);
+    default_eph_into(self, mjd2000s, retval);
     return retval;
 }
 
@@ -185,8 +207,34 @@ struct planet_iface<Holder, T> : planet_iface<void, void>, tanuki::iface_impl_he
     {
         if constexpr (udpla_has_eph_v<T>) {
             return this->value().eph_v(mjd2000s);
+        } else if constexpr (udpla_has_eph_into<T>) {
+            using size_type = std::vector<double>::size_type;
+            std::vector<double> retval;
+            retval.resize(boost::safe_numerics::safe<size_type>(mjd2000s.size()) * 6);
+            this->value().eph_into(mjd2000s, retval);
+            return retval;
+        } else {
+            return default_eph_vectorization(&this->value(), mjd2000s);
+        }
+    }
+
+    void eph_into(std::span<const double> mjd2000s, std::span<double> out) const final
+    {
+        check_eph_into_sizes(mjd2000s.size(), out.size());
+        if constexpr (udpla_has_eph_into<T>) {
+            this->value().eph_into(mjd2000s, out);
+        } else if constexpr (udpla_has_eph_v<T>) {
+            // The vectorization provided by the user is preferred to a loop over eph().
+            const auto values = this->value().eph_v(std::vector<double>(mjd2000s.begin(), mjd2000s.end()));
+            if (values.size() != out.size()) {
+                throw std::invalid_argument(
+                    fmt::format("The eph_v method of '{}' returned {} values for {} epochs (6 per epoch expected)",
+                                get_name(), values.size(), mjd2000s.size()));
+            }
+            std::copy(values.begin(), values.end(), out.begin());
         } else {
-            return default_eph_vectorization(this, mjd2000s);
+            // NOTE: the udpla is called directly, without going through the virtual eph().
+            default_eph_into(&this->value(), mjd2000s, out);
         }
     }
 
@@ -265,6 +313,7 @@ struct ref_iface<Wrap, kep3::detail::planet_iface> {
     TANUKI_REF_IFACE_MEMFUN(get_extra_info)
     TANUKI_REF_IFACE_MEMFUN(eph)
     TANUKI_REF_IFACE_MEMFUN(eph_v)
+    TANUKI_REF_IFACE_MEMFUN(eph_into)
     TANUKI_REF_IFACE_MEMFUN(period)
     TANUKI_REF_IFACE_MEMFUN(elements)
 
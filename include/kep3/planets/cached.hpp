@@ -0,0 +1,112 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef kep3_UDPLA_CACHED_H
+#define kep3_UDPLA_CACHED_H
+
+#include <array>
+#include <concepts>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <fmt/ostream.h>
+
+#include <kep3/core_astro/constants.hpp>
+#include <kep3/detail/s11n.hpp>
+#include <kep3/detail/visibility.hpp>
+#include <kep3/planet.hpp>
+
+namespace kep3::udpla
+{
+
+/// Cached planet (interpolated ephemerides)
+/**
+ * This class wraps any kep3::planet and serves its ephemerides from piecewise Chebyshev
+ * interpolants, built upon construction over the interval [mjd2000_start, mjd2000_end].
+ * The interval is bisected until, on each piece, the relative error of the interpolated
+ * position and velocity (measured at the extrema of the Chebyshev polynomial of the
+ * interpolation order) is below tol. This makes repeated queries of expensive planets
+ * (e.g. calling into Python, SPICE or SGP4) cheap, as the wrapped planet is never called
+ * by eph() and eph_v().
+ *
+ * The other optional UDPLA methods are forwarded to the wrapped planet.
+ */
+class kep3_DLL_PUBLIC cached
+{
+    kep3::planet m_planet;
+    double m_start;
+    double m_end;
+    double m_tol;
+    unsigned m_order;
+    // The boundaries of the pieces (one more than the number of pieces).
+    std::vector<double> m_bounds;
+    // The Chebyshev coefficients, piece by piece, of x, y, z, vx, vy, vz.
+    std::vector<double> m_coeffs;
+
+    friend class boost::serialization::access;
+    template <typename Archive>
+    void serialize(Archive &ar, unsigned)
+    {
+        // NOTE: kep3::planet can only be serialized to binary archives.
+        if constexpr (std::same_as<Archive, boost::archive::binary_oarchive>
+                      || std::same_as<Archive, boost::archive::binary_iarchive>) {
+            ar & m_planet;
+        } else {
+            throw std::logic_error("A cached planet can only be serialized to binary archives");
+        }
+        ar & m_start;
+        ar & m_end;
+        ar & m_tol;
+        ar & m_order;
+        ar & m_bounds;
+        ar & m_coeffs;
+    }
+
+public:
+    // Constructors
+    // NOTE: the wrapped planet cannot be the only argument of a constructor, else the
+    // check of copy constructibility of this class in any_udpla would be recursive.
+    cached();
+    explicit cached(kep3::planet pl, double mjd2000_start, double mjd2000_end, double tol = 1e-12,
+                    unsigned order = 12u);
+    // Mandatory UDPLA methods
+    [[nodiscard]] std::array<std::array<double, 3>, 2> eph(double) const;
+
+    // Optional UDPLA methods
+    [[nodiscard]] std::vector<double> eph_v(const std::vector<double> &) const;
+    [[nodiscard]] std::string get_name() const;
+    [[nodiscard]] double get_mu_central_body() const;
+    [[nodiscard]] double get_mu_self() const;
+    [[nodiscard]] double get_radius() const;
+    [[nodiscard]] double get_safe_radius() const;
+    [[nodiscard]] std::string get_extra_info() const;
+    [[nodiscard]] double period(double = 0.) const;
+    [[nodiscard]] std::array<double, 6> elements(double = 0., kep3::elements_type = kep3::elements_type::KEP_F) const;
+
+    // Other methods
+    [[nodiscard]] const kep3::planet &get_planet() const;
+    [[nodiscard]] std::vector<double>::size_type get_n_pieces() const;
+
+private:
+    void interpolate(double, double, unsigned);
+    [[nodiscard]] std::array<std::array<double, 3>, 2> eval(std::vector<double>::size_type, double) const;
+};
+kep3_DLL_PUBLIC std::ostream &operator<<(std::ostream &, const kep3::udpla::cached &);
+} // namespace kep3::udpla
+
+// fmt formatter redirecting to the stream operator
+template <>
+struct fmt::formatter<kep3::udpla::cached> : ostream_formatter {
+};
+
+// necessary for serialization
+TANUKI_S11N_WRAP_EXPORT_KEY(kep3::udpla::cached, kep3::detail::planet_iface)
+
+#endif // kep3_UDPLA_CACHED_H
@@ -11,6 +11,8 @@
 #define kep3_PLANET_JPL_LP_H
 
 #include <array>
+#include <span>
+#include <vector>
 
 #include <fmt/ostream.h>
 
@@ -62,6 +64,8 @@ public:
     [[nodiscard]] std::array<std::array<double, 3>, 2> eph(double) const;
 
     // Optional UDPLA methods
+    [[nodiscard]] std::vector<double> eph_v(const std::vector<double> &) const;
+    void eph_into(std::span<const double>, std::span<double>) const;
     [[nodiscard]] std::string get_name() const;
     [[nodiscard]] double get_mu_central_body() const;
     [[nodiscard]] double get_mu_self() const;
@@ -0,0 +1,97 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef kep3_PLANET_JPL_LP_STATIC_H
+#define kep3_PLANET_JPL_LP_STATIC_H
+
+#include <array>
+#include <ostream>
+#include <span>
+#include <string>
+#include <vector>
+
+#include <fmt/ostream.h>
+
+#include <kep3/core_astro/constants.hpp>
+#include <kep3/detail/s11n.hpp>
+#include <kep3/detail/visibility.hpp>
+#include <kep3/planet.hpp>
+
+namespace kep3::udpla
+{
+
+/// The planets of the JPL low-precision ephemerides
+enum class body : unsigned { mercury = 0, venus, earth, mars, jupiter, saturn, uranus, neptune };
+
+/// Solar System Planet (jpl simplified ephemerides, compile-time body)
+/**
+ * Same as kep3::udpla::jpl_lp, but the body is a template parameter: the elements, their rates
+ * and the unit conversions are compile-time constants that the compiler folds into the
+ * ephemerides evaluation. The class has no data members.
+ *
+ * The ephemerides are those of kep3::udpla::jpl_lp (up to round-off), valid for the timeframe
+ * 1800AD - 2050 AD.
+ */
+template <body B>
+class kep3_DLL_PUBLIC jpl_lp_static
+{
+    friend class boost::serialization::access;
+    template <typename Archive>
+    void serialize(Archive &, unsigned)
+    {
+    }
+
+public:
+    // Mandatory UDPLA methods
+    [[nodiscard]] std::array<std::array<double, 3>, 2> eph(double) const;
+
+    // Optional UDPLA methods
+    [[nodiscard]] std::vector<double> eph_v(const std::vector<double> &) const;
+    void eph_into(std::span<const double>, std::span<double>) const;
+    [[nodiscard]] std::string get_name() const;
+    [[nodiscard]] double get_mu_central_body() const;
+    [[nodiscard]] double get_mu_self() const;
+    [[nodiscard]] double get_radius() const;
+    [[nodiscard]] double get_safe_radius() const;
+    [[nodiscard]] std::string get_extra_info() const;
+    [[nodiscard]] std::array<double, 6> elements(double = 0.,
+                                                 kep3::elements_type = kep3::elements_type::KEP_F) const;
+};
+
+template <body B>
+kep3_DLL_PUBLIC std::ostream &operator<<(std::ostream &, const kep3::udpla::jpl_lp_static<B> &);
+
+// The member functions are defined (and instantiated for all bodies) in jpl_lp_static.cpp.
+extern template class jpl_lp_static<body::mercury>;
+extern template class jpl_lp_static<body::venus>;
+extern template class jpl_lp_static<body::earth>;
+extern template class jpl_lp_static<body::mars>;
+extern template class jpl_lp_static<body::jupiter>;
+extern template class jpl_lp_static<body::saturn>;
+extern template class jpl_lp_static<body::uranus>;
+extern template class jpl_lp_static<body::neptune>;
+
+} // namespace kep3::udpla
+
+// fmt formatter redirecting to the stream operator
+template <kep3::udpla::body B>
+struct fmt::formatter<kep3::udpla::jpl_lp_static<B>> : ostream_formatter {
+};
+
+// necessary for serialization
+TANUKI_S11N_WRAP_EXPORT_KEY(kep3::udpla::jpl_lp_static<kep3::udpla::body::mercury>, kep3::detail::planet_iface)
+TANUKI_S11N_WRAP_EXPORT_KEY(kep3::udpla::jpl_lp_static<kep3::udpla::body::venus>, kep3::detail::planet_iface)
+TANUKI_S11N_WRAP_EXPORT_KEY(kep3::udpla::jpl_lp_static<kep3::udpla::body::earth>, kep3::detail::planet_iface)
+TANUKI_S11N_WRAP_EXPORT_KEY(kep3::udpla::jpl_lp_static<kep3::udpla::body::mars>, kep3::detail::planet_iface)
+TANUKI_S11N_WRAP_EXPORT_KEY(kep3::udpla::jpl_lp_static<kep3::udpla::body::jupiter>, kep3::detail::planet_iface)
+TANUKI_S11N_WRAP_EXPORT_KEY(kep3::udpla::jpl_lp_static<kep3::udpla::body::saturn>, kep3::detail::planet_iface)
+TANUKI_S11N_WRAP_EXPORT_KEY(kep3::udpla::jpl_lp_static<kep3::udpla::body::uranus>, kep3::detail::planet_iface)
+TANUKI_S11N_WRAP_EXPORT_KEY(kep3::udpla::jpl_lp_static<kep3::udpla::body::neptune>, kep3::detail::planet_iface)
+
+#endif // kep3_PLANET_JPL_LP_STATIC_H
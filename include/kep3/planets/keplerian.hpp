@@ -11,7 +11,9 @@
 #define kep3_UDPLA_KEPLERIAN_H
 
 #include <array>
+#include <span>
 #include <utility>
+#include <vector>
 
 #include <fmt/ostream.h>
 
@@ -68,6 +70,8 @@ public:
     [[nodiscard]] std::array<std::array<double, 3>, 2> eph(double) const;
 
     // Optional UDPLA methods
+    [[nodiscard]] std::vector<double> eph_v(const std::vector<double> &) const;
+    void eph_into(std::span<const double>, std::span<double>) const;
     [[nodiscard]] std::string get_name() const;
     [[nodiscard]] double get_mu_central_body() const;
     [[nodiscard]] double get_mu_self() const;
@@ -0,0 +1,60 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#ifndef kep3_PORKCHOP_H
+#define kep3_PORKCHOP_H
+
+#include <cstddef>
+#include <vector>
+
+#include <kep3/detail/visibility.hpp>
+#include <kep3/planet.hpp>
+
+namespace kep3
+{
+
+/// The delta-v matrices of a porkchop plot
+/**
+ * Dense row-major matrices with one row per departure epoch and one column per time of flight.
+ * Cells where the Lambert problem is not defined (e.g. the direction of motion cannot be
+ * determined) contain NaN.
+ */
+struct porkchop_data {
+    // Departure relative velocity magnitude |v0 - v_pl0|.
+    std::vector<double> dv0;
+    // Arrival relative velocity magnitude |v1 - v_pl1|.
+    std::vector<double> dv1;
+    std::size_t n_departures = 0u;
+    std::size_t n_tofs = 0u;
+};
+
+/// Porkchop plot
+/**
+ * Computes the departure and arrival delta-v of the zero revolutions Lambert transfers from pl0 to pl1
+ * over a grid of departure epochs and times of flight. The ephemerides are computed with one call to
+ * planet::eph_v() per grid axis (departures and the flattened arrival epochs), and the Lambert problems
+ * are then solved in parallel, row by row, with kep3::lambert_solve_batch().
+ *
+ * @param pl0 the departure planet.
+ * @param pl1 the arrival planet.
+ * @param t0s the departure epochs (mjd2000).
+ * @param tofs the times of flight (days), all positive.
+ * @param mu the gravity parameter of the central body.
+ * @param cw when true a retrograde orbit is assumed.
+ *
+ * @return the delta-v matrices (rows: departures, columns: times of flight).
+ *
+ * @throws std::domain_error if a time of flight or mu is not positive.
+ */
+kep3_DLL_PUBLIC porkchop_data porkchop(const planet &pl0, const planet &pl1, const std::vector<double> &t0s,
+                                       const std::vector<double> &tofs, double mu, bool cw = false);
+
+} // namespace kep3
+
+#endif // kep3_PORKCHOP_H
@@ -28,6 +28,9 @@ udpla.null_udpla.__module__ = "udpla"
 udpla.jpl_lp = core._jpl_lp
 udpla.jpl_lp.__name__ = "jpl_lp"
 udpla.jpl_lp.__module__ = "udpla"
+udpla.cached = core._cached
+udpla.cached.__name__ = "cached"
+udpla.cached.__module__ = "udpla"
 
 # Importing the python utils
 from .utils import *
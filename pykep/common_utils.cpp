@@ -7,6 +7,7 @@
 // Public License v. 2.0. If a copy of the MPL was not distributed
 // with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
 
+#include <algorithm>
 #include <cassert>
 #include <initializer_list>
 #include <iterator>
@@ -81,6 +82,56 @@ py::object deepcopy(const py::object &o)
     return py::module::import("copy").attr("deepcopy")(o);
 }
 
+// Check that the batch array a has shape (n, cols), or (n,) if cols is zero, raising a ValueError
+// otherwise. n is not checked if negative. Returns the number of rows.
+py::ssize_t check_batch_shape(const batch_array_t &a, py::ssize_t cols, const char *name, py::ssize_t n)
+{
+    const auto expected = (cols == 0) ? std::string("(N,)") : "(N, " + std::to_string(cols) + ")";
+    if (a.ndim() != ((cols == 0) ? 1 : 2) || (cols != 0 && a.shape(1) != cols)) {
+        py_throw(PyExc_ValueError, ("the array '" + std::string(name) + "' must have shape " + expected
+                                    + ", but it has " + std::to_string(a.ndim()) + " dimension(s) and "
+                                    + std::to_string(a.size()) + " element(s)")
+                                       .c_str());
+    }
+    if (n >= 0 && a.shape(0) != n) {
+        py_throw(PyExc_ValueError, ("the array '" + std::string(name) + "' must have " + std::to_string(n)
+                                    + " rows, but it has " + std::to_string(a.shape(0)))
+                                       .c_str());
+    }
+    return a.shape(0);
+}
+
+// Returns the output array of a batch function: a new array of the given shape if out is None, otherwise
+// out itself, which must then be a writeable, C-contiguous float64 array of that shape (a ValueError
+// is raised if not).
+batch_array_t batch_output(const py::object &out, const std::vector<py::ssize_t> &shape, const char *name)
+{
+    if (out.is_none()) {
+        return batch_array_t(shape);
+    }
+    // NOTE: no conversion may happen here, as the results would then be written to a temporary copy.
+    if (!py::isinstance<py::array_t<double, py::array::c_style>>(out)) {
+        py_throw(PyExc_ValueError, ("the output array '" + std::string(name)
+                                    + "' must be a C-contiguous numpy array of float64, but an object of type '"
+                                    + str(type(out)) + "' was provided")
+                                       .c_str());
+    }
+    auto retval = py::reinterpret_borrow<batch_array_t>(out);
+    if (!retval.writeable()) {
+        py_throw(PyExc_ValueError, ("the output array '" + std::string(name) + "' is not writeable").c_str());
+    }
+    if (!std::equal(shape.begin(), shape.end(), retval.shape(), retval.shape() + retval.ndim())) {
+        std::string expected = "(";
+        for (decltype(shape.size()) i = 0u; i < shape.size(); ++i) {
+            expected += std::to_string(shape[i]) + ((i + 1u == shape.size()) ? ")" : ", ");
+        }
+        py_throw(PyExc_ValueError, ("the output array '" + std::string(name) + "' must have shape " + expected
+                                    + ", but it has shape " + str(out.attr("shape")))
+                                       .c_str());
+    }
+    return retval;
+}
+
 // Check if a mandatory method is present in a user-defined entity.
 void check_mandatory_method(const py::object &o, const char *s, const char *target)
 {
@@ -10,8 +10,11 @@
 #ifndef PYKEP_COMMON_UTILS_HPP
 #define PYKEP_COMMON_UTILS_HPP
 
+#include <cstddef>
+#include <span>
 #include <sstream>
 #include <string>
+#include <vector>
 
 #include <kep3/detail/s11n.hpp>
 #include <pybind11/numpy.h>
@@ -46,6 +49,18 @@ py::object type(const py::object &);
 // Perform a deep copy of input object o.
 py::object deepcopy(const py::object &);
 
+// The arrays accepted by the batch functions (e.g. propagate_lagrangian_v()).
+using batch_array_t = py::array_t<double, py::array::c_style | py::array::forcecast>;
+
+// Check that the batch array a has shape (n, cols), or (n,) if cols is zero, raising a ValueError
+// otherwise. n is not checked if negative. Returns the number of rows.
+py::ssize_t check_batch_shape(const batch_array_t &a, py::ssize_t cols, const char *name, py::ssize_t n = -1);
+
+// Returns the output array of a batch function: a new array of the given shape if out is None, otherwise
+// out itself, which must then be a writeable, C-contiguous float64 array of that shape (a ValueError
+// is raised if not). The results are thus written directly into the caller-provided buffer.
+batch_array_t batch_output(const py::object &out, const std::vector<py::ssize_t> &shape, const char *name);
+
 // repr() via ostream.
 template <typename T>
 inline std::string ostream_repr(const T &x)
@@ -111,6 +126,32 @@ static RetType getter_wrapper(const py::object &o, const char *name, const RetTy
     return py::cast<RetType>(a());
 }
 
+// Applies a batch anomaly conversion (e.g. kep3::m2e_batch) to the broadcast of x and ecc,
+// with the GIL released. As with py::vectorize, a float is returned if both are scalars.
+template <void (*F)(std::span<const double>, std::span<const double>, std::span<double>)>
+inline py::object anomaly_batch_wrapper(const py::object &x, const py::object &ecc)
+{
+    using array_t = py::array_t<double, py::array::c_style | py::array::forcecast>;
+    auto np = py::module_::import("numpy");
+    const py::sequence arrays = np.attr("broadcast_arrays")(np.attr("asarray")(x, py::arg("dtype") = "float64"),
+                                                            np.attr("asarray")(ecc, py::arg("dtype") = "float64"));
+    // NOTE: the broadcast views are copied to contiguous arrays.
+    const auto xs = array_t::ensure(arrays[0]);
+    const auto eccs = array_t::ensure(arrays[1]);
+    array_t out(std::vector<py::ssize_t>(xs.shape(), xs.shape() + xs.ndim()));
+    const auto n = static_cast<std::size_t>(xs.size());
+    const double *x_ptr = xs.data(), *ecc_ptr = eccs.data();
+    double *out_ptr = out.mutable_data();
+    {
+        py::gil_scoped_release release;
+        F({x_ptr, n}, {ecc_ptr, n}, {out_ptr, n});
+    }
+    if (xs.ndim() == 0) {
+        return py::float_(*out_ptr);
+    }
+    return out;
+}
+
 // Helpers to implement pickling on top of Boost.Serialization.
 template <typename T>
 inline py::tuple pickle_getstate_wrapper(const T &x)
@@ -6,15 +6,30 @@
 // This Source Code Form is subject to the terms of the Mozilla
 // Public License v. 2.0. If a copy of the MPL was not distributed
 // with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <stdexcept>
 #include <string>
+#include <vector>
 
 #include <fmt/chrono.h>
 #include <kep3/core_astro/constants.hpp>
 #include <kep3/core_astro/convert_anomalies.hpp>
+#include <kep3/core_astro/convert_anomalies_batch.hpp>
+#include <kep3/core_astro/elements_batch.hpp>
+#include <kep3/core_astro/flyby.hpp>
 #include <kep3/core_astro/eq2par2eq.hpp>
 #include <kep3/core_astro/ic2eq2ic.hpp>
 #include <kep3/core_astro/ic2par2ic.hpp>
+#include <kep3/core_astro/propagate_lagrangian_batch.hpp>
+#include <kep3/detail/lambert_batch_buffers.hpp>
 #include <kep3/epoch.hpp>
+#include <kep3/instrumentation.hpp>
+#include <kep3/lambert_batch.hpp>
+#include <kep3/mga.hpp>
 #include <kep3/planet.hpp>
 #include <kep3/planets/keplerian.hpp>
 #include <pybind11/chrono.h>
@@ -29,6 +44,7 @@
 #include "expose_udplas.hpp"
 #include "kep3/core_astro/propagate_lagrangian.hpp"
 #include "kep3/lambert_problem.hpp"
+#include "kep3/porkchop.hpp"
 #include "python_udpla.hpp"
 
 namespace py = pybind11;
@@ -65,10 +81,18 @@ PYBIND11_MODULE(core, m)
         .value("POSVEL", kep3::POSVEL, "Position and Velocity")
         .export_values();
 
+    py::enum_<kep3::kepler_solver>(m, "kepler_solver", "")
+        .value("NEWTON", kep3::kepler_solver::newton, "Newton-Raphson iterations to full precision")
+        .value("FIXED", kep3::kepler_solver::fixed, "Fixed number of high order corrections (no iterations)");
+
     // We expose the various anomaly conversions
-    m.def("m2e", &kep3::m2e, pk::m2e_doc().c_str());
+    m.def(
+        "m2e", [](double M, double ecc, kep3::kepler_solver solver) { return kep3::m2e(M, ecc, solver); },
+        py::arg("M"), py::arg("ecc"), py::arg("solver") = kep3::kepler_solver::newton, pk::m2e_doc().c_str());
     m.def("e2m", &kep3::e2m, pk::e2m_doc().c_str());
-    m.def("m2f", &kep3::m2f, pk::m2f_doc().c_str());
+    m.def(
+        "m2f", [](double M, double ecc, kep3::kepler_solver solver) { return kep3::m2f(M, ecc, solver); },
+        py::arg("M"), py::arg("ecc"), py::arg("solver") = kep3::kepler_solver::newton, pk::m2f_doc().c_str());
     m.def("f2m", &kep3::f2m, pk::f2m_doc().c_str());
     m.def("e2f", &kep3::e2f, pk::e2f_doc().c_str());
     m.def("f2e", &kep3::f2e, pk::f2e_doc().c_str());
@@ -81,29 +105,107 @@ PYBIND11_MODULE(core, m)
     m.def("zeta2f", &kep3::zeta2f, pk::zeta2f_doc().c_str());
     m.def("f2zeta", &kep3::f2zeta, pk::f2zeta_doc().c_str());
 
-    // And their vectorized versions
-    m.def("m2e_v", py::vectorize(kep3::m2e), pk::m2e_v_doc().c_str());
-    m.def("e2m_v", py::vectorize(kep3::e2m), pk::e2m_v_doc().c_str());
-    m.def("m2f_v", py::vectorize(kep3::m2f), pk::m2f_v_doc().c_str());
-    m.def("f2m_v", py::vectorize(kep3::f2m), pk::f2m_v_doc().c_str());
-    m.def("e2f_v", py::vectorize(kep3::e2f), pk::e2f_v_doc().c_str());
-    m.def("f2e_v", py::vectorize(kep3::f2e), pk::f2e_v_doc().c_str());
-    m.def("n2h_v", py::vectorize(kep3::n2h), pk::n2h_v_doc().c_str());
-    m.def("h2n_v", py::vectorize(kep3::h2n), pk::h2n_v_doc().c_str());
-    m.def("n2f_v", py::vectorize(kep3::n2f), pk::n2f_v_doc().c_str());
-    m.def("f2n_v", py::vectorize(kep3::f2n), pk::f2n_v_doc().c_str());
-    m.def("h2f_v", py::vectorize(kep3::h2f), pk::h2f_v_doc().c_str());
-    m.def("f2h_v", py::vectorize(kep3::f2h), pk::f2h_v_doc().c_str());
-    m.def("zeta2f_v", py::vectorize(kep3::zeta2f), pk::zeta2f_v_doc().c_str());
-    m.def("f2zeta_v", py::vectorize(kep3::f2zeta), pk::f2zeta_v_doc().c_str());
+    // And their vectorized versions (batch kernels, the GIL is released)
+    m.def("m2e_v", &pk::anomaly_batch_wrapper<&kep3::m2e_batch>, pk::m2e_v_doc().c_str());
+    m.def("e2m_v", &pk::anomaly_batch_wrapper<&kep3::e2m_batch>, pk::e2m_v_doc().c_str());
+    m.def("m2f_v", &pk::anomaly_batch_wrapper<&kep3::m2f_batch>, pk::m2f_v_doc().c_str());
+    m.def("f2m_v", &pk::anomaly_batch_wrapper<&kep3::f2m_batch>, pk::f2m_v_doc().c_str());
+    m.def("e2f_v", &pk::anomaly_batch_wrapper<&kep3::e2f_batch>, pk::e2f_v_doc().c_str());
+    m.def("f2e_v", &pk::anomaly_batch_wrapper<&kep3::f2e_batch>, pk::f2e_v_doc().c_str());
+    m.def("n2h_v", &pk::anomaly_batch_wrapper<&kep3::n2h_batch>, pk::n2h_v_doc().c_str());
+    m.def("h2n_v", &pk::anomaly_batch_wrapper<&kep3::h2n_batch>, pk::h2n_v_doc().c_str());
+    m.def("n2f_v", &pk::anomaly_batch_wrapper<&kep3::n2f_batch>, pk::n2f_v_doc().c_str());
+    m.def("f2n_v", &pk::anomaly_batch_wrapper<&kep3::f2n_batch>, pk::f2n_v_doc().c_str());
+    m.def("h2f_v", &pk::anomaly_batch_wrapper<&kep3::h2f_batch>, pk::h2f_v_doc().c_str());
+    m.def("f2h_v", &pk::anomaly_batch_wrapper<&kep3::f2h_batch>, pk::f2h_v_doc().c_str());
+    m.def("zeta2f_v", &pk::anomaly_batch_wrapper<&kep3::zeta2f_batch>, pk::zeta2f_v_doc().c_str());
+    m.def("f2zeta_v", &pk::anomaly_batch_wrapper<&kep3::f2zeta_batch>, pk::f2zeta_v_doc().c_str());
 
     // Eposing element conversions
-    m.def("ic2par", &kep3::ic2par);
-    m.def("par2ic", &kep3::par2ic);
-    m.def("ic2eq", &kep3::ic2eq);
-    m.def("eq2ic", &kep3::eq2ic);
-    m.def("par2eq", &kep3::par2eq);
-    m.def("eq2par", &kep3::eq2par);
+    m.def("ic2par", &kep3::ic2par, py::call_guard<py::gil_scoped_release>());
+    m.def("par2ic", &kep3::par2ic, py::call_guard<py::gil_scoped_release>());
+    m.def("ic2eq", &kep3::ic2eq, py::call_guard<py::gil_scoped_release>());
+    m.def("eq2ic", &kep3::eq2ic, py::call_guard<py::gil_scoped_release>());
+    m.def("par2eq", &kep3::par2eq, py::call_guard<py::gil_scoped_release>());
+    m.def("eq2par", &kep3::eq2par, py::call_guard<py::gil_scoped_release>());
+
+    // Batch conversions on (N, 6) arrays. The rows are transposed into a structure of arrays, converted
+    // in place by the kep3 batch function and transposed back into the output.
+    auto elements_v = [](const pykep::batch_array_t &in, const py::object &out, const char *name,
+                         const auto &convert) {
+        const auto n = pykep::check_batch_shape(in, 6, name);
+        auto retval = pykep::batch_output(out, {n, 6}, "out");
+        const double *in_ptr = in.data();
+        double *out_ptr = retval.mutable_data();
+        {
+            const py::gil_scoped_release release;
+            const auto N = static_cast<std::size_t>(n);
+            std::vector<double> soa(6u * N);
+            kep3::elements_batch_input soa_in;
+            kep3::elements_batch_output soa_out;
+            for (std::size_t j = 0u; j < 6u; ++j) {
+                for (std::size_t i = 0u; i < N; ++i) {
+                    soa[j * N + i] = in_ptr[6u * i + j];
+                }
+                soa_in[j] = {soa.data() + j * N, N};
+                soa_out[j] = {soa.data() + j * N, N};
+            }
+            convert(soa_in, soa_out);
+            for (std::size_t i = 0u; i < N; ++i) {
+                for (std::size_t j = 0u; j < 6u; ++j) {
+                    out_ptr[6u * i + j] = soa[j * N + i];
+                }
+            }
+        }
+        return retval;
+    };
+    m.def(
+        "ic2par_v",
+        [elements_v](const pykep::batch_array_t &rvs, double mu, const py::object &out) {
+            return elements_v(rvs, out, "rvs", [mu](const auto &in, const auto &o) { kep3::ic2par_batch(in, mu, o); });
+        },
+        py::arg("rvs"), py::arg("mu") = 1., py::arg("out") = py::none(), pykep::ic2par_v_docstring().c_str());
+    m.def(
+        "par2ic_v",
+        [elements_v](const pykep::batch_array_t &pars, double mu, const py::object &out) {
+            return elements_v(pars, out, "pars",
+                              [mu](const auto &in, const auto &o) { kep3::par2ic_batch(in, mu, o); });
+        },
+        py::arg("pars"), py::arg("mu") = 1., py::arg("out") = py::none(), pykep::par2ic_v_docstring().c_str());
+    m.def(
+        "ic2eq_v",
+        [elements_v](const pykep::batch_array_t &rvs, double mu, bool retrogade, const py::object &out) {
+            return elements_v(rvs, out, "rvs", [mu, retrogade](const auto &in, const auto &o) {
+                kep3::ic2eq_batch(in, mu, retrogade, o);
+            });
+        },
+        py::arg("rvs"), py::arg("mu") = 1., py::arg("retrogade") = false, py::arg("out") = py::none(),
+        pykep::ic2eq_v_docstring().c_str());
+    m.def(
+        "eq2ic_v",
+        [elements_v](const pykep::batch_array_t &eqs, double mu, bool retrogade, const py::object &out) {
+            return elements_v(eqs, out, "eqs", [mu, retrogade](const auto &in, const auto &o) {
+                kep3::eq2ic_batch(in, mu, retrogade, o);
+            });
+        },
+        py::arg("eqs"), py::arg("mu") = 1., py::arg("retrogade") = false, py::arg("out") = py::none(),
+        pykep::eq2ic_v_docstring().c_str());
+    m.def(
+        "par2eq_v",
+        [elements_v](const pykep::batch_array_t &pars, bool retrogade, const py::object &out) {
+            return elements_v(pars, out, "pars",
+                              [retrogade](const auto &in, const auto &o) { kep3::par2eq_batch(in, retrogade, o); });
+        },
+        py::arg("pars"), py::arg("retrogade") = false, py::arg("out") = py::none(),
+        pykep::par2eq_v_docstring().c_str());
+    m.def(
+        "eq2par_v",
+        [elements_v](const pykep::batch_array_t &eqs, bool retrogade, const py::object &out) {
+            return elements_v(eqs, out, "eqs",
+                              [retrogade](const auto &in, const auto &o) { kep3::eq2par_batch(in, retrogade, o); });
+        },
+        py::arg("eqs"), py::arg("retrogade") = false, py::arg("out") = py::none(),
+        pykep::eq2par_v_docstring().c_str());
 
     // Class epoch
     py::class_<kep3::epoch> epoch_class(m, "epoch", "Represents a specific point in time.");
@@ -194,31 +296,24 @@ PYBIND11_MODULE(core, m)
         [](const kep3::planet &pl, const std::variant<double, kep3::epoch> &when) {
             return std::visit([&](const auto &v) { return pl.eph(v); }, when);
         },
-        py::arg("when"), pykep::planet_eph_docstring().c_str());
+        py::arg("when"), py::call_guard<py::gil_scoped_release>(), pykep::planet_eph_docstring().c_str());
     // Vectorized version. Note that the udpla method flattens everything but planet returns a non flat array.
     planet_class.def(
         "eph_v",
-        [](const kep3::planet &pl, const std::vector<double> &eps) {
-            std::vector<double> res = pl.eph_v(eps);
-            // We create a capsule for the py::array_t to manage ownership change.
-            auto vec_ptr = std::make_unique<std::vector<double>>(std::move(res));
-
-            py::capsule vec_caps(vec_ptr.get(), [](void *ptr) {
-                std::unique_ptr<std::vector<double>> vptr(static_cast<std::vector<double> *>(ptr));
-            });
-
-            // NOTE: at this point, the capsule has been created successfully (including
-            // the registration of the destructor). We can thus release ownership from vec_ptr,
-            // as now the capsule is responsible for destroying its contents. If the capsule constructor
-            // throws, the destructor function is not registered/invoked, and the destructor
-            // of vec_ptr will take care of cleaning up.
-            auto *ptr = vec_ptr.release();
-
-            return py::array_t<double>(py::array::ShapeContainer{boost::numeric_cast<py::ssize_t>(eps.size()),
-                                                                 static_cast<py::ssize_t>(6)}, // shape
-                                       ptr->data(), std::move(vec_caps));
+        [](const kep3::planet &pl, const pykep::batch_array_t &eps, const py::object &out) {
+            const auto n = pykep::check_batch_shape(eps, 0, "when");
+            auto retval = pykep::batch_output(out, {n, 6}, "out");
+            const auto N = static_cast<std::size_t>(n);
+            const double *eps_ptr = eps.data();
+            double *out_ptr = retval.mutable_data();
+            {
+                const py::gil_scoped_release release;
+                // A single call through the type-erased interface, writing directly into the array.
+                pl.eph_into(std::span<const double>(eps_ptr, N), std::span<double>(out_ptr, 6u * N));
+            }
+            return retval;
         },
-        py::arg("when"), pykep::planet_eph_v_docstring().c_str());
+        py::arg("when"), py::arg("out") = py::none(), pykep::planet_eph_v_docstring().c_str());
 
 #define PYKEP3_EXPOSE_PLANET_GETTER(name)                                                                              \
     planet_class.def(                                                                                                  \
@@ -239,7 +334,7 @@ PYBIND11_MODULE(core, m)
         [](const kep3::planet &pl, const std::variant<double, kep3::epoch> &when) {
             return std::visit([&](const auto &v) { return pl.period(v); }, when);
         },
-        py::arg("when") = 0., pykep::planet_period_docstring().c_str());
+        py::arg("when") = 0., py::call_guard<py::gil_scoped_release>(), pykep::planet_period_docstring().c_str());
 
     planet_class.def(
         "elements",
@@ -247,7 +342,7 @@ PYBIND11_MODULE(core, m)
             return std::visit([&](const auto &v) { return pl.elements(v, el_ty); }, when);
         },
         py::arg("when") = 0., py::arg("el_type") = kep3::elements_type::KEP_F,
-        pykep::planet_elements_docstring().c_str());
+        py::call_guard<py::gil_scoped_release>(), pykep::planet_elements_docstring().c_str());
 
     // We now expose the cpp udplas. They will also add a constructor and the extract machinery to the planet_class
     // UDPLA module
@@ -257,11 +352,34 @@ PYBIND11_MODULE(core, m)
     planet_class.def(py::init([](const py::object &o) { return kep3::planet{pk::python_udpla(o)}; }), py::arg("udpla"));
 
     // Exposing the Lambert problem class
+    // The Jacobians of the terminal velocities are returned as arrays of shape (n_solutions, 3, 7).
+    auto lambert_jacobians = [](const std::vector<std::array<double, 21>> &jacs) {
+        py::array_t<double> retval(py::array::ShapeContainer{static_cast<py::ssize_t>(jacs.size()), 3, 7});
+        auto *data = retval.mutable_data();
+        for (const auto &jac : jacs) {
+            data = std::copy(jac.begin(), jac.end(), data);
+        }
+        return retval;
+    };
+    // The terminal velocities are also exposed as read-only views of shape (n_solutions, 3) on the vectors
+    // of the lambert_problem, which the views keep alive.
+    auto lambert_velocities = [](const py::object &self, const std::vector<std::array<double, 3>> &vs) {
+        static_assert(sizeof(std::array<double, 3>) == 3u * sizeof(double));
+        py::array_t<double> retval(py::array::ShapeContainer{static_cast<py::ssize_t>(vs.size()), 3},
+                                   reinterpret_cast<const double *>(vs.data()), self);
+        retval.attr("setflags")(py::arg("write") = false);
+        return retval;
+    };
     py::class_<kep3::lambert_problem> lambert_problem(m, "lambert_problem", pykep::lambert_problem_docstring().c_str());
     lambert_problem
-        .def(py::init<const std::array<double, 3> &, const std::array<double, 3> &, double, double, bool, unsigned>(),
+        .def(py::init([](const std::array<double, 3> &r0, const std::array<double, 3> &r1, double tof, double mu,
+                         bool cw, unsigned multi_revs, bool jacobians, const std::vector<double> &x_guess) {
+                 const py::gil_scoped_release release;
+                 return kep3::lambert_problem(r0, r1, tof, mu, cw, multi_revs, jacobians, x_guess);
+             }),
              py::arg("r0") = std::array<double, 3>{{1., 0., 0}}, py::arg("r1") = std::array<double, 3>{{0., 1., 0}},
-             py::arg("tof") = kep3::pi / 2, py::arg("mu") = 1., py::arg("cw") = false, py::arg("multi_revs") = 1)
+             py::arg("tof") = kep3::pi / 2, py::arg("mu") = 1., py::arg("cw") = false, py::arg("multi_revs") = 1,
+             py::arg("jacobians") = false, py::arg("x_guess") = std::vector<double>{})
         // repr().
         .def("__repr__", &pykep::ostream_repr<kep3::lambert_problem>)
         // Copy and deepcopy.
@@ -280,16 +398,286 @@ PYBIND11_MODULE(core, m)
         .def_property_readonly("x", &kep3::lambert_problem::get_x,
                                "The Battin variable x along the time of flight curves.")
         .def_property_readonly("iters", &kep3::lambert_problem::get_iters, "The number of iterations made.")
-        .def_property_readonly("Nmax", &kep3::lambert_problem::get_Nmax, "The maximum number of iterations allowed.");
+        .def_property_readonly("Nmax", &kep3::lambert_problem::get_Nmax, "The maximum number of iterations allowed.")
+        .def_property_readonly(
+            "v0_array",
+            [lambert_velocities](const py::object &self) {
+                return lambert_velocities(self, self.cast<const kep3::lambert_problem &>().get_v0());
+            },
+            pykep::lambert_problem_v0_array_docstring().c_str())
+        .def_property_readonly(
+            "v1_array",
+            [lambert_velocities](const py::object &self) {
+                return lambert_velocities(self, self.cast<const kep3::lambert_problem &>().get_v1());
+            },
+            pykep::lambert_problem_v1_array_docstring().c_str())
+        .def_property_readonly(
+            "v0_jacobian",
+            [lambert_jacobians](const kep3::lambert_problem &lp) { return lambert_jacobians(lp.get_v0_jacobian()); },
+            pykep::lambert_problem_v0_jacobian_docstring().c_str())
+        .def_property_readonly(
+            "v1_jacobian",
+            [lambert_jacobians](const kep3::lambert_problem &lp) { return lambert_jacobians(lp.get_v1_jacobian()); },
+            pykep::lambert_problem_v1_jacobian_docstring().c_str());
+
+    // Exposing the single branch Lambert solver.
+    m.def(
+        "lambert_solve_branch",
+        [](const std::array<double, 3> &r0, const std::array<double, 3> &r1, double tof, double mu, bool cw,
+           unsigned N, bool right, bool check_existence) {
+            kep3::lambert_branch_solution sol{};
+            {
+                const py::gil_scoped_release release;
+                sol = kep3::lambert_solve_branch(r0, r1, tof, mu, cw, N, right, check_existence);
+            }
+            return py::make_tuple(sol.v0, sol.v1, sol.x, sol.iters);
+        },
+        py::arg("r0"), py::arg("r1"), py::arg("tof"), py::arg("mu") = 1., py::arg("cw") = false, py::arg("N") = 0u,
+        py::arg("right") = false, py::arg("check_existence") = true, pykep::lambert_solve_branch_docstring().c_str());
+
+    // Exposing the solvers instrumentation.
+    m.def("instrumentation_enabled", &kep3::instrumentation::enabled,
+          pykep::instrumentation_enabled_docstring().c_str());
+    m.def(
+        "instrumentation_snapshot",
+        []() {
+            namespace ki = kep3::instrumentation;
+            const std::array<const char *, ki::n_solvers> solvers
+                = {"m2e", "n2h", "propagate_lagrangian_elliptic", "propagate_lagrangian_hyperbolic",
+                   "propagate_lagrangian_u", "lambert_householder"};
+            const std::array<const char *, ki::n_events> events
+                = {"x2tof_battin", "x2tof_lagrange", "x2tof_lancaster", "m2e_throw", "n2h_throw",
+                   "propagate_lagrangian_throw", "propagate_lagrangian_u_throw"};
+            const auto snap = ki::get_snapshot();
+            py::dict iters, evs;
+            for (decltype(solvers.size()) i = 0u; i < solvers.size(); ++i) {
+                py::array_t<unsigned long long> h(static_cast<py::ssize_t>(ki::n_bins));
+                std::copy(snap.iters[i].begin(), snap.iters[i].end(), h.mutable_data());
+                iters[solvers[i]] = h;
+            }
+            for (decltype(events.size()) i = 0u; i < events.size(); ++i) {
+                evs[events[i]] = snap.events[i];
+            }
+            py::dict retval;
+            retval["iters"] = iters;
+            retval["events"] = evs;
+            return retval;
+        },
+        pykep::instrumentation_snapshot_docstring().c_str());
+    m.def("instrumentation_reset", &kep3::instrumentation::reset, pykep::instrumentation_reset_docstring().c_str());
+
+    // Exposing the porkchop engine.
+    m.def(
+        "porkchop",
+        [](const kep3::planet &pl0, const kep3::planet &pl1, const std::vector<double> &t0s,
+           const std::vector<double> &tofs, double mu, bool cw) {
+            std::unique_ptr<kep3::porkchop_data> data_ptr;
+            {
+                const py::gil_scoped_release release;
+                data_ptr = std::make_unique<kep3::porkchop_data>(kep3::porkchop(pl0, pl1, t0s, tofs, mu, cw));
+            }
+
+            // Both arrays are views on the vectors of data_ptr: a single capsule owns them.
+            py::capsule data_caps(data_ptr.get(), [](void *ptr) {
+                std::unique_ptr<kep3::porkchop_data> dptr(static_cast<kep3::porkchop_data *>(ptr));
+            });
+            // NOTE: at this point, the capsule has been created successfully (including
+            // the registration of the destructor). We can thus release ownership from data_ptr,
+            // as now the capsule is responsible for destroying its contents. If the capsule constructor
+            // throws, the destructor function is not registered/invoked, and the destructor
+            // of data_ptr will take care of cleaning up.
+            auto *ptr = data_ptr.release();
+
+            const py::array::ShapeContainer shape{boost::numeric_cast<py::ssize_t>(ptr->n_departures),
+                                                  boost::numeric_cast<py::ssize_t>(ptr->n_tofs)};
+            return py::make_tuple(py::array_t<double>(shape, ptr->dv0.data(), data_caps),
+                                  py::array_t<double>(shape, ptr->dv1.data(), data_caps));
+        },
+        py::arg("pl0"), py::arg("pl1"), py::arg("t0s"), py::arg("tofs"), py::arg("mu") = kep3::MU_SUN,
+        py::arg("cw") = false, pykep::porkchop_docstring().c_str());
+
+    // Exposing the MGA evaluators.
+    m.def(
+        "fb_dv",
+        [](const std::array<double, 3> &v_rel_in, const std::array<double, 3> &v_rel_out, double mu, double rp) {
+            return kep3::fb_dv(v_rel_in, v_rel_out, mu, rp);
+        },
+        py::arg("v_rel_in"), py::arg("v_rel_out"), py::arg("mu"), py::arg("rp"), pykep::fb_dv_docstring().c_str());
+    m.def(
+        "mga",
+        [](const std::vector<kep3::planet> &seq, const std::vector<double> &x, double mu, bool cw) {
+            kep3::mga_dv res;
+            {
+                const py::gil_scoped_release release;
+                res = kep3::mga(seq, x, mu, cw);
+            }
+            return py::make_tuple(res.total, res.dvs);
+        },
+        py::arg("seq"), py::arg("x"), py::arg("mu") = kep3::MU_SUN, py::arg("cw") = false,
+        pykep::mga_docstring().c_str());
+    m.def(
+        "mga_v",
+        [](const std::vector<kep3::planet> &seq, const pykep::batch_array_t &xs, double mu, bool cw,
+           const py::object &dv_out, const py::object &dvs_out) {
+            const auto n_pl = boost::numeric_cast<py::ssize_t>(seq.size());
+            const auto n = pykep::check_batch_shape(xs, n_pl, "xs");
+            auto dv = pykep::batch_output(dv_out, {n}, "dv_out");
+            auto dvs = pykep::batch_output(dvs_out, {n, n_pl}, "dvs_out");
+            const auto N = static_cast<std::size_t>(n);
+            const double *xs_ptr = xs.data();
+            double *dv_ptr = dv.mutable_data(), *dvs_ptr = dvs.mutable_data();
+            {
+                const py::gil_scoped_release release;
+                // The delta-vs are written directly into the arrays.
+                kep3::mga_batch(seq, {xs_ptr, N * seq.size()}, mu, cw, {dv_ptr, N}, {dvs_ptr, N * seq.size()});
+            }
+            return py::make_tuple(dv, dvs);
+        },
+        py::arg("seq"), py::arg("xs"), py::arg("mu") = kep3::MU_SUN, py::arg("cw") = false,
+        py::arg("dv_out") = py::none(), py::arg("dvs_out") = py::none(), pykep::mga_v_docstring().c_str());
 
     // Exposing propagators
     m.def(
         "propagate_lagrangian",
-        [](const std::array<std::array<double, 3>, 2> &pos_vel, double dt, double mu) {
+        [](const std::array<std::array<double, 3>, 2> &pos_vel, double dt, double mu, bool stm) -> py::object {
             auto retval = pos_vel;
-            kep3::propagate_lagrangian(retval, dt, mu);
-            return retval;
+            if (stm) {
+                std::array<double, 36> stm_data{};
+                {
+                    const py::gil_scoped_release release;
+                    stm_data = kep3::propagate_lagrangian_stm(retval, dt, mu);
+                }
+                py::array_t<double> stm_arr(py::array::ShapeContainer{6, 6});
+                std::copy(stm_data.begin(), stm_data.end(), stm_arr.mutable_data());
+                return py::make_tuple(retval, stm_arr);
+            }
+            {
+                const py::gil_scoped_release release;
+                kep3::propagate_lagrangian(retval, dt, mu);
+            }
+            return py::cast(retval);
         },
         py::arg("rv") = std::array<std::array<double, 3>, 2>{{{1, 0, 0}, {0, 1, 0}}}, py::arg("dt") = kep3::pi / 2,
-        py::arg("mu") = 1, pykep::propagate_lagrangian_docstring().c_str());
+        py::arg("mu") = 1, py::arg("stm") = false, pykep::propagate_lagrangian_docstring().c_str());
+
+    // The times of flight of the batch functions: either one per row or a scalar, broadcast to all rows.
+    auto batch_times = [](const pykep::batch_array_t &ts, py::ssize_t n, const char *name) {
+        if (ts.ndim() != 0) {
+            pykep::check_batch_shape(ts, 0, name, n);
+        }
+        return [ptr = ts.data(), scalar = ts.ndim() == 0](std::size_t i) { return scalar ? ptr[0] : ptr[i]; };
+    };
+
+    // Exposing the batch propagators.
+    m.def(
+        "propagate_lagrangian_v",
+        [batch_times](const pykep::batch_array_t &rvs, const pykep::batch_array_t &dts, double mu, bool stm,
+                      const py::object &out, const py::object &stm_out) -> py::object {
+            const auto n = pykep::check_batch_shape(rvs, 6, "rvs");
+            const auto dt_at = batch_times(dts, n, "dts");
+            auto retval = pykep::batch_output(out, {n, 6}, "out");
+            auto stms = stm ? pykep::batch_output(stm_out, {n, 6, 6}, "stm_out") : pykep::batch_array_t(0);
+            const double *in_ptr = rvs.data();
+            double *out_ptr = retval.mutable_data(), *stms_ptr = stms.mutable_data();
+            {
+                const py::gil_scoped_release release;
+                const auto N = static_cast<std::size_t>(n);
+                // The batch propagators work on structures of arrays.
+                std::vector<double> soa(6u * N), dt(N);
+                for (std::size_t i = 0u; i < N; ++i) {
+                    for (std::size_t j = 0u; j < 6u; ++j) {
+                        soa[j * N + i] = in_ptr[6u * i + j];
+                    }
+                    dt[i] = dt_at(i);
+                }
+                const kep3::pos_vel_batch pos_vel{{{{soa.data(), N}, {soa.data() + N, N}, {soa.data() + 2u * N, N}}},
+                                                  {{{soa.data() + 3u * N, N},
+                                                    {soa.data() + 4u * N, N},
+                                                    {soa.data() + 5u * N, N}}}};
+                if (stm) {
+                    kep3::propagate_lagrangian_stm_batch(pos_vel, dt, mu, {stms_ptr, 36u * N});
+                } else {
+                    kep3::propagate_lagrangian_batch(pos_vel, dt, mu);
+                }
+                for (std::size_t i = 0u; i < N; ++i) {
+                    for (std::size_t j = 0u; j < 6u; ++j) {
+                        out_ptr[6u * i + j] = soa[j * N + i];
+                    }
+                }
+            }
+            if (stm) {
+                return py::make_tuple(retval, stms);
+            }
+            return retval;
+        },
+        py::arg("rvs"), py::arg("dts"), py::arg("mu") = 1., py::arg("stm") = false, py::arg("out") = py::none(),
+        py::arg("stm_out") = py::none(), pykep::propagate_lagrangian_v_docstring().c_str());
+
+    // Exposing the propagation of one state to many times.
+    m.def(
+        "propagate_lagrangian_grid",
+        [](const std::array<std::array<double, 3>, 2> &pos_vel, const pykep::batch_array_t &dts, double mu,
+           const py::object &out) {
+            const auto n = pykep::check_batch_shape(dts, 0, "dts");
+            auto retval = pykep::batch_output(out, {n, 6}, "out");
+            const auto N = static_cast<std::size_t>(n);
+            const double *dts_ptr = dts.data();
+            double *out_ptr = retval.mutable_data();
+            {
+                const py::gil_scoped_release release;
+                // The states are written directly into the array.
+                kep3::propagate_lagrangian_grid(pos_vel, {dts_ptr, N}, mu, {out_ptr, 6u * N});
+            }
+            return retval;
+        },
+        py::arg("rv") = std::array<std::array<double, 3>, 2>{{{1, 0, 0}, {0, 1, 0}}}, py::arg("dts"),
+        py::arg("mu") = 1., py::arg("out") = py::none(), pykep::propagate_lagrangian_grid_docstring().c_str());
+
+    // Exposing the batch Lambert solver.
+    m.def(
+        "lambert_solve_v",
+        [batch_times](const pykep::batch_array_t &r0s, const pykep::batch_array_t &r1s,
+                      const pykep::batch_array_t &tofs, double mu, bool cw, const py::object &v0s_out,
+                      const py::object &v1s_out) {
+            const auto n = pykep::check_batch_shape(r0s, 3, "r0s");
+            pykep::check_batch_shape(r1s, 3, "r1s", n);
+            const auto tof_at = batch_times(tofs, n, "tofs");
+            auto v0s = pykep::batch_output(v0s_out, {n, 3}, "v0s_out");
+            auto v1s = pykep::batch_output(v1s_out, {n, 3}, "v1s_out");
+            const double *r0_ptr = r0s.data(), *r1_ptr = r1s.data();
+            double *v0_ptr = v0s.mutable_data(), *v1_ptr = v1s.mutable_data();
+            {
+                const py::gil_scoped_release release;
+                const auto N = static_cast<std::size_t>(n);
+                if (mu <= 0) {
+                    throw std::domain_error("lambert_solve_v: Gravity parameter is zero or negative!");
+                }
+                // The rows are transposed to a structure of arrays and back.
+                kep3::detail::lambert_batch_buffers buf(N);
+                for (std::size_t i = 0u; i < N; ++i) {
+                    for (std::size_t j = 0u; j < 3u; ++j) {
+                        buf.r0[j][i] = r0_ptr[3u * i + j];
+                        buf.r1[j][i] = r1_ptr[3u * i + j];
+                    }
+                    buf.tof[i] = tof_at(i);
+                    if (!(buf.tof[i] > 0)) {
+                        throw std::domain_error(fmt::format(
+                            "lambert_solve_v: all times of flight must be positive, but {} was found", buf.tof[i]));
+                    }
+                    buf.mu[i] = mu;
+                    buf.cw[i] = cw;
+                }
+                // As in porkchop and mga_v, the problems with no defined direction of motion get NaN velocities.
+                buf.solve(N);
+                for (std::size_t i = 0u; i < N; ++i) {
+                    for (std::size_t j = 0u; j < 3u; ++j) {
+                        v0_ptr[3u * i + j] = buf.v0[j][i];
+                        v1_ptr[3u * i + j] = buf.v1[j][i];
+                    }
+                }
+            }
+            return py::make_tuple(v0s, v1s);
+        },
+        py::arg("r0s"), py::arg("r1s"), py::arg("tofs"), py::arg("mu") = 1., py::arg("cw") = false,
+        py::arg("v0s_out") = py::none(), py::arg("v1s_out") = py::none(), pykep::lambert_solve_v_docstring().c_str());
 }
@@ -22,7 +22,7 @@ std::string core_module_doc()
 
 std::string m2e_doc()
 {
-    return R"(m2e(M, ecc)
+    return R"(m2e(M, ecc, solver = pk.kepler_solver.NEWTON)
     
     Converts from Mean to Eccentric anomaly. Requires ecc < 1.
 
@@ -31,6 +31,10 @@ std::string m2e_doc()
 
       *ecc* (:class:`float`): the eccentricity
 
+      *solver* (:class:`~pykep.kepler_solver`): the solver for Kepler's equation. NEWTON iterates to full
+      precision, FIXED applies two fourth order corrections to Mikkola's starter, with a fixed cost and the
+      same accuracy.
+
     Returns:
       :class:`float`: the Eccentric anomaly in [-pi, pi] (rad.)
 
@@ -137,7 +141,7 @@ std::string f2m_doc()
 
 std::string m2f_doc()
 {
-    return R"(m2f(M, ecc)
+    return R"(m2f(M, ecc, solver = pk.kepler_solver.NEWTON)
     
     Converts from Mean to True anomaly. Requires ecc < 1.
 
@@ -146,6 +150,10 @@ std::string m2f_doc()
 
       *ecc* (:class:`float`): the eccentricity
 
+      *solver* (:class:`~pykep.kepler_solver`): the solver for Kepler's equation. NEWTON iterates to full
+      precision, FIXED applies two fourth order corrections to Mikkola's starter, with a fixed cost and the
+      same accuracy.
+
     Returns:
       :class:`float`: the True anomaly in [-pi, pi] (rad.)
 
@@ -351,6 +359,9 @@ std::string m2e_v_doc()
     
     Converts from Mean to Eccentric anomaly (vectorized version). Requires ecc < 1.
 
+    Kepler's equation is solved by a vectorised C++ kernel with the GIL released. NaN is returned
+    where ecc is not in [0, 1).
+
     Args:
       *Ms* (:class:`numpy.ndarray` or :class:`float`): the Mean anomaly (rad.)
 
@@ -476,6 +487,9 @@ std::string m2f_v_doc()
     
     Converts from Mean to True anomaly (vectorized version). Requires ecc < 1.
 
+    Kepler's equation is solved by a vectorised C++ kernel with the GIL released. NaN is returned
+    where ecc is not in [0, 1).
+
     Args:
       *Ms* (:class:`numpy.ndarray` or :class:`float`): the Mean anomaly (rad.)
 
@@ -526,6 +540,9 @@ std::string n2h_v_doc()
     
     Converts from Hyperbolic Mean to Hyperbolic anomaly (vectorized version). Requires ecc > 1.
 
+    The hyperbolic Kepler's equation is solved in C++ with the GIL released. NaN is returned where
+    ecc <= 1.
+
     Args:
       *Ns* (:class:`numpy.ndarray` or :class:`float`): the Hyperbolic Mean anomaly (rad.)
 
@@ -626,6 +643,9 @@ std::string n2f_v_doc()
     
     Converts from Hyperbolic Mean to True anomaly (vectorized version). Requires ecc > 1.
 
+    The hyperbolic Kepler's equation is solved in C++ with the GIL released. NaN is returned where
+    ecc <= 1.
+
     Args:
       *Ns* (:class:`numpy.ndarray` or :class:`float`): the Hyperbolic Mean anomaly (rad.)
 
@@ -698,6 +718,202 @@ std::string f2zeta_v_doc()
 )";
 }
 
+std::string ic2par_v_docstring()
+{
+    return R"(ic2par_v(rvs, mu = 1, out = None)
+
+    Converts many Cartesian states into osculating Keplerian elements, as :func:`~pykep.ic2par` does for one.
+    The GIL is released during the computation.
+
+    Args:
+          *rvs* (:class:`numpy.ndarray`): the Cartesian states, one per row [x, y, z, vx, vy, vz] (shape (N, 6)).
+
+          *mu* (:class:`float`): gravitational parameter. Defaults to 1.
+
+          *out* (:class:`numpy.ndarray`): if provided, the elements are written into this C-contiguous float64 array
+          of shape (N, 6), which is also returned. It may be *rvs* itself. The rows are transposed to the structure of
+          arrays used by kep3 through an internal buffer, so that *out* only avoids allocating the result.
+          Defaults to None.
+
+    Returns:
+          :class:`numpy.ndarray`: the elements, one per row [a, e, i, W, w, f] (shape (N, 6)).
+
+    Raises:
+          :exc:`ValueError`: if the arrays do not have the expected shapes, or if *out* is not a writeable,
+          C-contiguous float64 array.
+
+    Example::
+        >>> import pykep as pk
+        >>> import numpy as np
+        >>> rvs = np.array([[1,0,0,0,1,0], [1,0,0,0,1.1,0.1]])
+        >>> pars = pk.ic2par_v(rvs = rvs, mu = 1)
+)";
+}
+
+std::string par2ic_v_docstring()
+{
+    return R"(par2ic_v(pars, mu = 1, out = None)
+
+    Converts many osculating Keplerian elements into Cartesian states, as :func:`~pykep.par2ic` does for one.
+    The GIL is released during the computation.
+
+    Args:
+          *pars* (:class:`numpy.ndarray`): the elements, one per row [a, e, i, W, w, f] (shape (N, 6)).
+
+          *mu* (:class:`float`): gravitational parameter. Defaults to 1.
+
+          *out* (:class:`numpy.ndarray`): if provided, the states are written into this C-contiguous float64 array
+          of shape (N, 6), which is also returned. It may be *pars* itself. The rows are transposed to the structure of
+          arrays used by kep3 through an internal buffer, so that *out* only avoids allocating the result.
+          Defaults to None.
+
+    Returns:
+          :class:`numpy.ndarray`: the Cartesian states, one per row [x, y, z, vx, vy, vz] (shape (N, 6)).
+
+    Raises:
+          :exc:`ValueError`: if the arrays do not have the expected shapes, if *out* is not a writeable,
+          C-contiguous float64 array, or if some elements are not valid.
+
+    Example::
+        >>> import pykep as pk
+        >>> import numpy as np
+        >>> pars = np.array([[1,0.1,0.2,0.3,0.4,0.5], [-2,1.5,0.2,0.3,0.4,0.5]])
+        >>> rvs = pk.par2ic_v(pars = pars, mu = 1)
+)";
+}
+
+std::string ic2eq_v_docstring()
+{
+    return R"(ic2eq_v(rvs, mu = 1, retrogade = False, out = None)
+
+    Converts many Cartesian states into modified equinoctial elements, as :func:`~pykep.ic2eq` does for one.
+    The GIL is released during the computation.
+
+    Args:
+          *rvs* (:class:`numpy.ndarray`): the Cartesian states, one per row [x, y, z, vx, vy, vz] (shape (N, 6)).
+
+          *mu* (:class:`float`): gravitational parameter. Defaults to 1.
+
+          *retrogade* (:class:`bool`): uses the retrograde parameters. Defaults to False.
+
+          *out* (:class:`numpy.ndarray`): if provided, the elements are written into this C-contiguous float64 array
+          of shape (N, 6), which is also returned. It may be *rvs* itself. The rows are transposed to the structure of
+          arrays used by kep3 through an internal buffer, so that *out* only avoids allocating the result.
+          Defaults to None.
+
+    Returns:
+          :class:`numpy.ndarray`: the modified equinoctial elements, one per row [p, f, g, h, k, L] (shape (N, 6)).
+
+    Raises:
+          :exc:`ValueError`: if the arrays do not have the expected shapes, or if *out* is not a writeable,
+          C-contiguous float64 array.
+
+    Example::
+        >>> import pykep as pk
+        >>> import numpy as np
+        >>> rvs = np.array([[1,0,0,0,1,0], [1,0,0,0,1.1,0.1]])
+        >>> eqs = pk.ic2eq_v(rvs = rvs, mu = 1)
+)";
+}
+
+std::string eq2ic_v_docstring()
+{
+    return R"(eq2ic_v(eqs, mu = 1, retrogade = False, out = None)
+
+    Converts many modified equinoctial elements into Cartesian states, as :func:`~pykep.eq2ic` does for one.
+    The GIL is released during the computation.
+
+    Args:
+          *eqs* (:class:`numpy.ndarray`): the modified equinoctial elements, one per row [p, f, g, h, k, L] (shape (N, 6)).
+
+          *mu* (:class:`float`): gravitational parameter. Defaults to 1.
+
+          *retrogade* (:class:`bool`): uses the retrograde parameters. Defaults to False.
+
+          *out* (:class:`numpy.ndarray`): if provided, the states are written into this C-contiguous float64 array
+          of shape (N, 6), which is also returned. It may be *eqs* itself. The rows are transposed to the structure of
+          arrays used by kep3 through an internal buffer, so that *out* only avoids allocating the result.
+          Defaults to None.
+
+    Returns:
+          :class:`numpy.ndarray`: the Cartesian states, one per row [x, y, z, vx, vy, vz] (shape (N, 6)).
+
+    Raises:
+          :exc:`ValueError`: if the arrays do not have the expected shapes, or if *out* is not a writeable,
+          C-contiguous float64 array.
+
+    Example::
+        >>> import pykep as pk
+        >>> import numpy as np
+        >>> eqs = np.array([[1,0.1,0.1,0.1,0.1,0.5], [2,0.2,0.,0.1,0.,1.5]])
+        >>> rvs = pk.eq2ic_v(eqs = eqs, mu = 1)
+)";
+}
+
+std::string par2eq_v_docstring()
+{
+    return R"(par2eq_v(pars, retrogade = False, out = None)
+
+    Converts many osculating Keplerian elements into modified equinoctial elements, as :func:`~pykep.par2eq` does for one.
+    The GIL is released during the computation.
+
+    Args:
+          *pars* (:class:`numpy.ndarray`): the elements, one per row [a, e, i, W, w, f] (shape (N, 6)).
+
+          *retrogade* (:class:`bool`): uses the retrograde parameters. Defaults to False.
+
+          *out* (:class:`numpy.ndarray`): if provided, the elements are written into this C-contiguous float64 array
+          of shape (N, 6), which is also returned. It may be *pars* itself. The rows are transposed to the structure of
+          arrays used by kep3 through an internal buffer, so that *out* only avoids allocating the result.
+          Defaults to None.
+
+    Returns:
+          :class:`numpy.ndarray`: the modified equinoctial elements, one per row [p, f, g, h, k, L] (shape (N, 6)).
+
+    Raises:
+          :exc:`ValueError`: if the arrays do not have the expected shapes, or if *out* is not a writeable,
+          C-contiguous float64 array.
+
+    Example::
+        >>> import pykep as pk
+        >>> import numpy as np
+        >>> pars = np.array([[1,0.1,0.2,0.3,0.4,0.5], [-2,1.5,0.2,0.3,0.4,0.5]])
+        >>> eqs = pk.par2eq_v(pars = pars)
+)";
+}
+
+std::string eq2par_v_docstring()
+{
+    return R"(eq2par_v(eqs, retrogade = False, out = None)
+
+    Converts many modified equinoctial elements into osculating Keplerian elements, as :func:`~pykep.eq2par` does for one.
+    The GIL is released during the computation.
+
+    Args:
+          *eqs* (:class:`numpy.ndarray`): the modified equinoctial elements, one per row [p, f, g, h, k, L] (shape (N, 6)).
+
+          *retrogade* (:class:`bool`): uses the retrograde parameters. Defaults to False.
+
+          *out* (:class:`numpy.ndarray`): if provided, the elements are written into this C-contiguous float64 array
+          of shape (N, 6), which is also returned. It may be *eqs* itself. The rows are transposed to the structure of
+          arrays used by kep3 through an internal buffer, so that *out* only avoids allocating the result.
+          Defaults to None.
+
+    Returns:
+          :class:`numpy.ndarray`: the elements, one per row [a, e, i, W, w, f] (shape (N, 6)).
+
+    Raises:
+          :exc:`ValueError`: if the arrays do not have the expected shapes, or if *out* is not a writeable,
+          C-contiguous float64 array.
+
+    Example::
+        >>> import pykep as pk
+        >>> import numpy as np
+        >>> eqs = np.array([[1,0.1,0.1,0.1,0.1,0.5], [2,0.2,0.,0.1,0.,1.5]])
+        >>> pars = pk.eq2par_v(eqs = eqs)
+)";
+}
+
 std::string epoch_from_float_doc()
 {
     return R"(__init__(when: float, julian_type = MJD2000)
@@ -959,7 +1175,7 @@ Returns:
 
 std::string planet_eph_v_docstring()
 {
-    return R"(eph_v(mjd2000s)
+    return R"(eph_v(mjd2000s, out = None)
 
 The planet ephemerides, i.e. position and velocity (vectorized version over many epochs).
 
@@ -976,11 +1192,21 @@ in his UDPLA by coding a method having the signature:
 
 see, for example, the python implementation of the UDPLAS :class:`~pykep.udpla.tle` and :class:`~pykep.udpla.spice`.
 
+All the epochs are computed in a single call to the UDPLA, with the GIL released, and the results are written directly
+into the returned array.
+
 Args:
     *mjd2000s* (:class:`ndarray` or :class:`list`): the Modified Julian Dates at which to compute the ephemerides.
 
+    *out* (:class:`numpy.ndarray`): if provided, the ephemerides are written into this C-contiguous float64 array
+    of shape (N, 6), which is also returned. Defaults to None.
+
 Returns:
-    :class:`list` [:class:`list`, :class:`list`]: r and v, that is the final position and velocity after the propagation.
+    :class:`numpy.ndarray`: the positions and velocities, one per row [x, y, z, vx, vy, vz] (shape (N, 6)).
+
+Raises:
+    :exc:`ValueError`: if *mjd2000s* is not one dimensional, or if *out* is not a writeable, C-contiguous float64
+    array of shape (N, 6).
 
 )";
 }
@@ -1103,9 +1329,38 @@ Examples:
 )";
 }
 
+std::string udpla_cached_docstring()
+{
+    return R"(__init__(pla, when_start, when_end, tol = 1e-12, order = 12)
+
+Constructs a planet whose ephemerides are interpolated from those of *pla*. Upon construction, *pla*
+is sampled over [*when_start*, *when_end*] and piecewise Chebyshev interpolants of the requested
+*order* are built, bisecting the interval until the relative error on the position and velocity is
+below *tol*. The ephemerides are then computed in C++ without calling *pla*, which makes this udpla
+useful to speed up repeated queries to expensive (e.g. python) udplas.
+
+Args:
+    *pla* (:class:`~pykep.planet`): the planet to interpolate.
+
+    *when_start* (:class:`float`): start of the interpolation interval (mjd2000).
+
+    *when_end* (:class:`float`): end of the interpolation interval (mjd2000).
+
+    *tol* (:class:`float`): the relative tolerance of the interpolation.
+
+    *order* (:class:`int`): the order of the Chebyshev interpolants.
+
+Examples:
+    >>> import pykep as pk
+    >>> pla = pk.planet(pk.udpla.jpl_lp(name="mars"))
+    >>> udpla = pk.udpla.cached(pla, 0., 3000.)
+    >>> pla_cached = pk.planet(udpla)
+)";
+}
+
 std::string lambert_problem_docstring()
 {
-    return R"(__init__(r0 = [1,0,0], r1 = [0,1,0], tof = pi/2, mu = 1., cw = False, max_revs = 0)
+    return R"(__init__(r0 = [1,0,0], r1 = [0,1,0], tof = pi/2, mu = 1., cw = False, multi_revs = 1, jacobians = False, x_guess = [])
 
       Args:
           *r0* (1D array-like): Cartesian components of the first position vector [xs, ys, zs]. Defaults to [1,0,0].
@@ -1118,7 +1373,14 @@ std::string lambert_problem_docstring()
 
           *cw* (:class:`bool`): True for retrograde motion (clockwise). Defaults to False.
 
-          *max_revs* (:class:`float`): Maximum number of multiple revolutions to be computed. Defaults to 0.
+          *multi_revs* (:class:`int`): Maximum number of multiple revolutions to be computed. Defaults to 1.
+
+          *jacobians* (:class:`bool`): True to also compute the Jacobians of the terminal velocities with respect
+          to *r0*, *r1* and *tof* (see :attr:`v0_jacobian`). Defaults to False.
+
+          *x_guess* (1D array-like): initial guesses for the Battin variable of each solution, ordered as :attr:`x`.
+          Typically the :attr:`x` of a neighbouring problem, they warm start the corresponding iterations
+          (see :attr:`iters`). Guesses outside the domain of their branch are ignored. Defaults to [].
 
       .. note::
 
@@ -1138,30 +1400,424 @@ std::string lambert_problem_docstring()
 )";
 }
 
-std::string propagate_lagrangian_docstring()
+std::string lambert_problem_v0_jacobian_docstring()
+{
+    return R"(The Jacobians of the velocity at the first point.
+
+    For each solution, the 3x7 matrix :math:`\frac{\partial \mathbf v_0}{\partial (\mathbf r_0, \mathbf r_1, t)}`,
+    where the columns are the cartesian components of *r0*, those of *r1* and the time of flight. They are computed
+    analytically by implicit differentiation of the time of flight equation at the converged solution.
+
+    Returns:
+        :class:`numpy.ndarray`: an array of shape (n_solutions, 3, 7), empty unless the problem was constructed
+        with *jacobians* = True.
+)";
+}
+
+std::string lambert_problem_v1_jacobian_docstring()
+{
+    return R"(The Jacobians of the velocity at the second point.
+
+    For each solution, the 3x7 matrix :math:`\frac{\partial \mathbf v_1}{\partial (\mathbf r_0, \mathbf r_1, t)}`,
+    with columns ordered as in :attr:`v0_jacobian`.
+
+    Returns:
+        :class:`numpy.ndarray`: an array of shape (n_solutions, 3, 7), empty unless the problem was constructed
+        with *jacobians* = True.
+)";
+}
+
+std::string lambert_problem_v0_array_docstring()
+{
+    return R"(The velocities at the first point, as an array.
+
+    A read-only view of the velocities in :attr:`v0`, which avoids the conversion to lists. The view keeps the
+    problem alive.
+
+    Returns:
+        :class:`numpy.ndarray`: an array of shape (n_solutions, 3).
+)";
+}
+
+std::string lambert_problem_v1_array_docstring()
+{
+    return R"(The velocities at the second point, as an array.
+
+    A read-only view of the velocities in :attr:`v1`, which avoids the conversion to lists. The view keeps the
+    problem alive.
+
+    Returns:
+        :class:`numpy.ndarray`: an array of shape (n_solutions, 3).
+)";
+}
+
+std::string lambert_solve_branch_docstring()
 {
-    return R"(propagate_lagrangian(r0 = [1,0,0], v0 = [0,1,0], tof = pi/2, mu = 1)
+    return R"(lambert_solve_branch(r0, r1, tof, mu = 1., cw = False, N = 0, right = False, check_existence = True)
+
+    Solves only the branch with *N* revolutions (left or right) of a Lambert's problem. The numerics are those of
+    :class:`~pykep.lambert_problem`, but the other branches are not computed.
 
     Args:
-          *r0* (1D array-like): Cartesian components of the initial position vector [x0, y0, z0]. Defaults to [1,0,0].
+        *r0* (1D array-like): Cartesian components of the first position vector [xs, ys, zs].
 
-          *v0* (1D array-like): Cartesian components of the initial velocity [vx0, vy0, vz0]. Defaults tot [0,1,0].
+        *r1* (1D array-like): Cartesian components of the second position vector [xf, yf, zf].
 
-          *tof* (:class:`float`): time of flight. Defaults to :math:`\frac{\pi}{2}`.
+        *tof* (:class:`float`): time of flight.
+
+        *mu* (:class:`float`): gravitational parameter. Defaults to 1.
+
+        *cw* (:class:`bool`): True for retrograde motion (clockwise). Defaults to False.
+
+        *N* (:class:`int`): number of revolutions. Defaults to 0 (in which case *right* is ignored).
+
+        *right* (:class:`bool`): True for the right branch, False for the left one. Defaults to False.
+
+        *check_existence* (:class:`bool`): when True, it is first checked that the branch exists (finding the
+        minimum time of flight of the *N* revolutions curve only when needed). When False, the check is skipped
+        and, if the branch does not exist, the iterations will not converge. Defaults to True.
+
+    Returns:
+        :class:`tuple`: v0, v1, x and the number of iterations made.
+
+    Raises:
+        :exc:`ValueError`: if the branch does not exist (and *check_existence* is True), if *tof* or *mu* are not
+        positive or if the direction of motion cannot be determined.
+
+    Examples:
+        >>> import pykep as pk
+        >>> v0, v1, x, iters = pk.lambert_solve_branch([1,0,0], [0,1,0], 20., N = 2, right = True)
+)";
+}
+
+std::string lambert_solve_v_docstring()
+{
+    return R"(lambert_solve_v(r0s, r1s, tofs, mu = 1, cw = False, v0s_out = None, v1s_out = None)
+
+    Solves many Lambert problems, returning their zero revolutions solutions. The numerics are those of
+    :class:`~pykep.lambert_problem`, but the problems are solved in one call by the vectorized kernels of kep3
+    and the GIL is released during the computation, so that several Python threads can solve at once.
+
+    Args:
+          *r0s* (:class:`numpy.ndarray`): the first positions, one per row (shape (N, 3)).
+
+          *r1s* (:class:`numpy.ndarray`): the second positions, one per row (shape (N, 3)).
+
+          *tofs* (:class:`numpy.ndarray` or :class:`float`): the times of flight (shape (N,)), or one time of flight for all problems.
 
           *mu* (:class:`float`): gravitational parameter. Defaults to 1.
 
+          *cw* (:class:`bool`): direction of motion (True for clockwise). Defaults to False.
+
+          *v0s_out* (:class:`numpy.ndarray`): if provided, the velocities at the first points are written into this
+          C-contiguous float64 array of shape (N, 3), which is also returned. Defaults to None.
+
+          *v1s_out* (:class:`numpy.ndarray`): as *v0s_out*, for the velocities at the second points. Defaults to None.
+
+    Returns:
+          :class:`tuple` (:class:`numpy.ndarray`, :class:`numpy.ndarray`): the velocities at the first and
+          at the second points (shapes (N, 3)). The rows of the problems whose direction of motion cannot be
+          determined (the angular momentum has no z component) are NaN.
+
+    Raises:
+          :exc:`ValueError`: if the arrays do not have the expected shapes, if an output array is not a writeable,
+          C-contiguous float64 array, or if *mu* or a time of flight is not positive.
+
+    Example::
+        >>> import pykep as pk
+        >>> import numpy as np
+        >>> r0s = np.array([[1,0,0], [1,0,0]])
+        >>> r1s = np.array([[0,1,0], [0,2,0]])
+        >>> v0s, v1s = pk.lambert_solve_v(r0s = r0s, r1s = r1s, tofs = [np.pi/2, 5.], mu = 1)
+)";
+}
+
+std::string porkchop_docstring()
+{
+    return R"(porkchop(pl0, pl1, t0s, tofs, mu = MU_SUN, cw = False)
+
+    Computes a porkchop plot, that is the departure and arrival delta-v of the zero revolutions
+    Lambert transfers from *pl0* to *pl1* over a grid of departure epochs and times of flight.
+
+    The ephemerides are computed once per grid axis and all Lambert problems are solved in C++,
+    in parallel.
+
+    Args:
+          *pl0* (:class:`~pykep.planet`): the departure planet.
+
+          *pl1* (:class:`~pykep.planet`): the arrival planet.
+
+          *t0s* (1D array-like): the departure epochs (mjd2000).
+
+          *tofs* (1D array-like): the times of flight (days).
+
+          *mu* (:class:`float`): gravitational parameter of the central body. Defaults to MU_SUN.
+
+          *cw* (:class:`bool`): True for retrograde motion (clockwise). Defaults to False.
+
+    Returns:
+          :class:`tuple` [:class:`numpy.ndarray`, :class:`numpy.ndarray`]: the departure and arrival
+          delta-v, with shape (len(t0s), len(tofs)). Cells where the Lambert problem is not defined are NaN.
+
+    Example::
+        >>> import pykep as pk
+        >>> import numpy as np
+        >>> earth = pk.planet(pk.udpla.jpl_lp("earth"))
+        >>> mars = pk.planet(pk.udpla.jpl_lp("mars"))
+        >>> dv0, dv1 = pk.porkchop(earth, mars, np.linspace(7000, 8000, 100), np.linspace(100, 400, 50))
+)";
+}
+
+std::string fb_dv_docstring()
+{
+    return R"(fb_dv(v_rel_in, v_rel_out, mu, rp)
+
+    Computes the delta-v of a powered flyby, that is the minimum delta-v needed to turn the incoming
+    relative velocity into the outgoing one. The maximum deflection of the unpowered hyperbola,
+    :math:`2 \arcsin(1 / e_{min})` with :math:`e_{min} = 1 + r_p |v_{rel,in}|^2 / \mu`, is given for free.
+
+    Args:
+          *v_rel_in* (1D array-like): the incoming velocity relative to the planet.
+
+          *v_rel_out* (1D array-like): the outgoing velocity relative to the planet.
+
+          *mu* (:class:`float`): gravitational parameter of the planet.
+
+          *rp* (:class:`float`): the minimum pericenter radius (e.g. the safe radius of the planet).
+
+    Returns:
+          :class:`float`: the delta-v.
+
+    Example::
+        >>> import pykep as pk
+        >>> dv = pk.fb_dv([1., 0., 0.], [0., 1., 0.], mu = 1., rp = 1.)
+)";
+}
+
+std::string mga_docstring()
+{
+    return R"(mga(seq, x, mu = MU_SUN, cw = False)
+
+    Evaluates a multiple gravity assist (MGA) trajectory visiting the planets of *seq*, each leg being
+    the zero revolutions Lambert transfer between consecutive planets. The flybys are powered, their
+    delta-v being computed by :func:`~pykep.fb_dv` with the mu_self and the safe radius of the planet.
+
+    Args:
+          *seq* (:class:`list` [:class:`~pykep.planet`]): the planets, at least two.
+
+          *x* (1D array-like): the decision vector [t0, T1, ..., Tn-1], that is the departure epoch
+          (mjd2000) and the times of flight of the legs (days).
+
+          *mu* (:class:`float`): gravitational parameter of the central body. Defaults to MU_SUN.
+
+          *cw* (:class:`bool`): True for retrograde motion (clockwise). Defaults to False.
+
+    Returns:
+          :class:`tuple` [:class:`float`, :class:`list`]: the total delta-v and its breakdown, with one entry
+          per planet: the departure relative velocity, the delta-v of each flyby and the arrival relative velocity.
+
+    Raises:
+          :exc:`ValueError`: if *seq* has less than two planets or *x* does not have one entry per planet, if
+          mu or a time of flight is not positive, if a flyby planet does not have a positive mu_self and safe
+          radius, or if a Lambert problem is not defined.
+
+    Example::
+        >>> import pykep as pk
+        >>> seq = [pk.planet(pk.udpla.jpl_lp(name)) for name in ["earth", "venus", "venus", "earth", "jupiter"]]
+        >>> dv, dvs = pk.mga(seq, [-800., 150., 450., 420., 1200.])
+)";
+}
+
+std::string mga_v_docstring()
+{
+    return R"(mga_v(seq, xs, mu = MU_SUN, cw = False, dv_out = None, dvs_out = None)
+
+    Evaluates many multiple gravity assist trajectories, as :func:`~pykep.mga` does for one.
+
+    The ephemerides are computed once per planet of the sequence and the Lambert problems are solved
+    in C++, in parallel, with the GIL released.
+
+    Args:
+          *seq* (:class:`list` [:class:`~pykep.planet`]): the planets, at least two.
+
+          *xs* (:class:`numpy.ndarray`): the decision vectors, one per row (shape (N, len(seq))).
+
+          *mu* (:class:`float`): gravitational parameter of the central body. Defaults to MU_SUN.
+
+          *cw* (:class:`bool`): True for retrograde motion (clockwise). Defaults to False.
+
+          *dv_out* (:class:`numpy.ndarray`): if provided, the total delta-vs are written into this C-contiguous
+          float64 array of shape (N,). Defaults to None.
+
+          *dvs_out* (:class:`numpy.ndarray`): if provided, the delta-v breakdowns are written into this
+          C-contiguous float64 array of shape (N, len(seq)). Defaults to None.
+
+    Returns:
+          :class:`tuple` [:class:`numpy.ndarray`, :class:`numpy.ndarray`]: the total delta-vs (shape (N,))
+          and their breakdowns (shape (N, len(seq))). The entries of the decision vectors for which a Lambert
+          problem is not defined are NaN.
+
+    Raises:
+          :exc:`ValueError`: if the arrays do not have the expected shapes, if *seq* has less than two planets,
+          if mu or a time of flight is not positive, or if a flyby planet does not have a positive mu_self
+          and safe radius.
+
+    Example::
+        >>> import pykep as pk
+        >>> import numpy as np
+        >>> seq = [pk.planet(pk.udpla.jpl_lp(name)) for name in ["earth", "venus", "earth", "mars"]]
+        >>> xs = np.column_stack([np.linspace(0., 1000., 1000)] + [np.full(1000, 200.)] * 3)
+        >>> dv, dvs = pk.mga_v(seq, xs)
+)";
+}
+
+std::string propagate_lagrangian_docstring()
+{
+    return R"(propagate_lagrangian(rv = [[1,0,0], [0,1,0]], dt = pi/2, mu = 1, stm = False)
+
+    Propagates a Cartesian state for a time dt assuming a keplerian motion (Lagrange coefficients).
+
+    Args:
+          *rv* (2D array-like): Cartesian components of the initial position vector and velocity [[x0, y0, z0], [vx0, vy0, vz0]]. Defaults to [[1,0,0], [0,1,0]].
+
+          *dt* (:class:`float`): time of flight. Defaults to :math:`\frac{\pi}{2}`.
+
+          *mu* (:class:`float`): gravitational parameter. Defaults to 1.
+
+          *stm* (:class:`bool`): if True, the state transition matrix is also returned. Defaults to False.
+
     Returns:
           :class:`list` [:class:`list`, :class:`list`]: r and v, that is the final position and velocity after the propagation.
+          If *stm* is True, a tuple with r and v and the 6x6 state transition matrix (:class:`numpy.ndarray`)
+          :math:`\frac{\partial (\mathbf r, \mathbf v)}{\partial (\mathbf r_0, \mathbf v_0)}`, computed analytically.
 
     Example::
         >>> import pykep as pk
         >>> import numpy as np
         >>> r0 = [1,0,0]
         >>> v0 = [0,1,0]
-        >>> tof = pi/2
         >>> mu = 1
-        >>> r1,v1 = propagate_lagrangian(r0 = r0, v0 = v0, tof = pi/2, mu = 1)
+        >>> [r1,v1] = pk.propagate_lagrangian(rv = [r0, v0], dt = np.pi/2, mu = 1)
+        >>> [r1,v1], stm = pk.propagate_lagrangian(rv = [r0, v0], dt = np.pi/2, mu = 1, stm = True)
+)";
+}
+
+std::string propagate_lagrangian_v_docstring()
+{
+    return R"(propagate_lagrangian_v(rvs, dts, mu = 1, stm = False, out = None, stm_out = None)
+
+    Propagates many Cartesian states assuming a keplerian motion (Lagrange coefficients). The numerics are those of
+    :func:`~pykep.propagate_lagrangian`, but the states are processed in one call by the vectorized kernels of kep3
+    and the GIL is released during the computation, so that several Python threads can propagate at once.
+
+    Args:
+          *rvs* (:class:`numpy.ndarray`): the initial states, one per row [x0, y0, z0, vx0, vy0, vz0] (shape (N, 6)).
+
+          *dts* (:class:`numpy.ndarray` or :class:`float`): the times of flight (shape (N,)), or one time of flight for all states.
+
+          *mu* (:class:`float`): gravitational parameter. Defaults to 1.
+
+          *stm* (:class:`bool`): if True, the state transition matrices are also returned. Defaults to False.
+
+          *out* (:class:`numpy.ndarray`): if provided, the final states are written into this C-contiguous float64 array
+          of shape (N, 6), which is also returned. It may be *rvs* itself. The rows are transposed to the structure of
+          arrays used by kep3 through an internal buffer, so that *out* only avoids allocating the result.
+          Defaults to None.
+
+          *stm_out* (:class:`numpy.ndarray`): as *out*, for the state transition matrices (shape (N, 6, 6)). Defaults to None.
+
+    Returns:
+          :class:`numpy.ndarray`: the final states (shape (N, 6)). If *stm* is True, a tuple with the final states
+          and the state transition matrices (shape (N, 6, 6)).
+
+    Raises:
+          :exc:`ValueError`: if the arrays do not have the expected shapes, or if an output array is not a writeable,
+          C-contiguous float64 array.
+
+    Example::
+        >>> import pykep as pk
+        >>> import numpy as np
+        >>> rvs = np.array([[1,0,0,0,1,0], [1,0,0,0,1.1,0]])
+        >>> rvs_f = pk.propagate_lagrangian_v(rvs = rvs, dts = np.pi/2, mu = 1)
+        >>> rvs_f, stms = pk.propagate_lagrangian_v(rvs = rvs, dts = [np.pi/2, np.pi], mu = 1, stm = True)
+        >>> rvs_f = pk.propagate_lagrangian_v(rvs = rvs, dts = np.pi/2, mu = 1, out = rvs) # in place
+)";
+}
+
+std::string propagate_lagrangian_grid_docstring()
+{
+    return R"(propagate_lagrangian_grid(rv = [[1,0,0], [0,1,0]], dts, mu = 1, out = None)
+
+    Propagates one Cartesian state to many times assuming a keplerian motion (Lagrange coefficients), e.g. to plot
+    or screen a trajectory. The results are those of :func:`~pykep.propagate_lagrangian` called for each time of
+    flight, but the quantities of the initial state are computed once and each solution of Kepler's equation is
+    warm started from the previous one, which pays off when *dts* is sorted. The states are written directly into
+    the returned array and the GIL is released during the computation.
+
+    Args:
+          *rv* (2D array-like): Cartesian components of the initial position vector and velocity [[x0, y0, z0], [v0, vy0, vz0]].
+
+          *dts* (:class:`numpy.ndarray`): the times of flight (shape (N,)).
+
+          *mu* (:class:`float`): gravitational parameter. Defaults to 1.
+
+          *out* (:class:`numpy.ndarray`): if provided, the states are written into this C-contiguous float64 array
+          of shape (N, 6), which is also returned. Defaults to None.
+
+    Returns:
+          :class:`numpy.ndarray`: the states at the times of flight, one per row [x, y, z, vx, vy, vz] (shape (N, 6)).
+
+    Raises:
+          :exc:`ValueError`: if the arrays do not have the expected shapes, or if *out* is not a writeable,
+          C-contiguous float64 array.
+
+    Example::
+        >>> import pykep as pk
+        >>> import numpy as np
+        >>> rvs = pk.propagate_lagrangian_grid(rv = [[1,0,0],[0,1,0]], dts = np.linspace(0, 2*np.pi, 100), mu = 1)
+)";
+}
+
+std::string instrumentation_enabled_docstring()
+{
+    return R"(instrumentation_enabled()
+
+    Whether kep3 was built with the solvers instrumentation (the CMake option ``kep3_ENABLE_INSTRUMENTATION``).
+    When it was not, the solvers record nothing and the snapshots only contain zeros.
+
+    Returns:
+        :class:`bool`: True if the instrumentation is enabled.
+)";
+}
+
+std::string instrumentation_snapshot_docstring()
+{
+    return R"(instrumentation_snapshot()
+
+    Returns the counters of the solvers instrumentation, summed over all threads.
+
+    Returns:
+        :class:`dict`: with keys *iters* and *events*. *iters* maps each solver (``m2e``, ``n2h``,
+        ``propagate_lagrangian_elliptic``, ``propagate_lagrangian_hyperbolic``, ``propagate_lagrangian_u``
+        and ``lambert_householder``) to the histogram of its iterations per call (:class:`numpy.ndarray`, the last
+        bin also counting the longer calls). *events* maps each event (the branch used to compute the Lambert time
+        of flight, ``x2tof_battin``, ``x2tof_lagrange`` and ``x2tof_lancaster``, and the failures ``m2e_throw``,
+        ``n2h_throw``, ``propagate_lagrangian_throw`` and ``propagate_lagrangian_u_throw``) to its occurrences.
+
+    Examples:
+        >>> import pykep as pk
+        >>> pk.instrumentation_reset()
+        >>> E = pk.m2e(0.3, 0.1)
+        >>> n_calls = pk.instrumentation_snapshot()["iters"]["m2e"].sum()
+)";
+}
+
+std::string instrumentation_reset_docstring()
+{
+    return R"(instrumentation_reset()
+
+    Resets the counters of the solvers instrumentation of all threads. It should not be called while
+    solvers are running in other threads.
 )";
 }
 
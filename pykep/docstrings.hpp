@@ -54,6 +54,14 @@ std::string f2h_v_doc();
 std::string zeta2f_v_doc();
 std::string f2zeta_v_doc();
 
+// Element conversions (vectorized)
+std::string ic2par_v_docstring();
+std::string par2ic_v_docstring();
+std::string ic2eq_v_docstring();
+std::string eq2ic_v_docstring();
+std::string par2eq_v_docstring();
+std::string eq2par_v_docstring();
+
 // Epoch
 std::string epoch_from_float_doc();
 std::string epoch_from_datetime_doc();
@@ -76,13 +84,35 @@ std::string planet_elements_docstring();
 std::string udpla_keplerian_from_elem_docstring();
 std::string udpla_keplerian_from_posvel_docstring();
 std::string udpla_jpl_lp_docstring();
+std::string udpla_cached_docstring();
 
 
 // Lambert Problem
 std::string lambert_problem_docstring();
+std::string lambert_problem_v0_jacobian_docstring();
+std::string lambert_problem_v1_jacobian_docstring();
+std::string lambert_problem_v0_array_docstring();
+std::string lambert_problem_v1_array_docstring();
+std::string lambert_solve_branch_docstring();
+std::string lambert_solve_v_docstring();
+
+// Porkchop
+std::string porkchop_docstring();
+
+// MGA
+std::string fb_dv_docstring();
+std::string mga_docstring();
+std::string mga_v_docstring();
 
 // Propagators
 std::string propagate_lagrangian_docstring();
+std::string propagate_lagrangian_v_docstring();
+std::string propagate_lagrangian_grid_docstring();
+
+// Instrumentation
+std::string instrumentation_enabled_docstring();
+std::string instrumentation_snapshot_docstring();
+std::string instrumentation_reset_docstring();
 
 } // namespace pykep
 
@@ -12,6 +12,7 @@
 #include <pybind11/pybind11.h>
 
 #include <kep3/planet.hpp>
+#include <kep3/planets/cached.hpp>
 #include <kep3/planets/jpl_lp.hpp>
 #include <kep3/planets/keplerian.hpp>
 
@@ -61,6 +62,20 @@ void expose_all_udplas(py::module &udpla_module, py::class_<kep3::planet> &plane
              pykep::udpla_jpl_lp_docstring().c_str())
         // repr().
         .def("__repr__", &pykep::ostream_repr<kep3::udpla::jpl_lp>);
+
+    // cached udpla
+    auto cached_udpla = pykep::expose_one_udpla<kep3::udpla::cached>(
+        udpla_module, planet_class, "_cached", "Interpolated ephemerides of any planet");
+    // Constructors.
+    cached_udpla
+        .def(py::init<kep3::planet, double, double, double, unsigned>(), py::arg("pla"), py::arg("when_start"),
+             py::arg("when_end"), py::arg("tol") = 1e-12, py::arg("order") = 12u,
+             pykep::udpla_cached_docstring().c_str())
+        // repr().
+        .def("__repr__", &pykep::ostream_repr<kep3::udpla::cached>)
+        // other methods
+        .def_property_readonly("planet", &kep3::udpla::cached::get_planet)
+        .def_property_readonly("n_pieces", &kep3::udpla::cached::get_n_pieces);
 }
 
 } // namespace pykep
@@ -40,9 +40,13 @@ python_udpla::python_udpla(py::object obj) : m_obj(std::move(obj))
     check_mandatory_method(m_obj, "eph", "planet");
 };
 
+// NOTE: the methods may be called by C++ code which released the GIL (e.g. planet.eph()),
+// hence they all (re)acquire it.
+
 // Mandatory methods
 [[nodiscard]] std::array<std::array<double, 3>, 2> python_udpla::eph(double mjd2000) const
 {
+    const py::gil_scoped_acquire gil;
     auto udpla_eph = pykep::callable_attribute(m_obj, "eph");
     if (udpla_eph.is_none()) {
         pykep::py_throw(PyExc_NotImplementedError, ("the eph() method has been invoked, but it is not implemented "
@@ -57,6 +61,7 @@ python_udpla::python_udpla(py::object obj) : m_obj(std::move(obj))
 // Optional methods
 [[nodiscard]] std::vector<double> python_udpla::eph_v(const std::vector<double> &mjd2000s) const
 {
+    const py::gil_scoped_acquire gil;
     auto udpla_eph_v = pykep::callable_attribute(m_obj, "eph_v");
     if (!udpla_eph_v.is_none()) {
         auto ret = py::cast<py::array_t<double>>(udpla_eph_v(mjd2000s));
@@ -69,30 +74,37 @@ python_udpla::python_udpla(py::object obj) : m_obj(std::move(obj))
 
 [[nodiscard]] std::string python_udpla::get_name() const
 {
+    const py::gil_scoped_acquire gil;
     return getter_wrapper<std::string>(m_obj, "get_name", pykep::str(pykep::type(m_obj)));
 }
 [[nodiscard]] std::string python_udpla::get_extra_info() const
 {
+    const py::gil_scoped_acquire gil;
     return getter_wrapper<std::string>(m_obj, "get_extra_info", "");
 }
 [[nodiscard]] double python_udpla::get_mu_central_body() const
 {
+    const py::gil_scoped_acquire gil;
     return getter_wrapper<double>(m_obj, "get_mu_central_body", -1);
 }
 [[nodiscard]] double python_udpla::get_mu_self() const
 {
+    const py::gil_scoped_acquire gil;
     return getter_wrapper<double>(m_obj, "get_mu_self", -1);
 }
 [[nodiscard]] double python_udpla::get_radius() const
 {
+    const py::gil_scoped_acquire gil;
     return getter_wrapper<double>(m_obj, "get_radius", -1);
 }
 [[nodiscard]] double python_udpla::get_safe_radius() const
 {
+    const py::gil_scoped_acquire gil;
     return getter_wrapper<double>(m_obj, "get_safe_radius", -1);
 }
 [[nodiscard]] double python_udpla::period(double mjd2000) const
 {
+    const py::gil_scoped_acquire gil;
     auto udpla_period = pykep::callable_attribute(m_obj, "period");
     auto udpla_get_mu_central_body = pykep::callable_attribute(m_obj, "get_mu_central_body");
 
@@ -128,6 +140,7 @@ python_udpla::python_udpla(py::object obj) : m_obj(std::move(obj))
 
 [[nodiscard]] std::array<double, 6> python_udpla::elements(double mjd2000, kep3::elements_type el_type) const
 {
+    const py::gil_scoped_acquire gil;
     auto udpla_elements = pykep::callable_attribute(m_obj, "elements");
     auto udpla_get_mu_central_body = pykep::callable_attribute(m_obj, "get_mu_central_body");
     // If the user provides an efficient way to compute the orbital elements, then use it.
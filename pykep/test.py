@@ -18,6 +18,9 @@ class anomaly_conversions_tests(_ut.TestCase):
         import pykep as pk
 
         self.assertTrue(float_abs_error(pk.m2e(pk.e2m(0.1, 0.1), 0.1), 0.1) < 1e-14)
+        self.assertTrue(
+            float_abs_error(pk.m2e(0.1, 0.99, pk.kepler_solver.FIXED), pk.m2e(0.1, 0.99)) < 1e-14
+        )
 
     def test_m2f(self):
         import pykep as pk
@@ -49,6 +52,23 @@ class anomaly_conversions_tests(_ut.TestCase):
 
         self.assertTrue(float_abs_error(pk.f2zeta(pk.zeta2f(0.1, 10.1), 10.1), 0.1) < 1e-14)
 
+    def test_vectorized(self):
+        import pykep as pk
+        import numpy as np
+
+        M = np.linspace(-10, 10, 101).reshape(101, 1)
+        ecc = np.array([0.0, 0.1, 0.9])
+        E = pk.m2e_v(M, ecc)
+        self.assertTrue(E.shape == (101, 3))
+        self.assertTrue(np.max(np.abs(pk.e2m_v(E, ecc) - M)) < 1e-13)
+        # Scalars in, float out.
+        self.assertTrue(isinstance(pk.m2e_v(0.1, 0.1), float))
+        self.assertTrue(float_abs_error(pk.m2e_v(0.1, 0.1), pk.m2e(0.1, 0.1)) < 1e-15)
+        # NaN outside the domain.
+        self.assertTrue(np.isnan(pk.m2e_v(0.1, 1.1)))
+        self.assertTrue(np.isnan(pk.n2h_v(0.1, 0.9)))
+        self.assertTrue(float_abs_error(pk.n2h_v(0.1, 10.1), pk.n2h(0.1, 10.1)) < 1e-14)
+
 class epoch_test(_ut.TestCase):
     def test_epoch_construction(self):
         import pykep as pk
@@ -169,6 +189,10 @@ class planet_test(_ut.TestCase):
         r0, v0 = pla.eph(0.)
         r1, v1 = pla.eph(1.)
         self.assertTrue(np.all(pla.eph_v([0., 1]) == [r0+v0,r1+v1]))
+        out = np.zeros((2, 6))
+        self.assertTrue(pla.eph_v([0., 1], out=out) is out)
+        self.assertTrue(np.all(out == [r0+v0,r1+v1]))
+        self.assertRaises(ValueError, lambda: pla.eph_v([0., 1], out=np.zeros((3, 6))))
         # Testing period
         self.assertTrue(pla.period() == 3.14)
         self.assertTrue(pla.period(when = 0.) == 3.14)
@@ -257,6 +281,297 @@ class py_udplas_test(_ut.TestCase):
         rv, _ = pyspice.spkezr("JUPITER BARYCENTER", (mjd2000s-0.5)*pk.DAY2SEC, "ECLIPJ2000", "NONE", "SSB")
         self.assertTrue(np.allclose(rvpk, np.array(rv)*1000, atol=1e-13))
 
+class porkchop_test(_ut.TestCase):
+    def test_porkchop(self):
+        import pykep as pk
+        import numpy as np
+
+        earth = pk.planet(pk.udpla.jpl_lp("earth"))
+        mars = pk.planet(pk.udpla.jpl_lp("mars"))
+        t0s = np.linspace(7000., 7300., 7)
+        tofs = np.linspace(100., 400., 5)
+        dv0, dv1 = pk.porkchop(earth, mars, t0s, tofs, pk.MU_SUN)
+        self.assertTrue(dv0.shape == (7, 5))
+        self.assertTrue(dv1.shape == (7, 5))
+        r0, v_pl0 = earth.eph(t0s[3])
+        r1, v_pl1 = mars.eph(t0s[3] + tofs[2])
+        lp = pk.lambert_problem(r0, r1, tofs[2] * pk.DAY2SEC, pk.MU_SUN)
+        self.assertTrue(float_abs_error(dv0[3, 2], np.linalg.norm(np.array(lp.v0[0]) - v_pl0)) < 1e-8)
+        self.assertTrue(float_abs_error(dv1[3, 2], np.linalg.norm(np.array(lp.v1[0]) - v_pl1)) < 1e-8)
+
+class mga_test(_ut.TestCase):
+    def test_mga(self):
+        import pykep as pk
+        import numpy as np
+
+        seq = [pk.planet(pk.udpla.jpl_lp(name)) for name in ["earth", "venus", "earth", "mars"]]
+        x = [7000., 150., 300., 250.]
+        dv, dvs = pk.mga(seq, x)
+        self.assertTrue(len(dvs) == 4)
+        self.assertTrue(float_abs_error(dv, sum(dvs)) < 1e-8)
+        # The departure delta-v is that of the first leg.
+        r0, v_pl0 = seq[0].eph(x[0])
+        r1, _ = seq[1].eph(x[0] + x[1])
+        lp = pk.lambert_problem(r0, r1, x[1] * pk.DAY2SEC, pk.MU_SUN)
+        self.assertTrue(float_abs_error(dvs[0], np.linalg.norm(np.array(lp.v0[0]) - v_pl0)) < 1e-8)
+        # Batch version.
+        xs = np.array([x, [7100., 200., 250., 300.], [7200., 120., 400., 200.]])
+        dv_v, dvs_v = pk.mga_v(seq, xs)
+        self.assertTrue(dv_v.shape == (3,))
+        self.assertTrue(dvs_v.shape == (3, 4))
+        self.assertTrue(abs(dv_v[0] - dv) < 1e-6)
+        self.assertTrue(np.allclose(dvs_v[0], dvs, rtol=0., atol=1e-6))
+        dv_out, dvs_out = np.zeros(3), np.zeros((3, 4))
+        res = pk.mga_v(seq, xs, dv_out=dv_out, dvs_out=dvs_out)
+        self.assertTrue(res[0] is dv_out and res[1] is dvs_out)
+        self.assertTrue(np.all(dvs_out == dvs_v))
+        self.assertRaises(ValueError, lambda: pk.mga_v(seq, np.zeros((3, 3))))
+        self.assertRaises(ValueError, lambda: pk.mga(seq, [7000., 150., -300., 250.]))
+        # The flyby delta-v.
+        self.assertTrue(pk.fb_dv([1., 0., 0.], [np.cos(0.1), np.sin(0.1), 0.], 1., 1.) < 1e-15)
+        self.assertTrue(float_abs_error(pk.fb_dv([1., 0., 0.], [1.5, 0., 0.], 1., 1.), 0.5) < 1e-15)
+
+class lambert_test(_ut.TestCase):
+    def test_jacobians(self):
+        import pykep as pk
+        import numpy as np
+
+        r0 = [1.0, 0.1, 0.2]
+        r1 = [-0.3, 1.2, 0.1]
+        lp = pk.lambert_problem(r0=r0, r1=r1, tof=12.0, mu=1.0, multi_revs=1)
+        self.assertTrue(lp.v0_jacobian.shape == (0, 3, 7))
+        lp = pk.lambert_problem(r0=r0, r1=r1, tof=12.0, mu=1.0, multi_revs=1, jacobians=True)
+        self.assertTrue(lp.v0_jacobian.shape == (3, 3, 7))
+        self.assertTrue(lp.v1_jacobian.shape == (3, 3, 7))
+        # The derivative with respect to the time of flight, by central differences.
+        h = 1e-6
+        lpp = pk.lambert_problem(r0=r0, r1=r1, tof=12.0 + h, mu=1.0, multi_revs=1)
+        lpm = pk.lambert_problem(r0=r0, r1=r1, tof=12.0 - h, mu=1.0, multi_revs=1)
+        for i in range(3):
+            fd0 = (np.array(lpp.v0[i]) - np.array(lpm.v0[i])) / 2 / h
+            fd1 = (np.array(lpp.v1[i]) - np.array(lpm.v1[i])) / 2 / h
+            self.assertTrue(np.allclose(lp.v0_jacobian[i][:, 6], fd0, atol=1e-6))
+            self.assertTrue(np.allclose(lp.v1_jacobian[i][:, 6], fd1, atol=1e-6))
+
+    def test_warm_start(self):
+        import pykep as pk
+        import numpy as np
+
+        r0 = [1.0, 0.1, 0.2]
+        r1 = [-0.3, 1.2, 0.1]
+        lp = pk.lambert_problem(r0=r0, r1=r1, tof=12.0, mu=1.0, multi_revs=1)
+        lp_warm = pk.lambert_problem(r0=r0, r1=r1, tof=12.01, mu=1.0, multi_revs=1, x_guess=lp.x)
+        lp_cold = pk.lambert_problem(r0=r0, r1=r1, tof=12.01, mu=1.0, multi_revs=1)
+        self.assertTrue(np.allclose(lp_warm.x, lp_cold.x, atol=1e-13))
+        self.assertTrue(sum(lp_warm.iters) < sum(lp_cold.iters))
+
+    def test_solve_branch(self):
+        import pykep as pk
+
+        r0 = [1.0, 0.1, 0.2]
+        r1 = [-0.3, 1.2, 0.1]
+        lp = pk.lambert_problem(r0=r0, r1=r1, tof=12.0, mu=1.0, multi_revs=1)
+        v0, v1, x, iters = pk.lambert_solve_branch(r0, r1, 12.0, 1.0, N=1, right=True)
+        self.assertTrue(x == lp.x[2])
+        self.assertTrue(v0 == lp.v0[2])
+        self.assertTrue(v1 == lp.v1[2])
+        self.assertTrue(iters == lp.iters[2])
+        self.assertRaises(ValueError, lambda: pk.lambert_solve_branch(r0, r1, 12.0, 1.0, N=2))
+
+    def test_solve_v(self):
+        import pykep as pk
+        import numpy as np
+
+        r0s = np.array([[1.0, 0.1, 0.2], [1.0, 0.0, 0.0], [0.5, -1.2, 0.3]])
+        r1s = np.array([[-0.3, 1.2, 0.1], [0.0, 2.0, 0.0], [1.1, 0.4, -0.2]])
+        tofs = np.array([12.0, 3.0, 0.7])
+        v0s, v1s = pk.lambert_solve_v(r0s, r1s, tofs, mu=1.0)
+        self.assertTrue(v0s.shape == (3, 3))
+        for i in range(3):
+            lp = pk.lambert_problem(r0=r0s[i], r1=r1s[i], tof=tofs[i], mu=1.0)
+            self.assertTrue(np.allclose(v0s[i], lp.v0[0], rtol=1e-12, atol=1e-13))
+            self.assertTrue(np.allclose(v1s[i], lp.v1[0], rtol=1e-12, atol=1e-13))
+        # A scalar time of flight is broadcast.
+        v0s, v1s = pk.lambert_solve_v(r0s, r1s, 3.0, mu=1.0)
+        lp = pk.lambert_problem(r0=r0s[2], r1=r1s[2], tof=3.0, mu=1.0)
+        self.assertTrue(np.allclose(v0s[2], lp.v0[0], rtol=1e-12, atol=1e-13))
+        self.assertRaises(ValueError, lambda: pk.lambert_solve_v(r0s, r1s[:2], tofs))
+        self.assertRaises(ValueError, lambda: pk.lambert_solve_v(r0s, r1s, tofs[:2]))
+        self.assertRaises(ValueError, lambda: pk.lambert_solve_v(r0s, r1s, -1.0))
+        self.assertRaises(ValueError, lambda: pk.lambert_solve_v(r0s, r1s, tofs, mu=0.0))
+        # A problem with no defined direction of motion gets NaN velocities.
+        r1s_degenerate = r1s.copy()
+        r1s_degenerate[1] = [0.0, 0.0, 1.0]
+        v0s, v1s = pk.lambert_solve_v(r0s, r1s_degenerate, tofs, mu=1.0)
+        self.assertTrue(np.all(np.isnan(v0s[1])) and np.all(np.isnan(v1s[1])))
+        self.assertTrue(np.allclose(v0s[0], pk.lambert_problem(r0=r0s[0], r1=r1s[0], tof=tofs[0], mu=1.0).v0[0]))
+        # Caller-provided outputs.
+        v0s_out = np.zeros((3, 3))
+        v1s_out = np.zeros((3, 3))
+        v0s, v1s = pk.lambert_solve_v(r0s, r1s, tofs, mu=1.0, v0s_out=v0s_out, v1s_out=v1s_out)
+        self.assertTrue(v0s is v0s_out and v1s is v1s_out)
+        self.assertTrue(np.all(v0s_out == pk.lambert_solve_v(r0s, r1s, tofs, mu=1.0)[0]))
+        self.assertRaises(ValueError, lambda: pk.lambert_solve_v(r0s, r1s, tofs, v0s_out=np.zeros((2, 3))))
+        self.assertRaises(ValueError, lambda: pk.lambert_solve_v(r0s, r1s, tofs, v0s_out=np.zeros((3, 3), dtype=np.float32)))
+        self.assertRaises(ValueError, lambda: pk.lambert_solve_v(r0s, r1s, tofs, v0s_out=np.zeros((3, 3)).T))
+
+    def test_v_arrays(self):
+        import pykep as pk
+        import numpy as np
+
+        lp = pk.lambert_problem(r0=[1.0, 0.1, 0.2], r1=[-0.3, 1.2, 0.1], tof=12.0, mu=1.0, multi_revs=1)
+        v0 = lp.v0_array
+        self.assertTrue(v0.shape == (3, 3))
+        self.assertTrue(np.all(v0 == np.array(lp.v0)))
+        self.assertTrue(np.all(lp.v1_array == np.array(lp.v1)))
+        self.assertFalse(v0.flags.writeable)
+        # The view keeps the problem alive.
+        del lp
+        self.assertTrue(v0.shape == (3, 3))
+
+    def test_threads(self):
+        import pykep as pk
+        import numpy as np
+        from concurrent.futures import ThreadPoolExecutor
+
+        r0 = [1.0, 0.1, 0.2]
+        r1 = [-0.3, 1.2, 0.1]
+        tofs = np.linspace(1.0, 20.0, 64)
+        with ThreadPoolExecutor(4) as ex:
+            res = list(ex.map(lambda t: pk.lambert_problem(r0=r0, r1=r1, tof=t, mu=1.0, multi_revs=2).v0, tofs))
+        for t, v0 in zip(tofs, res):
+            self.assertTrue(v0 == pk.lambert_problem(r0=r0, r1=r1, tof=t, mu=1.0, multi_revs=2).v0)
+
+class elements_test(_ut.TestCase):
+    def test_batch(self):
+        import pykep as pk
+        import numpy as np
+
+        rvs = np.array([[1.0, 0.1, 0.0, 0.0, 1.1, 0.1], [1.0, 0.0, 0.2, 0.0, 1.5, 0.0], [1.0, 0.0, 0.0, 0.1, 0.7, 0.3]])
+        pars = pk.ic2par_v(rvs, mu=1.0)
+        self.assertTrue(pars.shape == (3, 6))
+        for i in range(3):
+            self.assertTrue(np.allclose(pars[i], pk.ic2par([rvs[i, :3], rvs[i, 3:]], 1.0), rtol=1e-13, atol=1e-13))
+        rvs_back = pk.par2ic_v(pars, mu=1.0)
+        self.assertTrue(np.allclose(rvs_back, rvs, rtol=1e-12, atol=1e-12))
+        # In place.
+        buf = rvs.copy()
+        self.assertTrue(pk.ic2par_v(buf, mu=1.0, out=buf) is buf)
+        self.assertTrue(np.all(buf == pars))
+        self.assertTrue(pk.par2ic_v(buf, mu=1.0, out=buf) is buf)
+        self.assertTrue(np.all(buf == rvs_back))
+        self.assertRaises(ValueError, lambda: pk.ic2par_v(rvs[:, :3]))
+        self.assertRaises(ValueError, lambda: pk.par2ic_v(pars, out=np.zeros((3, 6), dtype=np.float32)))
+        self.assertRaises(ValueError, lambda: pk.par2ic_v(np.array([[1.0, 1.5, 0.0, 0.0, 0.0, 0.0]])))
+
+    def test_batch_eq(self):
+        import pykep as pk
+        import numpy as np
+
+        rvs = np.array([[1.0, 0.1, 0.0, 0.0, 1.1, 0.1], [1.0, 0.0, 0.2, 0.0, 1.5, 0.0], [1.0, 0.0, 0.0, 0.1, 0.7, 0.3]])
+        for retrogade in [False, True]:
+            eqs = pk.ic2eq_v(rvs, mu=1.0, retrogade=retrogade)
+            for i in range(3):
+                self.assertTrue(np.allclose(eqs[i], pk.ic2eq([rvs[i, :3], rvs[i, 3:]], 1.0, retrogade), rtol=1e-12, atol=1e-12))
+            self.assertTrue(np.allclose(pk.eq2ic_v(eqs, mu=1.0, retrogade=retrogade), rvs, rtol=1e-11, atol=1e-11))
+            pars = pk.eq2par_v(eqs, retrogade=retrogade)
+            for i in range(3):
+                self.assertTrue(np.allclose(pars[i], pk.eq2par(eqs[i], retrogade), rtol=1e-14, atol=1e-14))
+            buf = pars.copy()
+            self.assertTrue(pk.par2eq_v(buf, retrogade=retrogade, out=buf) is buf)
+            self.assertTrue(np.allclose(buf, eqs, rtol=1e-11, atol=1e-11))
+        self.assertRaises(ValueError, lambda: pk.eq2par_v(rvs[:, :5]))
+
+class instrumentation_test(_ut.TestCase):
+    def test_snapshot(self):
+        import pykep as pk
+
+        pk.instrumentation_reset()
+        pk.m2e(0.3, 0.1)
+        pk.m2e(1.3, 0.5)
+        snap = pk.instrumentation_snapshot()
+        self.assertTrue(len(snap["iters"]["m2e"]) == 32)
+        self.assertTrue(snap["events"]["m2e_throw"] == 0)
+        if pk.instrumentation_enabled():
+            self.assertTrue(snap["iters"]["m2e"].sum() == 2)
+        else:
+            self.assertTrue(snap["iters"]["m2e"].sum() == 0)
+        pk.instrumentation_reset()
+        self.assertTrue(pk.instrumentation_snapshot()["iters"]["m2e"].sum() == 0)
+
+class propagate_test(_ut.TestCase):
+    def test_propagate_lagrangian_stm(self):
+        import pykep as pk
+        import numpy as np
+
+        rv0 = [[1.0, 0.1, 0.0], [0.0, 1.1, 0.1]]
+        rv1 = pk.propagate_lagrangian(rv=rv0, dt=3.2, mu=1.0)
+        rv1_stm, stm = pk.propagate_lagrangian(rv=rv0, dt=3.2, mu=1.0, stm=True)
+        self.assertTrue(np.all(np.array(rv1) == np.array(rv1_stm)))
+        self.assertTrue(stm.shape == (6, 6))
+        # The derivative with respect to vx0, by central differences.
+        h = 1e-6
+        rvp = pk.propagate_lagrangian(rv=[rv0[0], [h, 1.1, 0.1]], dt=3.2, mu=1.0)
+        rvm = pk.propagate_lagrangian(rv=[rv0[0], [-h, 1.1, 0.1]], dt=3.2, mu=1.0)
+        fd = (np.array(rvp).flatten() - np.array(rvm).flatten()) / 2 / h
+        self.assertTrue(np.allclose(stm[:, 3], fd, atol=1e-6))
+
+    def test_propagate_lagrangian_v(self):
+        import pykep as pk
+        import numpy as np
+        from concurrent.futures import ThreadPoolExecutor
+
+        rvs = np.array([[1.0, 0.1, 0.0, 0.0, 1.1, 0.1], [1.0, 0.0, 0.0, 0.0, 1.5, 0.0], [1.0, 0.0, 0.0, 0.1, 0.7, 0.0]])
+        dts = np.array([3.2, -1.1, 20.0])
+        rvs_f = pk.propagate_lagrangian_v(rvs, dts, mu=1.0)
+        rvs_f_stm, stms = pk.propagate_lagrangian_v(rvs, dts, mu=1.0, stm=True)
+        self.assertTrue(rvs_f.shape == (3, 6))
+        self.assertTrue(stms.shape == (3, 6, 6))
+        for i in range(3):
+            rv, stm = pk.propagate_lagrangian(rv=[rvs[i, :3], rvs[i, 3:]], dt=dts[i], mu=1.0, stm=True)
+            self.assertTrue(np.allclose(rvs_f[i], np.array(rv).flatten(), rtol=1e-12, atol=1e-13))
+            self.assertTrue(np.allclose(rvs_f_stm[i], rvs_f[i], rtol=1e-12, atol=1e-13))
+            self.assertTrue(np.allclose(stms[i], stm, rtol=1e-10, atol=1e-10))
+        # A scalar time of flight is broadcast.
+        rvs_f = pk.propagate_lagrangian_v(rvs, 3.2, mu=1.0)
+        rv = pk.propagate_lagrangian(rv=[rvs[1, :3], rvs[1, 3:]], dt=3.2, mu=1.0)
+        self.assertTrue(np.allclose(rvs_f[1], np.array(rv).flatten(), rtol=1e-12, atol=1e-13))
+        self.assertRaises(ValueError, lambda: pk.propagate_lagrangian_v(rvs[:, :3], dts))
+        self.assertRaises(ValueError, lambda: pk.propagate_lagrangian_v(rvs, dts[:2]))
+        # Concurrent calls from a thread pool.
+        with ThreadPoolExecutor(4) as ex:
+            res = list(ex.map(lambda dt: pk.propagate_lagrangian_v(rvs, dt, mu=1.0), [1.0, 2.0, 3.0, 4.0]))
+        for dt, r in zip([1.0, 2.0, 3.0, 4.0], res):
+            self.assertTrue(np.all(r == pk.propagate_lagrangian_v(rvs, dt, mu=1.0)))
+        # Caller-provided outputs, also in place.
+        out = np.zeros((3, 6))
+        stm_out = np.zeros((3, 6, 6))
+        res, res_stms = pk.propagate_lagrangian_v(rvs, dts, mu=1.0, stm=True, out=out, stm_out=stm_out)
+        self.assertTrue(res is out and res_stms is stm_out)
+        self.assertTrue(np.all(out == rvs_f_stm) and np.all(stm_out == stms))
+        rvs_copy = rvs.copy()
+        self.assertTrue(pk.propagate_lagrangian_v(rvs_copy, dts, mu=1.0, out=rvs_copy) is rvs_copy)
+        self.assertTrue(np.all(rvs_copy == rvs_f_stm))
+        self.assertRaises(ValueError, lambda: pk.propagate_lagrangian_v(rvs, dts, out=np.zeros((3, 3))))
+        self.assertRaises(ValueError, lambda: pk.propagate_lagrangian_v(rvs, dts, out=[[0.0] * 6] * 3))
+
+    def test_propagate_lagrangian_grid(self):
+        import pykep as pk
+        import numpy as np
+
+        rv = [[1.0, 0.1, 0.0], [0.0, 1.1, 0.1]]
+        dts = np.linspace(-3.0, 30.0, 200)
+        rvs = pk.propagate_lagrangian_grid(rv, dts, mu=1.0)
+        self.assertTrue(rvs.shape == (200, 6))
+        for i in [0, 17, 199]:
+            rv_f = pk.propagate_lagrangian(rv=rv, dt=dts[i], mu=1.0)
+            self.assertTrue(np.allclose(rvs[i], np.array(rv_f).flatten(), rtol=1e-12, atol=1e-13))
+        out = np.zeros((200, 6))
+        self.assertTrue(pk.propagate_lagrangian_grid(rv, dts, mu=1.0, out=out) is out)
+        self.assertTrue(np.all(out == rvs))
+        self.assertRaises(ValueError, lambda: pk.propagate_lagrangian_grid(rv, dts, out=np.zeros((199, 6))))
+        self.assertRaises(ValueError, lambda: pk.propagate_lagrangian_grid(rv, np.zeros((2, 2))))
+
 
 def run_test_suite():
     suite = _ut.TestSuite()
@@ -267,6 +582,7 @@ def run_test_suite():
     suite.addTest(anomaly_conversions_tests("test_n2f"))
     suite.addTest(anomaly_conversions_tests("test_f2h"))
     suite.addTest(anomaly_conversions_tests("test_f2zeta"))
+    suite.addTest(anomaly_conversions_tests("test_vectorized"))
     suite.addTest(planet_test("test_planet_construction"))
     suite.addTest(planet_test("test_udpla_extraction"))
     suite.addTest(planet_test("test_udpla_getters"))
@@ -275,6 +591,20 @@ def run_test_suite():
     suite.addTest(epoch_test("test_epoch_operators"))
     suite.addTest(py_udplas_test("test_tle"))
     suite.addTest(py_udplas_test("test_spice"))
+    suite.addTest(porkchop_test("test_porkchop"))
+    suite.addTest(mga_test("test_mga"))
+    suite.addTest(lambert_test("test_jacobians"))
+    suite.addTest(lambert_test("test_warm_start"))
+    suite.addTest(lambert_test("test_solve_branch"))
+    suite.addTest(lambert_test("test_solve_v"))
+    suite.addTest(lambert_test("test_threads"))
+    suite.addTest(lambert_test("test_v_arrays"))
+    suite.addTest(elements_test("test_batch"))
+    suite.addTest(elements_test("test_batch_eq"))
+    suite.addTest(propagate_test("test_propagate_lagrangian_stm"))
+    suite.addTest(propagate_test("test_propagate_lagrangian_v"))
+    suite.addTest(propagate_test("test_propagate_lagrangian_grid"))
+    suite.addTest(instrumentation_test("test_snapshot"))
 
 
 
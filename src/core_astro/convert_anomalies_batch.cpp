@@ -0,0 +1,193 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <fmt/core.h>
+
+#include <kep3/core_astro/convert_anomalies.hpp>
+#include <kep3/core_astro/convert_anomalies_batch.hpp>
+#include <kep3/detail/m2e_fixed.hpp>
+#include <kep3/detail/simd_dispatch.hpp>
+
+namespace kep3
+{
+
+namespace
+{
+
+// Number of Danby iterations in n2h_kernel(). From Mikkola's starter two are enough to reach
+// machine precision for all eccentricities, we do one more.
+constexpr unsigned n2h_n_iter = 3u;
+
+void check_sizes(const char *name, std::span<const double> x, std::span<const double> ecc, std::span<double> out)
+{
+    if (ecc.size() != x.size() || out.size() != x.size()) {
+        throw std::invalid_argument(fmt::format("{}: the input and output spans must have the same size, but the "
+                                                "sizes are {}, {} and {}",
+                                                name, x.size(), ecc.size(), out.size()));
+    }
+}
+
+// The same loop is compiled for each instruction set, W is not used.
+struct m2e_kernel {
+    template <std::size_t W>
+    kep3_SIMD_INLINE static void run(const double *x, const double *ecc, double *out, std::size_t N)
+    {
+        kep3_SIMD_LOOP
+        for (std::size_t i = 0u; i < N; ++i) {
+            out[i] = detail::m2e_fixed_kernel(x[i], ecc[i]);
+        }
+    }
+};
+
+void m2e_impl(std::span<const double> x, std::span<const double> ecc, std::span<double> out)
+{
+    // The (rare) mean anomalies too large for the reduction in the kernel are first reduced
+    // as in kep3::m2e. This is done upfront, as out may be the same span as x.
+    std::vector<std::pair<std::size_t, double>> large;
+    for (std::size_t i = 0u; i < x.size(); ++i) {
+        if (std::abs(x[i]) > detail::m2e_max_reduced_M) {
+            large.emplace_back(i, std::atan2(std::sin(x[i]), std::cos(x[i])));
+        }
+    }
+    detail::simd_dispatch<m2e_kernel, const double *, const double *, double *, std::size_t>::run(
+        x.data(), ecc.data(), out.data(), x.size());
+    for (const auto &[i, M] : large) {
+        out[i] = detail::m2e_fixed_kernel(M, ecc[i]);
+    }
+}
+
+// Solves Kepler's equation e sinhH - H = N for ecc > 1 (same scheme as detail::m2e_fixed_kernel).
+double n2h_kernel(double N, double ecc)
+{
+    if (!(ecc > 1.)) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    const double Na = std::abs(N);
+
+    // 1 - Mikkola's starter.
+    double H = kepH_starter(Na, ecc).guess;
+
+    // 2 - Danby's iterations (fourth order).
+    for (auto i = 0u; i < n2h_n_iter; ++i) {
+        const double f2 = ecc * std::sinh(H), f3 = ecc * std::cosh(H);
+        const double f = f2 - H - Na, f1 = f3 - 1.;
+        const double d1 = -f / f1;
+        const double d2 = -f / (f1 + 0.5 * d1 * f2);
+        const double d3 = -f / (f1 + 0.5 * d2 * f2 + d2 * d2 * f3 / 6.);
+        H += d3;
+    }
+    return N < 0. ? -H : H;
+}
+
+// Applies a closed-form scalar conversion (these return NaN for invalid inputs and do not throw).
+template <double (*F)(double, double)>
+void apply(std::span<const double> x, std::span<const double> ecc, std::span<double> out)
+{
+    for (std::size_t i = 0u; i < x.size(); ++i) {
+        out[i] = F(x[i], ecc[i]);
+    }
+}
+
+} // namespace
+
+void m2e_batch(std::span<const double> x, std::span<const double> ecc, std::span<double> out)
+{
+    check_sizes("m2e_batch", x, ecc, out);
+    m2e_impl(x, ecc, out);
+}
+
+void e2m_batch(std::span<const double> x, std::span<const double> ecc, std::span<double> out)
+{
+    check_sizes("e2m_batch", x, ecc, out);
+    apply<&e2m>(x, ecc, out);
+}
+
+void m2f_batch(std::span<const double> x, std::span<const double> ecc, std::span<double> out)
+{
+    check_sizes("m2f_batch", x, ecc, out);
+    m2e_impl(x, ecc, out);
+    apply<&e2f>(out, ecc, out);
+}
+
+void f2m_batch(std::span<const double> x, std::span<const double> ecc, std::span<double> out)
+{
+    check_sizes("f2m_batch", x, ecc, out);
+    apply<&f2m>(x, ecc, out);
+}
+
+void e2f_batch(std::span<const double> x, std::span<const double> ecc, std::span<double> out)
+{
+    check_sizes("e2f_batch", x, ecc, out);
+    apply<&e2f>(x, ecc, out);
+}
+
+void f2e_batch(std::span<const double> x, std::span<const double> ecc, std::span<double> out)
+{
+    check_sizes("f2e_batch", x, ecc, out);
+    apply<&f2e>(x, ecc, out);
+}
+
+void n2h_batch(std::span<const double> x, std::span<const double> ecc, std::span<double> out)
+{
+    check_sizes("n2h_batch", x, ecc, out);
+    apply<&n2h_kernel>(x, ecc, out);
+}
+
+void h2n_batch(std::span<const double> x, std::span<const double> ecc, std::span<double> out)
+{
+    check_sizes("h2n_batch", x, ecc, out);
+    apply<&h2n>(x, ecc, out);
+}
+
+void n2f_batch(std::span<const double> x, std::span<const double> ecc, std::span<double> out)
+{
+    check_sizes("n2f_batch", x, ecc, out);
+    apply<&n2h_kernel>(x, ecc, out);
+    apply<&h2f>(out, ecc, out);
+}
+
+void f2n_batch(std::span<const double> x, std::span<const double> ecc, std::span<double> out)
+{
+    check_sizes("f2n_batch", x, ecc, out);
+    apply<&f2n>(x, ecc, out);
+}
+
+void h2f_batch(std::span<const double> x, std::span<const double> ecc, std::span<double> out)
+{
+    check_sizes("h2f_batch", x, ecc, out);
+    apply<&h2f>(x, ecc, out);
+}
+
+void f2h_batch(std::span<const double> x, std::span<const double> ecc, std::span<double> out)
+{
+    check_sizes("f2h_batch", x, ecc, out);
+    apply<&f2h>(x, ecc, out);
+}
+
+void zeta2f_batch(std::span<const double> x, std::span<const double> ecc, std::span<double> out)
+{
+    check_sizes("zeta2f_batch", x, ecc, out);
+    apply<&zeta2f>(x, ecc, out);
+}
+
+void f2zeta_batch(std::span<const double> x, std::span<const double> ecc, std::span<double> out)
+{
+    check_sizes("f2zeta_batch", x, ecc, out);
+    apply<&f2zeta>(x, ecc, out);
+}
+
+} // namespace kep3
@@ -0,0 +1,337 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <span>
+#include <stdexcept>
+
+#include <fmt/core.h>
+
+#include <kep3/core_astro/constants.hpp>
+#include <kep3/core_astro/elements_batch.hpp>
+#include <kep3/detail/simd_dispatch.hpp>
+
+namespace kep3
+{
+
+namespace
+{
+
+// The conversions are run on blocks of this many entries: the arithmetic of a block is done in one
+// (vectorised) loop, the trigonometric functions, which are not vectorised, in a separate one.
+constexpr std::size_t block_size = 128u;
+
+void elements_batch_check_sizes(const char *name, const elements_batch_input &in, const elements_batch_output &out)
+{
+    const auto N = in[0].size();
+    bool ok = true;
+    for (auto j = 0u; j < 6u; ++j) {
+        ok = ok && in[j].size() == N && out[j].size() == N;
+    }
+    if (!ok) {
+        throw std::invalid_argument(
+            fmt::format("{}: all the input and output spans must have the same size as the first one ({})", name, N));
+    }
+}
+
+// Calls block(i0, n) for the consecutive blocks [i0, i0 + n) of a batch of size N.
+template <typename F>
+void for_each_block(std::size_t N, const F &block)
+{
+    for (std::size_t i0 = 0u; i0 < N; i0 += block_size) {
+        block(i0, std::min(block_size, N - i0));
+    }
+}
+
+// The pointers to the entries [i0, i0 + block_size) of the six spans.
+std::array<const double *, 6> block_ptrs(const elements_batch_input &in, std::size_t i0)
+{
+    return {in[0].data() + i0, in[1].data() + i0, in[2].data() + i0,
+            in[3].data() + i0, in[4].data() + i0, in[5].data() + i0};
+}
+
+std::array<double *, 6> block_ptrs(const elements_batch_output &out, std::size_t i0)
+{
+    return {out[0].data() + i0, out[1].data() + i0, out[2].data() + i0,
+            out[3].data() + i0, out[4].data() + i0, out[5].data() + i0};
+}
+
+// NOTE: in all the kernels, the inputs of an entry are read before its outputs are written, so that
+// the output may be the input.
+
+void ic2par_block(const elements_batch_input &pos_vel, double mu, const elements_batch_output &par, std::size_t i0,
+                  std::size_t n)
+{
+    const auto [x, y, z, vx, vy, vz] = block_ptrs(pos_vel, i0);
+    const auto [sma, ecc, inc, omg, omp, f] = block_ptrs(par, i0);
+    // The cosines of the angles, and whether (1.) or not (0.) they are in [pi, 2pi].
+    std::array<double, block_size> cos_i{}, cos_W{}, cos_w{}, cos_f{}, flip_W{}, flip_w{}, flip_f{};
+
+    kep3_SIMD_LOOP
+    for (std::size_t l = 0u; l < n; ++l) {
+        const double rx = x[l], ry = y[l], rz = z[l], vx0 = vx[l], vy0 = vy[l], vz0 = vz[l];
+        // The orbital angular momentum h = r0 x v0 and the parameter p = h^2 / mu.
+        const double hx = ry * vz0 - rz * vy0, hy = rz * vx0 - rx * vz0, hz = rx * vy0 - ry * vx0;
+        const double h2 = hx * hx + hy * hy + hz * hz;
+        const double p = h2 / mu;
+        // The node line n = (k x h) / |k x h|, singular for zero inclination.
+        const double nn = std::sqrt(hy * hy + hx * hx);
+        const double nx = -hy / nn, ny = hx / nn;
+        // The eccentricity vector e = (v0 x h) / mu - r0 / R0.
+        const double R0 = std::sqrt(rx * rx + ry * ry + rz * rz);
+        const double ex = (vy0 * hz - vz0 * hy) / mu - rx / R0;
+        const double ey = (vz0 * hx - vx0 * hz) / mu - ry / R0;
+        const double ez = (vx0 * hy - vy0 * hx) / mu - rz / R0;
+        const double e = std::sqrt(ex * ex + ey * ey + ez * ez);
+
+        cos_i[l] = hz / std::sqrt(h2);
+        cos_W[l] = nx;
+        flip_W[l] = (ny < 0.) ? 1. : 0.;
+        cos_w[l] = (nx * ex + ny * ey) / e;
+        flip_w[l] = (ez < 0.) ? 1. : 0.;
+        cos_f[l] = (ex * rx + ey * ry + ez * rz) / e / R0;
+        flip_f[l] = ((rx * vx0 + ry * vy0 + rz * vz0) < 0.) ? 1. : 0.;
+
+        sma[l] = p / (1. - e * e);
+        ecc[l] = e;
+    }
+    for (std::size_t l = 0u; l < n; ++l) {
+        inc[l] = std::acos(cos_i[l]);
+        const double W = std::acos(cos_W[l]), w = std::acos(cos_w[l]), nu = std::acos(cos_f[l]);
+        omg[l] = (flip_W[l] != 0.) ? 2 * pi - W : W;
+        omp[l] = (flip_w[l] != 0.) ? 2 * pi - w : w;
+        f[l] = (flip_f[l] != 0.) ? 2 * pi - nu : nu;
+    }
+}
+
+void par2ic_block(const elements_batch_input &par, double mu, const elements_batch_output &pos_vel, std::size_t i0,
+                  std::size_t n)
+{
+    const auto [sma, ecc, inc, omg, omp, f] = block_ptrs(par, i0);
+    const auto [x, y, z, vx, vy, vz] = block_ptrs(pos_vel, i0);
+    std::array<double, block_size> cosf{}, sinf{}, cosomg{}, sinomg{}, cosomp{}, sinomp{}, cosi{}, sini{};
+
+    for (std::size_t l = 0u; l < n; ++l) {
+        if (sma[l] * (1 - ecc[l]) < 0) {
+            throw std::domain_error(fmt::format("par2ic_batch was called with ecc and sma not compatible "
+                                                "with the convention a<0 -> e>1 [a>0 -> e<1] (entry {}).",
+                                                i0 + l));
+        }
+        cosf[l] = std::cos(f[l]);
+        if (ecc[l] > 1 && cosf[l] < -1 / ecc[l]) {
+            throw std::domain_error(fmt::format("par2ic_batch was called for an hyperbola but the true "
+                                                "anomaly is beyond asymptotes (cosf<-1/e) (entry {}).",
+                                                i0 + l));
+        }
+        sinf[l] = std::sin(f[l]);
+        cosomg[l] = std::cos(omg[l]);
+        sinomg[l] = std::sin(omg[l]);
+        cosomp[l] = std::cos(omp[l]);
+        sinomp[l] = std::sin(omp[l]);
+        cosi[l] = std::cos(inc[l]);
+        sini[l] = std::sin(inc[l]);
+    }
+
+    kep3_SIMD_LOOP
+    for (std::size_t l = 0u; l < n; ++l) {
+        const double e = ecc[l];
+        // Position and velocity in the perifocal reference frame.
+        const double p = sma[l] * (1.0 - e * e);
+        const double r = p / (1.0 + e * cosf[l]);
+        const double h = std::sqrt(p * mu);
+        const double x_per = r * cosf[l], y_per = r * sinf[l];
+        const double xdot_per = -mu / h * sinf[l], ydot_per = mu / h * (e + cosf[l]);
+        // The first two columns of the rotation matrix from the perifocal to the inertial frame.
+        const double R00 = cosomg[l] * cosomp[l] - sinomg[l] * sinomp[l] * cosi[l];
+        const double R01 = -cosomg[l] * sinomp[l] - sinomg[l] * cosomp[l] * cosi[l];
+        const double R10 = sinomg[l] * cosomp[l] + cosomg[l] * sinomp[l] * cosi[l];
+        const double R11 = -sinomg[l] * sinomp[l] + cosomg[l] * cosomp[l] * cosi[l];
+        const double R20 = sinomp[l] * sini[l], R21 = cosomp[l] * sini[l];
+
+        x[l] = R00 * x_per + R01 * y_per;
+        y[l] = R10 * x_per + R11 * y_per;
+        z[l] = R20 * x_per + R21 * y_per;
+        vx[l] = R00 * xdot_per + R01 * ydot_per;
+        vy[l] = R10 * xdot_per + R11 * ydot_per;
+        vz[l] = R20 * xdot_per + R21 * ydot_per;
+    }
+}
+
+void ic2eq_block(const elements_batch_input &pos_vel, double mu, double I, const elements_batch_output &eq,
+                 std::size_t i0, std::size_t n)
+{
+    const auto [x, y, z, vx, vy, vz] = block_ptrs(pos_vel, i0);
+    const auto [p, f, g, h, k, L] = block_ptrs(eq, i0);
+    // The coordinates of the position in the equinoctial frame, divided by R0.
+    std::array<double, block_size> X{}, Y{};
+
+    kep3_SIMD_LOOP
+    for (std::size_t l = 0u; l < n; ++l) {
+        const double rx = x[l], ry = y[l], rz = z[l], vx0 = vx[l], vy0 = vy[l], vz0 = vz[l];
+        // The semi-major axis.
+        const double R0 = std::sqrt(rx * rx + ry * ry + rz * rz);
+        const double V0 = std::sqrt(vx0 * vx0 + vy0 * vy0 + vz0 * vz0);
+        const double a = 1. / (2. / R0 - V0 * V0 / mu);
+        // The angular momentum and its direction w.
+        const double ax = ry * vz0 - rz * vy0, ay = rz * vx0 - rx * vz0, az = rx * vy0 - ry * vx0;
+        const double an = std::sqrt(ax * ax + ay * ay + az * az);
+        const double wx = ax / an, wy = ay / an, wz = az / an;
+        // The equinoctial frame.
+        const double kk = wx / (1. + I * wz);
+        const double hh = -wy / (1. + I * wz);
+        const double den = kk * kk + hh * hh + 1;
+        const double fx = (1. - kk * kk + hh * hh) / den, fy = (2. * kk * hh) / den, fz = (-2. * I * kk) / den;
+        const double gx = (2. * I * kk * hh) / den, gy = (1. + kk * kk - hh * hh) * I / den, gz = (2. * hh) / den;
+        // The eccentricity vector e = (v0 x h) / mu - r0 / R0.
+        const double ex = (vy0 * az - vz0 * ay) / mu - rx / R0;
+        const double ey = (vz0 * ax - vx0 * az) / mu - ry / R0;
+        const double ez = (vx0 * ay - vy0 * ax) / mu - rz / R0;
+        const double ecc = std::sqrt(ex * ex + ey * ey + ez * ez);
+        // The coordinates of r0 in the equinoctial frame, from the best conditioned pair of its components.
+        // NOTE: the comparisons are combined with & rather than &&, so that the selection has no branches.
+        const double det1 = gy * fx - fy * gx, det2 = gz * fx - fz * gx, det3 = gz * fy - fz * gy;
+        const double ad1 = std::abs(det1), ad2 = std::abs(det2), ad3 = std::abs(det3);
+        const bool use1 = (ad1 >= ad2) & (ad1 >= ad3), use2 = !use1 & (ad2 >= ad3);
+        const double X1 = (gy * rx - gx * ry) / det1, Y1 = (-fy * rx + fx * ry) / det1;
+        const double X2 = (gz * rx - gx * rz) / det2, Y2 = (-fz * rx + fx * rz) / det2;
+        const double X3 = (gz * ry - gy * rz) / det3, Y3 = (-fz * ry + fy * rz) / det3;
+        X[l] = (use1 ? X1 : (use2 ? X2 : X3)) / R0;
+        Y[l] = (use1 ? Y1 : (use2 ? Y2 : Y3)) / R0;
+
+        p[l] = a * (1. - ecc * ecc);
+        f[l] = ex * fx + ey * fy + ez * fz;
+        g[l] = ex * gx + ey * gy + ez * gz;
+        h[l] = hh;
+        k[l] = kk;
+    }
+    for (std::size_t l = 0u; l < n; ++l) {
+        L[l] = std::atan2(Y[l], X[l]);
+    }
+}
+
+void eq2ic_block(const elements_batch_input &eq, double mu, double I, const elements_batch_output &pos_vel,
+                 std::size_t i0, std::size_t n)
+{
+    const auto [p, f, g, h, k, L] = block_ptrs(eq, i0);
+    const auto [x, y, z, vx, vy, vz] = block_ptrs(pos_vel, i0);
+    std::array<double, block_size> cosL{}, sinL{};
+
+    for (std::size_t l = 0u; l < n; ++l) {
+        cosL[l] = std::cos(L[l]);
+        sinL[l] = std::sin(L[l]);
+    }
+
+    kep3_SIMD_LOOP
+    for (std::size_t l = 0u; l < n; ++l) {
+        // p = a (1-e^2) is negative for hyperbolae, here we need a positive number.
+        const double par = std::abs(p[l]);
+        const double f0 = f[l], g0 = g[l], h0 = h[l], k0 = k[l];
+        // The equinoctial reference frame.
+        const double den = k0 * k0 + h0 * h0 + 1;
+        const double fx = (1 - k0 * k0 + h0 * h0) / den, fy = (2 * k0 * h0) / den, fz = (-2 * I * k0) / den;
+        const double gx = (2 * I * k0 * h0) / den, gy = (1 + k0 * k0 - h0 * h0) * I / den, gz = (2 * h0) / den;
+        // Position and velocity in the equinoctial reference frame.
+        const double radius = par / (1 + g0 * sinL[l] + f0 * cosL[l]);
+        const double X = radius * cosL[l], Y = radius * sinL[l];
+        const double VX = -std::sqrt(mu / par) * (g0 + sinL[l]), VY = std::sqrt(mu / par) * (f0 + cosL[l]);
+
+        x[l] = X * fx + Y * gx;
+        y[l] = X * fy + Y * gy;
+        z[l] = X * fz + Y * gz;
+        vx[l] = VX * fx + VY * gx;
+        vy[l] = VX * fy + VY * gy;
+        vz[l] = VX * fz + VY * gz;
+    }
+}
+
+} // namespace
+
+void ic2par_batch(const elements_batch_input &pos_vel, double mu, const elements_batch_output &par)
+{
+    elements_batch_check_sizes("ic2par_batch", pos_vel, par);
+    for_each_block(pos_vel[0].size(), [&](std::size_t i0, std::size_t n) { ic2par_block(pos_vel, mu, par, i0, n); });
+}
+
+void par2ic_batch(const elements_batch_input &par, double mu, const elements_batch_output &pos_vel)
+{
+    elements_batch_check_sizes("par2ic_batch", par, pos_vel);
+    for_each_block(par[0].size(), [&](std::size_t i0, std::size_t n) { par2ic_block(par, mu, pos_vel, i0, n); });
+}
+
+void ic2eq_batch(const elements_batch_input &pos_vel, double mu, bool retrogade, const elements_batch_output &eq)
+{
+    elements_batch_check_sizes("ic2eq_batch", pos_vel, eq);
+    const double I = retrogade ? -1. : 1.;
+    for_each_block(pos_vel[0].size(), [&](std::size_t i0, std::size_t n) { ic2eq_block(pos_vel, mu, I, eq, i0, n); });
+}
+
+void eq2ic_batch(const elements_batch_input &eq, double mu, bool retrogade, const elements_batch_output &pos_vel)
+{
+    elements_batch_check_sizes("eq2ic_batch", eq, pos_vel);
+    const double I = retrogade ? -1. : 1.;
+    for_each_block(eq[0].size(), [&](std::size_t i0, std::size_t n) { eq2ic_block(eq, mu, I, pos_vel, i0, n); });
+}
+
+// The conversions between Keplerian and equinoctial elements are mostly trigonometry, their
+// loops are not split.
+void par2eq_batch(const elements_batch_input &par, bool retrogade, const elements_batch_output &eq)
+{
+    elements_batch_check_sizes("par2eq_batch", par, eq);
+    const double I = retrogade ? -1. : 1.;
+    const auto [sma, ecc, inc, omg, omp, f] = block_ptrs(par, 0u);
+    const auto [p, ef, eg, h, k, L] = block_ptrs(eq, 0u);
+    for (std::size_t i = 0u; i < par[0].size(); ++i) {
+        const double t = retrogade ? 1. / std::tan(inc[i] / 2) : std::tan(inc[i] / 2);
+        const double e = ecc[i], W = omg[i], w = omp[i], nu = f[i];
+        p[i] = sma[i] * (1 - e * e);
+        ef[i] = e * std::cos(w + I * W);
+        eg[i] = e * std::sin(w + I * W);
+        h[i] = t * std::cos(W);
+        k[i] = t * std::sin(W);
+        L[i] = nu + w + I * W;
+    }
+}
+
+void eq2par_batch(const elements_batch_input &eq, bool retrogade, const elements_batch_output &par)
+{
+    elements_batch_check_sizes("eq2par_batch", eq, par);
+    const double I = retrogade ? -1. : 1.;
+    const auto [p, ef, eg, h, k, L] = block_ptrs(eq, 0u);
+    const auto [sma, ecc, inc, omg, omp, f] = block_ptrs(par, 0u);
+    for (std::size_t i = 0u; i < eq[0].size(); ++i) {
+        const double e = std::sqrt(ef[i] * ef[i] + eg[i] * eg[i]);
+        const double tmp = std::sqrt(h[i] * h[i] + k[i] * k[i]);
+        double zita = std::atan2(eg[i] / e, ef[i] / e); // [-pi, pi]
+        if (zita < 0) {
+            zita += 2 * pi; // [0, 2*pi]
+        }
+        double W = std::atan2(k[i] / tmp, h[i] / tmp); // [-pi, pi]
+        if (W < 0) {
+            W += 2 * pi; // [0, 2*pi]
+        }
+        double w = zita - I * W;
+        if (w < 0) {
+            w += 2 * pi;
+        } else if (w > 2 * pi) {
+            w -= 2 * pi;
+        }
+        const double Lv = L[i];
+        sma[i] = p[i] / (1. - e * e);
+        ecc[i] = e;
+        inc[i] = half_pi * (1. - I) + 2. * I * std::atan(tmp);
+        omg[i] = W;
+        omp[i] = w;
+        f[i] = Lv - I * W - w;
+    }
+}
+
+} // namespace kep3
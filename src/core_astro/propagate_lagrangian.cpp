@@ -8,8 +8,10 @@
 // with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
 
 #include "kep3/core_astro/ic2par2ic.hpp"
+#include <algorithm>
 #include <array>
 #include <cmath>
+#include <span>
 #include <stdexcept>
 
 #include <boost/math/tools/roots.hpp>
@@ -20,27 +22,53 @@
 #include <kep3/core_astro/kepler_equations.hpp>
 #include <kep3/core_astro/propagate_lagrangian.hpp>
 #include <kep3/core_astro/special_functions.hpp>
+#include <kep3/detail/lagrangian_stm.hpp>
+#include <kep3/instrumentation.hpp>
 
 namespace kep3
 {
 
-/// Lagrangian propagation
-/**
- * This function propagates an initial Cartesian state for a time t assuming a
- * central body and a keplerian motion. Lagrange coefficients are used as basic
- * numerical technique. All units systems can be used, as long
- * as the input parameters are all expressed in the same system.
- */
-void propagate_lagrangian(std::array<std::array<double, 3>, 2> &pos_vel_0, const double dt, const double mu)
+namespace
 {
-    auto &[r0, v0] = pos_vel_0;
+
+// The Lagrange coefficients of a Keplerian propagation, together with the semi-major axis, the
+// anomaly difference x (DE or DH, including the full revolutions) and its cos and sin (cosh and sinh).
+struct lagrange_coefficients {
+    double F, G, Ft, Gt;
+    double a, x, C, S;
+};
+
+// The quantities of the initial state entering Kepler's equation, which do not depend on dt.
+struct lagrange_invariants {
+    double R, sigma0, a;
+};
+
+lagrange_invariants lagrangian_invariants(const std::array<std::array<double, 3>, 2> &pos_vel_0, const double mu)
+{
+    const auto &[r0, v0] = pos_vel_0;
     double R = std::sqrt(r0[0] * r0[0] + r0[1] * r0[1] + r0[2] * r0[2]);
     double V = std::sqrt(v0[0] * v0[0] + v0[1] * v0[1] + v0[2] * v0[2]);
     double energy = (V * V / 2 - mu / R);
     double a = -mu / 2.0 / energy; // will be negative for hyperbolae
-    double sqrta = 0.;
-    double F = 0., G = 0., Ft = 0., Gt = 0.;
     double sigma0 = (r0[0] * v0[0] + r0[1] * v0[1] + r0[2] * v0[2]) / std::sqrt(mu);
+    return {R, sigma0, a};
+}
+
+// A previous solution of Kepler's equation for the same initial state: the time dt and the anomaly
+// difference x returned in lagrange_coefficients. It is used to warm start the solution at a nearby time.
+struct lagrange_warm_start {
+    double dt, x;
+};
+
+// The largest change of the mean anomaly (DM or DN) for which the warm start is used.
+constexpr double warm_start_max_step = 0.5;
+
+lagrange_coefficients lagrangian_coefficients(const lagrange_invariants &inv, const double dt, const double mu,
+                                              const lagrange_warm_start *warm = nullptr)
+{
+    const double R = inv.R, sigma0 = inv.sigma0, a = inv.a;
+    double sqrta = 0.;
+    double F = 0., G = 0., Ft = 0., Gt = 0., x = 0., C = 0., S = 0.;
 
     if (a > 0) { // Solve Kepler's equation in DE, elliptical case
         sqrta = std::sqrt(a);
@@ -62,6 +90,13 @@ void propagate_lagrangian(std::array<std::array<double, 3>, 2> &pos_vel_0, const
                     + 0.5 * (c0 * sinDM + s0 * cosDM - s0)
                           * (2 * std::pow(c0 * cosDM - s0 * sinDM, 2)
                              - (c0 * sinDM + s0 * cosDM - s0) * (c0 * sinDM + s0 * cosDM));
+        if (warm != nullptr) {
+            // Close to a previous solution, a first order step from it (cropped as DM) is a better guess.
+            const double DM_warm = std::sqrt(mu / std::pow(a, 3)) * warm->dt;
+            if (std::abs(DM - DM_warm) < warm_start_max_step) {
+                IG = warm->x + (DM - DM_warm) / d_kepDE(warm->x, sigma0, sqrta, a, R) - (DM - DM_cropped);
+            }
+        }
 
         // Solve Kepler Equation for ellipses in DE (eccentric anomaly difference)
         const int digits = std::numeric_limits<double>::digits;
@@ -74,12 +109,18 @@ void propagate_lagrangian(std::array<std::array<double, 3>, 2> &pos_vel_0, const
                 return std::make_tuple(kepDE(DE, DM_cropped, sigma0, sqrta, a, R), d_kepDE(DE, sigma0, sqrta, a, R));
             },
             IG, IG - pi, IG + pi, digits, max_iter);
+        instrumentation::record_iters(instrumentation::solver::propagate_lagrangian_elliptic, max_iter);
         if (max_iter == 100u) {
+            instrumentation::record_event(instrumentation::event::propagate_lagrangian_throw);
             throw std::domain_error(fmt::format("Maximum number of iterations exceeded when solving Kepler's "
                                                 "equation for the eccentric anomaly in propagate_lagrangian.\n"
                                                 "DM={}\nsigma0={}\nsqrta={}\na={}\nR={}\nDE={}",
                                                 DM, sigma0, sqrta, a, R, DE));
         }
+        // The full revolutions removed by the cropping are added back to DE.
+        x = DE + (DM - DM_cropped);
+        C = std::cos(DE);
+        S = std::sin(DE);
         double r = a + (R - a) * std::cos(DE) + sigma0 * sqrta * std::sin(DE);
 
         // Lagrange coefficients
@@ -90,10 +131,14 @@ void propagate_lagrangian(std::array<std::array<double, 3>, 2> &pos_vel_0, const
     } else { // Solve Kepler's equation in DH, hyperbolic case
         sqrta = std::sqrt(-a);
         double DN = std::sqrt(-mu / a / a / a) * dt;
-        double IG = 0.;
-        dt > 0. ? IG = 1. : IG = -1.; // TODO(darioizzo): find a better initial guess.
-                                      // I tried with 0 and DN (both have numercial
-                                      // problems and result in exceptions)
+        const auto [guess, lb, ub] = kepDH_starter(DN, sigma0 / sqrta, 1 - R / a);
+        double IG = guess;
+        if (warm != nullptr) {
+            const double DN_warm = std::sqrt(-mu / a / a / a) * warm->dt;
+            if (std::abs(DN - DN_warm) < warm_start_max_step) {
+                IG = std::clamp(warm->x + (DN - DN_warm) / d_kepDH(warm->x, sigma0, sqrta, a, R), lb, ub);
+            }
+        }
 
         // Solve Kepler Equation for ellipses in DH (hyperbolic anomaly difference)
         const int digits = std::numeric_limits<double>::digits;
@@ -104,16 +149,19 @@ void propagate_lagrangian(std::array<std::array<double, 3>, 2> &pos_vel_0, const
             [DN, sigma0, sqrta, a, R](double DH) {
                 return std::make_tuple(kepDH(DH, DN, sigma0, sqrta, a, R), d_kepDH(DH, sigma0, sqrta, a, R));
             },
-            IG, IG - 50, IG + 50, digits,
-            max_iter); // TODO (dario): study this hyperbolic equation in more
-                       // details as to provide decent and well proved bounds
+            IG, lb, ub, digits, max_iter);
+        instrumentation::record_iters(instrumentation::solver::propagate_lagrangian_hyperbolic, max_iter);
         if (max_iter == 100u) {
+            instrumentation::record_event(instrumentation::event::propagate_lagrangian_throw);
             throw std::domain_error(fmt::format("Maximum number of iterations exceeded when solving Kepler's "
                                                 "equation for the hyperbolic anomaly in propagate_lagrangian.\n"
                                                 "DN={}\nsigma0={}\nsqrta={}\na={}\nR={}\nDH={}",
                                                 DN, sigma0, sqrta, a, R, DH));
         }
 
+        x = DH;
+        C = std::cosh(DH);
+        S = std::sinh(DH);
         double r = a + (R - a) * std::cosh(DH) + sigma0 * sqrta * std::sinh(DH);
 
         // Lagrange coefficients
@@ -123,6 +171,23 @@ void propagate_lagrangian(std::array<std::array<double, 3>, 2> &pos_vel_0, const
         Gt = 1. - a / r * (1. - std::cosh(DH));
     }
 
+    return {F, G, Ft, Gt, a, x, C, S};
+}
+
+} // namespace
+
+/// Lagrangian propagation
+/**
+ * This function propagates an initial Cartesian state for a time t assuming a
+ * central body and a keplerian motion. Lagrange coefficients are used as basic
+ * numerical technique. All units systems can be used, as long
+ * as the input parameters are all expressed in the same system.
+ */
+void propagate_lagrangian(std::array<std::array<double, 3>, 2> &pos_vel_0, const double dt, const double mu)
+{
+    auto &[r0, v0] = pos_vel_0;
+    const auto [F, G, Ft, Gt, a, x, C, S] = lagrangian_coefficients(lagrangian_invariants(pos_vel_0, mu), dt, mu);
+
     double temp[3] = {r0[0], r0[1], r0[2]};
     for (auto i = 0u; i < 3; i++) {
         r0[i] = F * r0[i] + G * v0[i];
@@ -130,6 +195,59 @@ void propagate_lagrangian(std::array<std::array<double, 3>, 2> &pos_vel_0, const
     }
 }
 
+/// Lagrangian propagation with state transition matrix
+/**
+ * As kep3::propagate_lagrangian, also returning the state transition matrix of the propagation,
+ * that is the derivative of the final state with respect to the initial state (row major).
+ * It is computed analytically from the Lagrange coefficients (Battin, Section 9.7).
+ */
+std::array<double, 36> propagate_lagrangian_stm(std::array<std::array<double, 3>, 2> &pos_vel_0, const double dt,
+                                                const double mu)
+{
+    const auto [r0, v0] = pos_vel_0;
+    const auto [F, G, Ft, Gt, a, x, C, S] = lagrangian_coefficients(lagrangian_invariants(pos_vel_0, mu), dt, mu);
+
+    auto &[r, v] = pos_vel_0;
+    for (auto i = 0u; i < 3; i++) {
+        r[i] = F * r0[i] + G * v0[i];
+        v[i] = Ft * r0[i] + Gt * v0[i];
+    }
+    std::array<double, 36> retval{};
+    kep3::detail::lagrangian_stm(r0, v0, r, v, F, G, Ft, Gt, kep3::detail::battin_c(a, x, C, S, dt, mu), mu,
+                                 retval.data());
+    return retval;
+}
+
+/// Lagrangian propagation to many times
+/**
+ * As kep3::propagate_lagrangian, for each of the times of flight in dts, writing the final states
+ * to the rows of out ([x, y, z, vx, vy, vz], row major). The quantities of the initial state are
+ * computed once, and each solution of Kepler's equation is warm started from the previous one.
+ */
+void propagate_lagrangian_grid(const std::array<std::array<double, 3>, 2> &pos_vel, std::span<const double> dts,
+                               const double mu, std::span<double> out)
+{
+    if (out.size() != 6u * dts.size()) {
+        throw std::invalid_argument(
+            fmt::format("Invalid output size in propagate_lagrangian_grid: {} values were expected (6 per time), "
+                        "but {} were provided",
+                        6u * dts.size(), out.size()));
+    }
+    // NOTE: copies, so that out may overlap pos_vel.
+    const auto [r0, v0] = pos_vel;
+    const auto inv = lagrangian_invariants(pos_vel, mu);
+    lagrange_warm_start warm{};
+    for (decltype(dts.size()) i = 0u; i < dts.size(); ++i) {
+        const auto [F, G, Ft, Gt, a, x, C, S] = lagrangian_coefficients(inv, dts[i], mu, i == 0u ? nullptr : &warm);
+        warm = {dts[i], x};
+        double *row = out.data() + 6u * i;
+        for (auto j = 0u; j < 3u; ++j) {
+            row[j] = F * r0[j] + G * v0[j];
+            row[3u + j] = Ft * r0[j] + Gt * v0[j];
+        }
+    }
+}
+
 /// Universial Variables version
 /**
  * This function has the same prototype as kep3::propagate_lgrangian, but
@@ -159,11 +277,25 @@ void propagate_lagrangian_u(std::array<std::array<double, 3>, 2> &pos_vel_0, con
     // initial radial velocity
     double VR0 = (r0[0] * v0[0] + r0[1] * v0[1] + r0[2] * v0[2]) / R0;
 
+    const double sqrt_mu = std::sqrt(mu);
+    const double sigma0 = R0 * VR0 / sqrt_mu;
+
     // solve kepler's equation in the universal anomaly DS
-    double IG = 0;
-    alpha > 0. ? IG = std::sqrt(mu) * dt_copy * std::abs(alpha)
-               : IG = 3.; // TODO(darioizzo): initial guess for the universal
-                          // anomaly. For hyperbolas is 3 .... can be better?
+    double IG = 3., lb = IG - 2 * pi, ub = IG + 2 * pi;
+    if (alpha > 0.) {
+        IG = sqrt_mu * dt_copy * alpha;
+        // limiting the IG error within only pi will not work.
+        lb = IG - 2 * pi;
+        ub = IG + 2 * pi;
+    } else if (alpha < 0.) {
+        // For hyperbolas DS = sqrt(-a) DH: the starter of Kepler's equation in DH is used.
+        const double sqrta = std::sqrt(-1. / alpha);
+        const double DN = std::sqrt(-mu * alpha * alpha * alpha) * dt_copy;
+        const auto start = kepDH_starter(DN, sigma0 / sqrta, 1 - alpha * R0);
+        IG = sqrta * start.guess;
+        lb = sqrta * start.lb;
+        ub = sqrta * start.ub;
+    }
 
     // Solve Kepler Equation in DS (univrsal anomaly difference)
     const int digits = std::numeric_limits<double>::digits;
@@ -171,23 +303,22 @@ void propagate_lagrangian_u(std::array<std::array<double, 3>, 2> &pos_vel_0, con
     // NOTE: Halley iterates may result into instabilities (specially with a poor
     // IG)
     double DS = boost::math::tools::newton_raphson_iterate(
-        [dt_copy, R0, VR0, alpha, mu](double DS) {
-            return std::make_tuple(kepDS(DS, dt_copy, R0, VR0, alpha, mu), d_kepDS(DS, R0, VR0, alpha, mu));
+        [dt_copy, R0, sigma0, alpha, sqrt_mu](double DS) {
+            const auto [f, df] = kepDS_d_kepDS(DS, dt_copy, R0, sigma0, alpha, sqrt_mu);
+            return std::make_tuple(f, df);
         },
-        IG, IG - 2 * pi, IG + 2 * pi, digits,
-        max_iter); // limiting the IG error within
-                   // only pi will not work.
+        IG, lb, ub, digits, max_iter);
+    instrumentation::record_iters(instrumentation::solver::propagate_lagrangian_u, max_iter);
     if (max_iter == 100u) {
+        instrumentation::record_event(instrumentation::event::propagate_lagrangian_u_throw);
         throw std::domain_error("Maximum number of iterations exceeded when solving Kepler's "
                                 "equation for the universal anomaly in propagate_lagrangian_u.");
     }
     // evaluate the lagrangian coefficients F and G
-    double S = stumpff_s(alpha * DS * DS);
-    double C = stumpff_c(alpha * DS * DS);
-    //
     double z = alpha * DS * DS;
+    const auto [C, S] = stumpff(z);
     F = 1 - DS * DS / R0 * C;
-    G = dt_copy - 1 / std::sqrt(mu) * DS * DS * DS * S;
+    G = dt_copy - 1 / sqrt_mu * DS * DS * DS * S;
 
     double r0_copy[3] = {r0[0], r0[1], r0[2]};
     // compute the final position
@@ -197,7 +328,7 @@ void propagate_lagrangian_u(std::array<std::array<double, 3>, 2> &pos_vel_0, con
     double RF = std::sqrt(r0[0] * r0[0] + r0[1] * r0[1] + r0[2] * r0[2]);
 
     // compute the lagrangian coefficients Ft, Gt
-    Ft = std::sqrt(mu) / RF / R0 * (z * S - 1) * DS;
+    Ft = sqrt_mu / RF / R0 * (z * S - 1) * DS;
     Gt = 1 - DS * DS / RF * C;
 
     // compute the final velocity
@@ -0,0 +1,300 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <fmt/core.h>
+#include <oneapi/tbb/blocked_range.h>
+#include <oneapi/tbb/parallel_for.h>
+#include <oneapi/tbb/partitioner.h>
+
+#include <kep3/core_astro/constants.hpp>
+#include <kep3/core_astro/kepler_equations.hpp>
+#include <kep3/core_astro/propagate_lagrangian_batch.hpp>
+#include <kep3/detail/lagrangian_stm.hpp>
+#include <kep3/detail/simd_dispatch.hpp>
+
+namespace kep3
+{
+
+namespace
+{
+
+void propagate_batch_check_sizes(const pos_vel_batch &pos_vel, std::span<const double> dt)
+{
+    const auto N = dt.size();
+    bool ok = true;
+    for (auto j = 0u; j < 3u; ++j) {
+        ok = ok && pos_vel.r[j].size() == N && pos_vel.v[j].size() == N;
+    }
+    if (!ok) {
+        throw std::invalid_argument(
+            fmt::format("propagate_lagrangian_batch: all the state spans must have the same size as dt ({})", N));
+    }
+}
+
+// Propagates the W states starting at i0 in lockstep. Elliptic and hyperbolic lanes share
+// the same code: with k = 1 (ellipses) or k = -1 (hyperbolae), C = cos(x) or cosh(x) and
+// S = sin(x) or sinh(x), Kepler's equations in DE and DH (see kepDE and kepDH) both read
+// k * (x - M) + k * s0 * (1 - C) - k * c0 * S = 0, with M = DM or -DN. The Newton iterations
+// use masked convergence and the group exits when all lanes are done. The transcendental
+// functions are evaluated lane by lane. If Stm, the state transition matrices are written
+// to stms (36 values per state, see kep3::propagate_lagrangian_stm). The lanes for which
+// the iterations do not converge are left unchanged, and if error is empty the first of
+// them is described there.
+template <std::size_t W, bool Stm>
+kep3_SIMD_INLINE void propagate_lanes(const pos_vel_batch &pos_vel, std::span<const double> dts, double mu,
+                                      std::span<double> stms, std::size_t i0, std::string &error)
+{
+    using lanes = std::array<double, W>;
+
+    double *rx = pos_vel.r[0].data() + i0, *ry = pos_vel.r[1].data() + i0, *rz = pos_vel.r[2].data() + i0;
+    double *vx = pos_vel.v[0].data() + i0, *vy = pos_vel.v[1].data() + i0, *vz = pos_vel.v[2].data() + i0;
+    const double *dt = dts.data() + i0;
+    const double sqrt_mu = std::sqrt(mu);
+
+    // 1 - Orbital geometry.
+    lanes R{}, a{}, sqrta{}, sigma0{}, k{}, s0{}, c0{}, Dm{};
+    kep3_SIMD_LOOP
+    for (std::size_t l = 0u; l < W; ++l) {
+        R[l] = std::sqrt(rx[l] * rx[l] + ry[l] * ry[l] + rz[l] * rz[l]);
+        const double V2 = vx[l] * vx[l] + vy[l] * vy[l] + vz[l] * vz[l];
+        const double energy = V2 / 2 - mu / R[l];
+        a[l] = -mu / 2.0 / energy; // will be negative for hyperbolae
+        sqrta[l] = std::sqrt(std::abs(a[l]));
+        sigma0[l] = (rx[l] * vx[l] + ry[l] * vy[l] + rz[l] * vz[l]) / sqrt_mu;
+        k[l] = (a[l] > 0) ? 1. : -1.;
+        s0[l] = sigma0[l] / sqrta[l];
+        c0[l] = 1 - R[l] / a[l];
+        // DM for ellipses, DN for hyperbolae.
+        Dm[l] = sqrt_mu / (sqrta[l] * sqrta[l] * sqrta[l]) * dt[l];
+    }
+
+    // 2 - Initial guesses and bounds (see kep3::propagate_lagrangian).
+    lanes x{}, M{}, lb{}, ub{};
+    for (std::size_t l = 0u; l < W; ++l) {
+        if (k[l] > 0) {
+            const double sinDM = std::sin(Dm[l]), cosDM = std::cos(Dm[l]);
+            double DM_cropped = std::atan2(sinDM, cosDM);
+            if (DM_cropped < 0) {
+                DM_cropped += 2 * kep3::pi;
+            }
+            const double c = c0[l], s = s0[l];
+            x[l] = DM_cropped + c * sinDM - s * (1 - cosDM) + (c * cosDM - s * sinDM) * (c * sinDM + s * cosDM - s)
+                   + 0.5 * (c * sinDM + s * cosDM - s)
+                         * (2 * std::pow(c * cosDM - s * sinDM, 2)
+                            - (c * sinDM + s * cosDM - s) * (c * sinDM + s * cosDM));
+            M[l] = DM_cropped;
+            lb[l] = x[l] - pi;
+            ub[l] = x[l] + pi;
+        } else {
+            const auto start = kepDH_starter(Dm[l], s0[l], c0[l]);
+            x[l] = start.guess;
+            M[l] = -Dm[l];
+            lb[l] = start.lb;
+            ub[l] = start.ub;
+        }
+    }
+
+    // 3 - Newton iterations with masked convergence. active[l] is 1. while the
+    // l-th lane is iterating and 0. afterwards. A lane also stops when its (already
+    // tiny) step stops decreasing, as it is then oscillating at the round-off level
+    // of f / df.
+    constexpr double tol = 4 * std::numeric_limits<double>::epsilon();
+    lanes active{}, C{}, S{}, err_prev{};
+    active.fill(1.);
+    err_prev.fill(std::numeric_limits<double>::infinity());
+    for (unsigned it = 0u; it < 100u; ++it) {
+        for (std::size_t l = 0u; l < W; ++l) {
+            if (active[l] != 0.) {
+                C[l] = (k[l] > 0) ? std::cos(x[l]) : std::cosh(x[l]);
+                S[l] = (k[l] > 0) ? std::sin(x[l]) : std::sinh(x[l]);
+            }
+        }
+        double n_active = 0.;
+        kep3_SIMD_LOOP
+        for (std::size_t l = 0u; l < W; ++l) {
+            const double f = k[l] * (x[l] - M[l]) + k[l] * s0[l] * (1 - C[l]) - k[l] * c0[l] * S[l];
+            const double df = k[l] + s0[l] * S[l] - k[l] * c0[l] * C[l];
+            const double xnew = std::min(std::max(x[l] - f / df, lb[l]), ub[l]);
+            const double err = std::abs(xnew - x[l]);
+            const double scale = std::max(1., std::abs(x[l]));
+            x[l] = (active[l] != 0.) ? xnew : x[l];
+            const bool done = err <= tol * scale || (err >= err_prev[l] && err <= 1e-10 * scale);
+            active[l] = done ? 0. : active[l];
+            err_prev[l] = err;
+            n_active += active[l];
+        }
+        if (n_active == 0.) {
+            break;
+        }
+    }
+    for (std::size_t l = 0u; l < W; ++l) {
+        if (active[l] != 0. && error.empty()) [[unlikely]] {
+            error = fmt::format("Maximum number of iterations exceeded when solving Kepler's "
+                                "equation for the {} anomaly in propagate_lagrangian_batch.\n"
+                                "Dm={}\nsigma0={}\nsqrta={}\na={}\nR={}\nx={}",
+                                k[l] > 0 ? "eccentric" : "hyperbolic", Dm[l], sigma0[l], sqrta[l], a[l], R[l], x[l]);
+        }
+    }
+    for (std::size_t l = 0u; l < W; ++l) {
+        C[l] = (k[l] > 0) ? std::cos(x[l]) : std::cosh(x[l]);
+        S[l] = (k[l] > 0) ? std::sin(x[l]) : std::sinh(x[l]);
+    }
+
+    // 4 - Lagrange coefficients and in place update.
+    lanes F{}, G{}, Ft{}, Gt{};
+    kep3_SIMD_LOOP
+    for (std::size_t l = 0u; l < W; ++l) {
+        const double r = a[l] + (R[l] - a[l]) * C[l] + sigma0[l] * sqrta[l] * S[l];
+        F[l] = 1 - a[l] / R[l] * (1 - C[l]);
+        G[l] = a[l] * sigma0[l] / sqrt_mu * (1 - C[l]) + R[l] * sqrta[l] / sqrt_mu * S[l];
+        Ft[l] = -sqrt_mu * sqrta[l] / (r * R[l]) * S[l];
+        Gt[l] = 1 - a[l] / r * (1 - C[l]);
+    }
+    if constexpr (Stm) {
+        for (std::size_t l = 0u; l < W; ++l) {
+            if (active[l] != 0.) [[unlikely]] {
+                continue;
+            }
+            const std::array<double, 3> r0{rx[l], ry[l], rz[l]}, v0{vx[l], vy[l], vz[l]};
+            std::array<double, 3> r{}, v{};
+            for (auto j = 0u; j < 3u; ++j) {
+                r[j] = F[l] * r0[j] + G[l] * v0[j];
+                v[j] = Ft[l] * r0[j] + Gt[l] * v0[j];
+            }
+            // For ellipses x is relative to the cropped DM: the full revolutions are added back.
+            const double x_full = (k[l] > 0) ? x[l] + (Dm[l] - M[l]) : x[l];
+            kep3::detail::lagrangian_stm(r0, v0, r, v, F[l], G[l], Ft[l], Gt[l],
+                                         kep3::detail::battin_c(a[l], x_full, C[l], S[l], dt[l], mu), mu,
+                                         stms.data() + 36u * (i0 + l));
+        }
+    }
+    // The lanes that did not converge are left unchanged.
+    kep3_SIMD_LOOP
+    for (std::size_t l = 0u; l < W; ++l) {
+        const bool ok = active[l] == 0.;
+        const double x0 = rx[l], y0 = ry[l], z0 = rz[l], vx0 = vx[l], vy0 = vy[l], vz0 = vz[l];
+        rx[l] = ok ? F[l] * x0 + G[l] * vx0 : x0;
+        ry[l] = ok ? F[l] * y0 + G[l] * vy0 : y0;
+        rz[l] = ok ? F[l] * z0 + G[l] * vz0 : z0;
+        vx[l] = ok ? Ft[l] * x0 + Gt[l] * vx0 : vx0;
+        vy[l] = ok ? Ft[l] * y0 + Gt[l] * vy0 : vy0;
+        vz[l] = ok ? Ft[l] * z0 + Gt[l] * vz0 : vz0;
+    }
+}
+
+// Runs the lane groups of width W over the batch, the remainder is processed one state at a time.
+template <std::size_t W, bool Stm>
+kep3_SIMD_INLINE void propagate_range_impl(const pos_vel_batch &pos_vel, std::span<const double> dt, double mu,
+                                           std::span<double> stms, std::string &error)
+{
+    const auto N = dt.size();
+    std::size_t i = 0u;
+    if constexpr (W > 1u) {
+        for (; i + W <= N; i += W) {
+            propagate_lanes<W, Stm>(pos_vel, dt, mu, stms, i, error);
+        }
+    }
+    for (; i < N; ++i) {
+        propagate_lanes<1, Stm>(pos_vel, dt, mu, stms, i, error);
+    }
+}
+
+// The state transition matrices are computed if stms is not empty.
+struct propagate_kernel {
+    template <std::size_t W>
+    kep3_SIMD_INLINE static void run(const pos_vel_batch &pos_vel, std::span<const double> dt, double mu,
+                                     std::span<double> stms, std::string &error)
+    {
+        if (stms.empty()) {
+            propagate_range_impl<W, false>(pos_vel, dt, mu, stms, error);
+        } else {
+            propagate_range_impl<W, true>(pos_vel, dt, mu, stms, error);
+        }
+    }
+};
+
+using propagate_dispatch = detail::simd_dispatch<propagate_kernel, const pos_vel_batch &, std::span<const double>,
+                                                 double, std::span<double>, std::string &>;
+
+} // namespace
+
+void propagate_lagrangian_batch(const pos_vel_batch &pos_vel, std::span<const double> dt, double mu)
+{
+    propagate_batch_check_sizes(pos_vel, dt);
+
+    std::string error;
+    propagate_dispatch::run(pos_vel, dt, mu, {}, error);
+    if (!error.empty()) {
+        throw std::domain_error(error);
+    }
+}
+
+void propagate_lagrangian_stm_batch(const pos_vel_batch &pos_vel, std::span<const double> dt, double mu,
+                                    std::span<double> stms)
+{
+    propagate_batch_check_sizes(pos_vel, dt);
+    if (stms.size() != 36u * dt.size()) {
+        throw std::invalid_argument(fmt::format("propagate_lagrangian_stm_batch: the size of the state transition "
+                                                "matrices span ({}) must be 36 times the size of dt ({})",
+                                                stms.size(), dt.size()));
+    }
+
+    std::string error;
+    propagate_dispatch::run(pos_vel, dt, mu, stms, error);
+    if (!error.empty()) {
+        throw std::domain_error(error);
+    }
+}
+
+std::vector<propagate_status>
+propagate_lagrangian_parallel(std::span<std::array<std::array<double, 3>, 2>> pos_vels, std::span<const double> dt,
+                              double mu, void (*propagate)(std::array<std::array<double, 3>, 2> &, double, double))
+{
+    const auto N = pos_vels.size();
+    if (dt.size() != N) {
+        throw std::invalid_argument(fmt::format(
+            "propagate_lagrangian_parallel: the number of states ({}) and of times ({}) must be the same", N,
+            dt.size()));
+    }
+
+    // NOTE: the simple_partitioner splits the range down to chunks of exactly
+    // grain_size states (the last one excepted), whatever the number of threads.
+    constexpr decltype(pos_vels.size()) grain_size = 1024u;
+    std::vector<propagate_status> retval(N, propagate_status::success);
+    oneapi::tbb::parallel_for(
+        oneapi::tbb::blocked_range<decltype(pos_vels.size())>(0u, N, grain_size),
+        [&](const auto &range) {
+            for (auto i = range.begin(); i != range.end(); ++i) {
+                // NOTE: we work on a copy as some propagators (e.g. propagate_lagrangian_u)
+                // alter the state before throwing.
+                auto pos_vel = pos_vels[i];
+                try {
+                    propagate(pos_vel, dt[i], mu);
+                    pos_vels[i] = pos_vel;
+                } catch (const std::domain_error &) {
+                    retval[i] = propagate_status::failure;
+                }
+            }
+        },
+        oneapi::tbb::simple_partitioner());
+
+    return retval;
+}
+
+} // namespace kep3
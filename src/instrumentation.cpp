@@ -0,0 +1,122 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <kep3/instrumentation.hpp>
+
+namespace kep3::instrumentation
+{
+
+namespace
+{
+
+// The counters of one thread. Each is only written by its thread, hence a relaxed load and store
+// (rather than an atomic increment) suffice, the atomics allowing other threads to take snapshots.
+struct counters {
+    std::array<std::array<std::atomic<unsigned long long>, n_bins>, n_solvers> iters{};
+    std::array<std::atomic<unsigned long long>, n_events> events{};
+};
+
+void increment(std::atomic<unsigned long long> &c)
+{
+    c.store(c.load(std::memory_order_relaxed) + 1u, std::memory_order_relaxed);
+}
+
+// The counters of all the threads which recorded something. They are kept after the threads
+// exit, so that their counts are not lost.
+struct registry {
+    std::mutex mutex;
+    std::vector<std::shared_ptr<counters>> all;
+};
+
+registry &get_registry()
+{
+    static registry r;
+    return r;
+}
+
+counters &local_counters()
+{
+    thread_local const std::shared_ptr<counters> c = []() {
+        auto retval = std::make_shared<counters>();
+        auto &r = get_registry();
+        const std::lock_guard lock(r.mutex);
+        r.all.push_back(retval);
+        return retval;
+    }();
+    return *c;
+}
+
+} // namespace
+
+bool enabled()
+{
+#if defined(kep3_WITH_INSTRUMENTATION)
+    return true;
+#else
+    return false;
+#endif
+}
+
+snapshot get_snapshot()
+{
+    snapshot retval;
+    auto &r = get_registry();
+    const std::lock_guard lock(r.mutex);
+    for (const auto &c : r.all) {
+        for (auto s = 0u; s < n_solvers; ++s) {
+            for (auto k = 0u; k < n_bins; ++k) {
+                retval.iters[s][k] += c->iters[s][k].load(std::memory_order_relaxed);
+            }
+        }
+        for (auto e = 0u; e < n_events; ++e) {
+            retval.events[e] += c->events[e].load(std::memory_order_relaxed);
+        }
+    }
+    return retval;
+}
+
+void reset()
+{
+    auto &r = get_registry();
+    const std::lock_guard lock(r.mutex);
+    for (const auto &c : r.all) {
+        for (auto &s : c->iters) {
+            for (auto &k : s) {
+                k.store(0u, std::memory_order_relaxed);
+            }
+        }
+        for (auto &e : c->events) {
+            e.store(0u, std::memory_order_relaxed);
+        }
+    }
+}
+
+namespace detail
+{
+
+void record_iters_impl(solver s, unsigned long long n)
+{
+    increment(local_counters().iters[static_cast<unsigned>(s)][std::min<unsigned long long>(n, n_bins - 1u)]);
+}
+
+void record_event_impl(event e)
+{
+    increment(local_counters().events[static_cast<unsigned>(e)]);
+}
+
+} // namespace detail
+
+} // namespace kep3::instrumentation
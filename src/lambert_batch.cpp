@@ -0,0 +1,274 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+#include <fmt/core.h>
+
+#include <kep3/detail/lambert_math.hpp>
+#include <kep3/detail/simd_dispatch.hpp>
+#include <kep3/instrumentation.hpp>
+#include <kep3/lambert_batch.hpp>
+
+namespace kep3
+{
+
+namespace
+{
+
+void lambert_batch_check_sizes(const lambert_batch_input &in, const lambert_batch_output &out)
+{
+    const auto N = in.tof.size();
+    bool ok = in.mu.size() == N && in.cw.size() == N && out.x.size() == N && out.iters.size() == N;
+    for (auto j = 0u; j < 3u; ++j) {
+        ok = ok && in.r0[j].size() == N && in.r1[j].size() == N && out.v0[j].size() == N && out.v1[j].size() == N;
+    }
+    if (!ok) {
+        throw std::invalid_argument(
+            fmt::format("lambert_solve_batch: all the input and output spans must have the same size ({})", N));
+    }
+}
+
+// Solves the i-th problem of the batch.
+kep3_SIMD_INLINE void lambert_solve_one(const lambert_batch_input &in, const lambert_batch_output &out, std::size_t i)
+{
+    // 1 - Getting lambda and T
+    const std::array<double, 3> r0 = {{in.r0[0][i], in.r0[1][i], in.r0[2][i]}};
+    const std::array<double, 3> r1 = {{in.r1[0][i], in.r1[1][i], in.r1[2][i]}};
+    const auto geo = detail::lambert_make_geometry(r0, r1, in.cw[i] != 0u);
+    const double T = detail::lambert_T(geo, in.tof[i], in.mu[i]);
+
+    // 2 - Initial guess and Householder iterations (zero revolutions)
+    double x = detail::lambert_x0_guess(T, geo.lambda);
+    out.iters[i] = detail::lambert_householder(T, x, 0, 1e-5, 15, geo.lambda);
+    out.x[i] = x;
+
+    // 3 - Terminal velocities
+    std::array<double, 3> v0{}, v1{};
+    detail::lambert_velocities(geo, in.mu[i], x, v0, v1);
+    for (auto j = 0u; j < 3u; ++j) {
+        out.v0[j][i] = v0[j];
+        out.v1[j][i] = v1[j];
+    }
+}
+
+// Solves the W problems starting at i0 in lockstep. The arithmetic stages are loops
+// over the lanes with no control flow other than selects, so that the compiler maps
+// them onto vector registers. The Householder iterations use masked convergence: a
+// lane stops updating as soon as it meets the tolerance, exactly where the scalar
+// solver would stop, and the group exits when all lanes are done. The transcendental
+// functions (and the rare Lagrange/Battin branches of x2tof) are evaluated lane by lane.
+// The instrumentation records the same events and iterations as the scalar solver.
+template <std::size_t W>
+kep3_SIMD_INLINE void lambert_solve_lanes(const lambert_batch_input &in, const lambert_batch_output &out,
+                                          std::size_t i0)
+{
+    using lanes = std::array<double, W>;
+
+    const double *rx0 = in.r0[0].data() + i0, *ry0 = in.r0[1].data() + i0, *rz0 = in.r0[2].data() + i0;
+    const double *rx1 = in.r1[0].data() + i0, *ry1 = in.r1[1].data() + i0, *rz1 = in.r1[2].data() + i0;
+    const double *tofs = in.tof.data() + i0, *mus = in.mu.data() + i0;
+    const std::uint8_t *cws = in.cw.data() + i0;
+
+    // 1 - Geometry (see detail::lambert_make_geometry).
+    lanes c{}, s{}, lambda{}, R0{}, R1{}, T{}, cw{};
+    std::array<lanes, 3> ir0{}, ir1{}, it0{}, it1{};
+    for (std::size_t l = 0u; l < W; ++l) {
+        cw[l] = cws[l] != 0u ? 1. : 0.;
+    }
+    kep3_SIMD_LOOP
+    for (std::size_t l = 0u; l < W; ++l) {
+        const double x0 = rx0[l], y0 = ry0[l], z0 = rz0[l];
+        const double x1 = rx1[l], y1 = ry1[l], z1 = rz1[l];
+        const double dx = x1 - x0, dy = y1 - y0, dz = z1 - z0;
+        c[l] = std::sqrt(dx * dx + dy * dy + dz * dz);
+        R0[l] = std::sqrt(x0 * x0 + y0 * y0 + z0 * z0);
+        R1[l] = std::sqrt(x1 * x1 + y1 * y1 + z1 * z1);
+        s[l] = (c[l] + R0[l] + R1[l]) / 2.0;
+        const double a0 = x0 / R0[l], b0 = y0 / R0[l], c0 = z0 / R0[l];
+        const double a1 = x1 / R1[l], b1 = y1 / R1[l], c1 = z1 / R1[l];
+        ir0[0][l] = a0;
+        ir0[1][l] = b0;
+        ir0[2][l] = c0;
+        ir1[0][l] = a1;
+        ir1[1][l] = b1;
+        ir1[2][l] = c1;
+        double hx = b0 * c1 - c0 * b1, hy = c0 * a1 - a0 * c1, hz = a0 * b1 - b0 * a1;
+        const double H = std::sqrt(hx * hx + hy * hy + hz * hz);
+        hx /= H;
+        hy /= H;
+        hz /= H;
+        const double t0x = hy * c0 - hz * b0, t0y = hz * a0 - hx * c0, t0z = hx * b0 - hy * a0;
+        const double t1x = hy * c1 - hz * b1, t1y = hz * a1 - hx * c1, t1z = hx * b1 - hy * a1;
+        const double T0n = std::sqrt(t0x * t0x + t0y * t0y + t0z * t0z);
+        const double T1n = std::sqrt(t1x * t1x + t1y * t1y + t1z * t1z);
+        const double sign = ((hz < 0.0) != (cw[l] != 0.)) ? -1.0 : 1.0;
+        lambda[l] = sign * std::sqrt(1.0 - c[l] / s[l]);
+        it0[0][l] = sign * (t0x / T0n);
+        it0[1][l] = sign * (t0y / T0n);
+        it0[2][l] = sign * (t0z / T0n);
+        it1[0][l] = sign * (t1x / T1n);
+        it1[1][l] = sign * (t1y / T1n);
+        it1[2][l] = sign * (t1z / T1n);
+        T[l] = std::sqrt(2.0 * mus[l] / s[l] / s[l] / s[l]) * tofs[l];
+    }
+
+    // 2 - Initial guess.
+    lanes x{};
+    for (std::size_t l = 0u; l < W; ++l) {
+        x[l] = detail::lambert_x0_guess(T[l], lambda[l]);
+    }
+
+    // 3 - Householder iterations with masked convergence (see detail::lambert_householder).
+    // active[l] is 1. while the l-th lane is iterating and 0. afterwards.
+    lanes active{}, iters{};
+    active.fill(1.);
+    lanes tof{}, d{}, dist{}, E{}, z{}, y{}, g{};
+    for (unsigned it = 0u; it < 15u; ++it) {
+        // Lancaster's expression on all lanes.
+        kep3_SIMD_LOOP
+        for (std::size_t l = 0u; l < W; ++l) {
+            dist[l] = std::abs(x[l] - 1);
+            E[l] = x[l] * x[l] - 1.0;
+            z[l] = std::sqrt(1 + lambda[l] * lambda[l] * E[l]);
+            y[l] = std::sqrt(std::abs(E[l]));
+            g[l] = x[l] * z[l] - lambda[l] * E[l];
+        }
+        for (std::size_t l = 0u; l < W; ++l) {
+            d[l] = (E[l] < 0) ? std::acos(g[l]) : std::log(y[l] * (z[l] - lambda[l] * x[l]) + g[l]);
+        }
+        kep3_SIMD_LOOP
+        for (std::size_t l = 0u; l < W; ++l) {
+            tof[l] = (x[l] - lambda[l] * z[l] - d[l] / y[l]) / E[l];
+        }
+        // The active lanes close to the parabola use the Lagrange or Battin expressions instead.
+        for (std::size_t l = 0u; l < W; ++l) {
+            if (active[l] == 0.) {
+                continue;
+            }
+            if (dist[l] < 0.2) {
+                detail::lambert_x2tof(tof[l], x[l], 0u, lambda[l]);
+            } else {
+                instrumentation::record_event(instrumentation::event::x2tof_lancaster);
+            }
+        }
+        // Householder step (see detail::lambert_dTdx).
+        double n_active = 0.;
+        kep3_SIMD_LOOP
+        for (std::size_t l = 0u; l < W; ++l) {
+            const double l2 = lambda[l] * lambda[l];
+            const double l3 = l2 * lambda[l];
+            const double umx2 = 1.0 - x[l] * x[l];
+            const double yy = std::sqrt(1.0 - l2 * umx2);
+            const double y3 = yy * yy * yy;
+            const double DT = 1.0 / umx2 * (3.0 * tof[l] * x[l] - 2.0 + 2.0 * l3 * x[l] / yy);
+            const double DDT = 1.0 / umx2 * (3.0 * tof[l] + 5.0 * x[l] * DT + 2.0 * (1.0 - l2) * l3 / y3);
+            const double DDDT
+                = 1.0 / umx2 * (7.0 * x[l] * DDT + 8.0 * DT - 6.0 * (1.0 - l2) * l2 * l3 * x[l] / y3 / (yy * yy));
+            const double delta = tof[l] - T[l];
+            const double DT2 = DT * DT;
+            const double xnew
+                = x[l] - delta * (DT2 - delta * DDT / 2.0) / (DT * (DT2 - delta * DDT) + DDDT * delta * delta / 6.0);
+            iters[l] += active[l];
+            const double err = std::abs(x[l] - xnew);
+            x[l] = (active[l] != 0.) ? xnew : x[l];
+            active[l] = (err > 1e-5) ? active[l] : 0.;
+            n_active += active[l];
+        }
+        if (n_active == 0.) {
+            break;
+        }
+    }
+
+    // 4 - Terminal velocities (see detail::lambert_velocities).
+    double *vx0 = out.v0[0].data() + i0, *vy0 = out.v0[1].data() + i0, *vz0 = out.v0[2].data() + i0;
+    double *vx1 = out.v1[0].data() + i0, *vy1 = out.v1[1].data() + i0, *vz1 = out.v1[2].data() + i0;
+    kep3_SIMD_LOOP
+    for (std::size_t l = 0u; l < W; ++l) {
+        const double lambda2 = lambda[l] * lambda[l];
+        const double gamma = std::sqrt(mus[l] * s[l] / 2.0);
+        const double rho = (R0[l] - R1[l]) / c[l];
+        const double sigma = std::sqrt(1 - rho * rho);
+        const double yv = std::sqrt(1.0 - lambda2 + lambda2 * x[l] * x[l]);
+        const double vr0 = gamma * ((lambda[l] * yv - x[l]) - rho * (lambda[l] * yv + x[l])) / R0[l];
+        const double vr1 = -gamma * ((lambda[l] * yv - x[l]) + rho * (lambda[l] * yv + x[l])) / R1[l];
+        const double vt = gamma * sigma * (yv + lambda[l] * x[l]);
+        const double vt0 = vt / R0[l];
+        const double vt1 = vt / R1[l];
+        vx0[l] = vr0 * ir0[0][l] + vt0 * it0[0][l];
+        vy0[l] = vr0 * ir0[1][l] + vt0 * it0[1][l];
+        vz0[l] = vr0 * ir0[2][l] + vt0 * it0[2][l];
+        vx1[l] = vr1 * ir1[0][l] + vt1 * it1[0][l];
+        vy1[l] = vr1 * ir1[1][l] + vt1 * it1[1][l];
+        vz1[l] = vr1 * ir1[2][l] + vt1 * it1[2][l];
+    }
+    for (std::size_t l = 0u; l < W; ++l) {
+        out.x[i0 + l] = x[l];
+        out.iters[i0 + l] = static_cast<unsigned>(iters[l]);
+        instrumentation::record_iters(instrumentation::solver::lambert_householder, out.iters[i0 + l]);
+    }
+}
+
+// Runs the lane groups of width W over the batch, the remainder goes through the scalar path.
+struct lambert_kernel {
+    template <std::size_t W>
+    kep3_SIMD_INLINE static void run(const lambert_batch_input &in, const lambert_batch_output &out)
+    {
+        const auto N = in.tof.size();
+        std::size_t i = 0u;
+        if constexpr (W > 1u) {
+            for (; i + W <= N; i += W) {
+                lambert_solve_lanes<W>(in, out, i);
+            }
+        }
+        for (; i < N; ++i) {
+            lambert_solve_one(in, out, i);
+        }
+    }
+};
+
+} // namespace
+
+void lambert_solve_batch(const lambert_batch_input &in, const lambert_batch_output &out)
+{
+    lambert_batch_check_sizes(in, out);
+
+    // Sanity checks, done upfront so that the kernels need not care.
+    const auto N = in.tof.size();
+    for (decltype(in.tof.size()) i = 0u; i < N; ++i) {
+        if (in.tof[i] <= 0) {
+            throw std::domain_error(fmt::format("lambert_solve_batch: Time of flight is negative! (problem {})", i));
+        }
+        if (in.mu[i] <= 0) {
+            throw std::domain_error(
+                fmt::format("lambert_solve_batch: Gravity parameter is zero or negative! (problem {})", i));
+        }
+        // The z component of the angular momentum direction, as in detail::lambert_make_geometry().
+        const double x0 = in.r0[0][i], y0 = in.r0[1][i], z0 = in.r0[2][i];
+        const double x1 = in.r1[0][i], y1 = in.r1[1][i], z1 = in.r1[2][i];
+        const double R0 = std::sqrt(x0 * x0 + y0 * y0 + z0 * z0), R1 = std::sqrt(x1 * x1 + y1 * y1 + z1 * z1);
+        const double a0 = x0 / R0, b0 = y0 / R0, c0 = z0 / R0;
+        const double a1 = x1 / R1, b1 = y1 / R1, c1 = z1 / R1;
+        const double hx = b0 * c1 - c0 * b1, hy = c0 * a1 - a0 * c1, hz = a0 * b1 - b0 * a1;
+        if (hz / std::sqrt(hx * hx + hy * hy + hz * hz) == 0) {
+            throw std::domain_error(
+                fmt::format("lambert_solve_batch: The angular momentum vector has no z component, impossible to "
+                            "define automatically clock or counterclockwise (problem {})",
+                            i));
+        }
+    }
+
+    detail::simd_dispatch<lambert_kernel, const lambert_batch_input &, const lambert_batch_output &>::run(in, out);
+}
+
+} // namespace kep3
@@ -0,0 +1,196 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include <boost/safe_numerics/safe_integer.hpp>
+#include <fmt/core.h>
+#include <oneapi/tbb/blocked_range.h>
+#include <oneapi/tbb/parallel_for.h>
+
+#include <kep3/core_astro/constants.hpp>
+#include <kep3/core_astro/flyby.hpp>
+#include <kep3/detail/lambert_batch_buffers.hpp>
+#include <kep3/lambert_problem.hpp>
+#include <kep3/mga.hpp>
+#include <kep3/planet.hpp>
+
+namespace kep3
+{
+
+namespace
+{
+
+// The gravity parameter and the safe radius of the flyby planets.
+struct flyby_planet {
+    double mu;
+    double rp;
+};
+
+// Checks the arguments common to mga() and mga_batch() and returns the flyby planets
+// (seq[1], ..., seq[n - 2]).
+std::vector<flyby_planet> mga_check(const std::vector<planet> &seq, double mu)
+{
+    if (seq.size() < 2u) {
+        throw std::invalid_argument(
+            fmt::format("mga: the sequence must contain at least two planets, but {} were provided", seq.size()));
+    }
+    if (mu <= 0) {
+        throw std::domain_error("mga: Gravity parameter is zero or negative!");
+    }
+    std::vector<flyby_planet> retval;
+    for (decltype(seq.size()) i = 1u; i + 1u < seq.size(); ++i) {
+        const flyby_planet fb{seq[i].get_mu_self(), seq[i].get_safe_radius()};
+        if (!(fb.mu > 0) || !(fb.rp > 0)) {
+            throw std::domain_error(fmt::format("mga: the flyby planet '{}' must have a positive mu_self and safe "
+                                                "radius, but {} and {} were found",
+                                                seq[i].get_name(), fb.mu, fb.rp));
+        }
+        retval.push_back(fb);
+    }
+    return retval;
+}
+
+void mga_check_tof(double tof)
+{
+    if (!(tof > 0)) {
+        throw std::domain_error(fmt::format("mga: all times of flight must be positive, but {} was found", tof));
+    }
+}
+
+double norm_diff(const std::array<double, 3> &v, const double *v_pl)
+{
+    const double dx = v[0] - v_pl[0], dy = v[1] - v_pl[1], dz = v[2] - v_pl[2];
+    return std::sqrt(dx * dx + dy * dy + dz * dz);
+}
+
+// The delta-v at the i-th planet of the sequence, for 0 < i < n - 1: v_in is the arrival
+// velocity of the incoming leg, v_out the departure velocity of the outgoing one.
+double flyby_dv(const std::array<double, 3> &v_in, const std::array<double, 3> &v_out, const double *v_pl,
+                const flyby_planet &fb)
+{
+    return fb_dv({v_in[0] - v_pl[0], v_in[1] - v_pl[1], v_in[2] - v_pl[2]},
+                 {v_out[0] - v_pl[0], v_out[1] - v_pl[1], v_out[2] - v_pl[2]}, fb.mu, fb.rp);
+}
+
+} // namespace
+
+mga_dv mga(const std::vector<planet> &seq, const std::vector<double> &x, double mu, bool cw)
+{
+    const auto fbs = mga_check(seq, mu);
+    const auto n = seq.size();
+    if (x.size() != n) {
+        throw std::invalid_argument(fmt::format(
+            "mga: the decision vector must have {} entries (one per planet), but {} were provided", n, x.size()));
+    }
+    for (decltype(x.size()) i = 1u; i < n; ++i) {
+        mga_check_tof(x[i]);
+    }
+
+    mga_dv retval;
+    retval.dvs.resize(n);
+    double t = x[0];
+    auto eph0 = seq[0].eph(t);
+    std::array<double, 3> v_in{};
+    for (decltype(seq.size()) i = 1u; i < n; ++i) {
+        t += x[i];
+        const auto eph1 = seq[i].eph(t);
+        const lambert_problem lp(eph0[0], eph1[0], x[i] * kep3::DAY2SEC, mu, cw, 0u);
+        const auto &v0 = lp.get_v0()[0];
+        retval.dvs[i - 1u] = i == 1u ? norm_diff(v0, eph0[1].data()) : flyby_dv(v_in, v0, eph0[1].data(), fbs[i - 2u]);
+        v_in = lp.get_v1()[0];
+        eph0 = eph1;
+    }
+    retval.dvs[n - 1u] = norm_diff(v_in, eph0[1].data());
+    for (const auto dv : retval.dvs) {
+        retval.total += dv;
+    }
+    return retval;
+}
+
+void mga_batch(const std::vector<planet> &seq, std::span<const double> xs, double mu, bool cw, std::span<double> dv,
+               std::span<double> dvs)
+{
+    // 0 - Sanity checks.
+    const auto fbs = mga_check(seq, mu);
+    const auto n = seq.size();
+    const auto N = dv.size();
+    using size_type = std::vector<double>::size_type;
+    const size_type n_entries = boost::safe_numerics::safe<size_type>(N) * n;
+    if (xs.size() != n_entries || dvs.size() != n_entries) {
+        throw std::invalid_argument(fmt::format("mga_batch: {} decision vectors of {} entries were expected (one per "
+                                                "planet), but xs and dvs have {} and {} entries",
+                                                N, n, xs.size(), dvs.size()));
+    }
+    for (size_type k = 0u; k < N; ++k) {
+        for (decltype(seq.size()) i = 1u; i < n; ++i) {
+            mga_check_tof(xs[k * n + i]);
+        }
+    }
+
+    // 1 - Ephemerides: one call per planet of the sequence. The states of the i-th planet
+    // start at eph[6 * N * i].
+    std::vector<double> ts(N), eph(6u * n_entries);
+    for (decltype(seq.size()) i = 0u; i < n; ++i) {
+        for (size_type k = 0u; k < N; ++k) {
+            ts[k] = i == 0u ? xs[k * n] : ts[k] + xs[k * n + i];
+        }
+        seq[i].eph_into(ts, std::span<double>(eph.data() + 6u * N * i, 6u * N));
+    }
+
+    // 2 - Lambert problems, solved in parallel over blocks of decision vectors, one leg at a time.
+    oneapi::tbb::parallel_for(oneapi::tbb::blocked_range<size_type>(0u, N), [&](const auto &range) {
+        const auto b = range.begin();
+        const auto m = range.size();
+        detail::lambert_batch_buffers leg(m);
+        // The arrival velocities of the previous leg.
+        std::array<std::vector<double>, 3> v_in{std::vector<double>(m), std::vector<double>(m), std::vector<double>(m)};
+        for (decltype(seq.size()) i = 1u; i < n; ++i) {
+            const auto *eph0 = eph.data() + 6u * (N * (i - 1u) + b);
+            const auto *eph1 = eph.data() + 6u * (N * i + b);
+            for (size_type j = 0u; j < m; ++j) {
+                for (auto c = 0u; c < 3u; ++c) {
+                    leg.r0[c][j] = eph0[6u * j + c];
+                    leg.r1[c][j] = eph1[6u * j + c];
+                }
+                leg.tof[j] = xs[(b + j) * n + i] * kep3::DAY2SEC;
+                leg.mu[j] = mu;
+                leg.cw[j] = cw;
+            }
+            leg.solve(m);
+            // 3 - Delta-v at the departure planet of the leg.
+            for (size_type j = 0u; j < m; ++j) {
+                const std::array<double, 3> v0{leg.v0[0][j], leg.v0[1][j], leg.v0[2][j]};
+                const auto *v_pl = eph0 + 6u * j + 3u;
+                dvs[(b + j) * n + i - 1u]
+                    = i == 1u ? norm_diff(v0, v_pl)
+                              : flyby_dv({v_in[0][j], v_in[1][j], v_in[2][j]}, v0, v_pl, fbs[i - 2u]);
+            }
+            v_in = leg.v1;
+        }
+        // 4 - Delta-v at the arrival planet and totals.
+        const auto *eph1 = eph.data() + 6u * (N * (n - 1u) + b);
+        for (size_type j = 0u; j < m; ++j) {
+            auto *row = dvs.data() + (b + j) * n;
+            row[n - 1u] = norm_diff({v_in[0][j], v_in[1][j], v_in[2][j]}, eph1 + 6u * j + 3u);
+            double total = 0.;
+            for (decltype(seq.size()) i = 0u; i < n; ++i) {
+                total += row[i];
+            }
+            dv[b + j] = total;
+        }
+    });
+}
+
+} // namespace kep3
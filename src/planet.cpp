@@ -12,7 +12,9 @@
 #include "kep3/core_astro/ic2par2ic.hpp"
 #include <array>
 #include <cmath>
+#include <cstddef>
 #include <limits>
+#include <stdexcept>
 
 #include <boost/core/demangle.hpp>
 
@@ -65,6 +67,15 @@ std::array<double, 6> elements_from_posvel(const std::array<std::array<double, 3
     return retval;
 }
 
+void check_eph_into_sizes(std::size_t n_epochs, std::size_t n_out)
+{
+    if (n_out != 6u * n_epochs) {
+        throw std::invalid_argument(fmt::format("Invalid output size in eph_into: {} values were expected (6 per "
+                                                "epoch), but {} were provided",
+                                                6u * n_epochs, n_out));
+    }
+}
+
 std::array<std::array<double, 3>, 2> null_udpla::eph(double)
 {
     std::array<double, 3> pos = {1., 0., 0.};
@@ -0,0 +1,217 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <boost/safe_numerics/safe_integer.hpp>
+#include <fmt/core.h>
+
+#include <kep3/core_astro/constants.hpp>
+#include <kep3/planet.hpp>
+#include <kep3/planets/cached.hpp>
+
+namespace kep3::udpla
+{
+
+cached::cached() : cached(kep3::planet{}, 0., 1.) {}
+
+cached::cached(kep3::planet pl, double mjd2000_start, double mjd2000_end, double tol, unsigned order)
+    : m_planet(std::move(pl)), m_start(mjd2000_start), m_end(mjd2000_end), m_tol(tol), m_order(order)
+{
+    if (!(mjd2000_end > mjd2000_start)) {
+        throw std::domain_error(fmt::format("A cached planet was constructed with an invalid interval [{}, {}]",
+                                            mjd2000_start, mjd2000_end));
+    }
+    if (!(tol > 0.)) {
+        throw std::domain_error(fmt::format("A cached planet was constructed with a non positive tolerance {}", tol));
+    }
+    if (order == 0u) {
+        throw std::domain_error("A cached planet was constructed with a zero interpolation order");
+    }
+    m_bounds.push_back(m_start);
+    interpolate(m_start, m_end, 0u);
+}
+
+// Builds the Chebyshev interpolants over [a, b], bisecting until the tolerance is met.
+void cached::interpolate(double a, double b, unsigned depth)
+{
+    const auto n = m_order;
+    const double mid = (a + b) / 2., half = (b - a) / 2.;
+
+    // 1 - We sample the planet at the Chebyshev nodes.
+    std::vector<double> nodes(n + 1u);
+    for (auto k = 0u; k <= n; ++k) {
+        nodes[k] = mid + half * std::cos(kep3::pi * (k + 0.5) / (n + 1.));
+    }
+    const auto values = m_planet.eph_v(nodes);
+
+    // 2 - We compute the coefficients of the six components.
+    const auto offset = m_coeffs.size();
+    m_coeffs.resize(offset + 6u * (n + 1u), 0.);
+    for (auto c = 0u; c < 6u; ++c) {
+        for (auto j = 0u; j <= n; ++j) {
+            double sum = 0.;
+            for (auto k = 0u; k <= n; ++k) {
+                sum += values[6u * k + c] * std::cos(kep3::pi * j * (k + 0.5) / (n + 1.));
+            }
+            m_coeffs[offset + c * (n + 1u) + j] = (j == 0u ? 1. : 2.) * sum / (n + 1.);
+        }
+    }
+
+    // 3 - We check the error at the extrema of the Chebyshev polynomial of degree n.
+    std::vector<double> checks(n + 1u);
+    for (auto k = 0u; k <= n; ++k) {
+        checks[k] = mid + half * std::cos(kep3::pi * k / n);
+    }
+    const auto truth = m_planet.eph_v(checks);
+    const auto piece = m_bounds.size() - 1u;
+    m_bounds.push_back(b);
+    bool ok = true;
+    for (auto k = 0u; k <= n && ok; ++k) {
+        const auto [r, v] = eval(piece, checks[k]);
+        double dr = 0., dv = 0., R = 0., V = 0.;
+        for (auto j = 0u; j < 3u; ++j) {
+            dr += (r[j] - truth[6u * k + j]) * (r[j] - truth[6u * k + j]);
+            dv += (v[j] - truth[6u * k + 3u + j]) * (v[j] - truth[6u * k + 3u + j]);
+            R += truth[6u * k + j] * truth[6u * k + j];
+            V += truth[6u * k + 3u + j] * truth[6u * k + 3u + j];
+        }
+        ok = std::sqrt(dr) <= m_tol * std::sqrt(R) && std::sqrt(dv) <= m_tol * std::sqrt(V);
+    }
+    if (ok) {
+        return;
+    }
+
+    // 4 - We bisect.
+    m_bounds.pop_back();
+    m_coeffs.resize(offset);
+    if (depth == 40u) {
+        throw std::domain_error(fmt::format("A cached planet could not meet the tolerance {} in the interval [{}, {}]",
+                                            m_tol, a, b));
+    }
+    interpolate(a, mid, depth + 1u);
+    interpolate(mid, b, depth + 1u);
+}
+
+// Evaluates the interpolants of the i-th piece at mjd2000 (Clenshaw's recurrence).
+std::array<std::array<double, 3>, 2> cached::eval(std::vector<double>::size_type i, double mjd2000) const
+{
+    const auto n = m_order;
+    const double a = m_bounds[i], b = m_bounds[i + 1u];
+    const double u = (2. * mjd2000 - a - b) / (b - a);
+    const double *coeffs = m_coeffs.data() + i * 6u * (n + 1u);
+    std::array<double, 6> res{};
+    for (auto c = 0u; c < 6u; ++c) {
+        const double *cc = coeffs + c * (n + 1u);
+        double b1 = 0., b2 = 0.;
+        for (auto j = n; j > 0u; --j) {
+            const double tmp = 2. * u * b1 - b2 + cc[j];
+            b2 = b1;
+            b1 = tmp;
+        }
+        res[c] = u * b1 - b2 + cc[0];
+    }
+    return {{{res[0], res[1], res[2]}, {res[3], res[4], res[5]}}};
+}
+
+std::array<std::array<double, 3>, 2> cached::eph(double mjd2000) const
+{
+    if (!(mjd2000 >= m_start && mjd2000 <= m_end)) {
+        throw std::domain_error(fmt::format("The epoch {} is outside the interval [{}, {}] of a cached planet", mjd2000,
+                                            m_start, m_end));
+    }
+    const auto n_pieces = m_bounds.size() - 1u;
+    auto i = static_cast<std::vector<double>::size_type>(std::upper_bound(m_bounds.begin(), m_bounds.end(), mjd2000)
+                                                         - m_bounds.begin());
+    i = std::min(i - 1u, n_pieces - 1u);
+    return eval(i, mjd2000);
+}
+
+std::vector<double> cached::eph_v(const std::vector<double> &mjd2000s) const
+{
+    const auto size = mjd2000s.size();
+    using size_type = std::vector<double>::size_type;
+    std::vector<double> retval;
+    retval.resize(boost::safe_numerics::safe<size_type>(size) * 6);
+    for (decltype(mjd2000s.size()) i = 0u; i < size; ++i) {
+        const auto [r, v] = eph(mjd2000s[i]);
+        std::copy(r.begin(), r.end(), retval.begin() + static_cast<std::ptrdiff_t>(6u * i));
+        std::copy(v.begin(), v.end(), retval.begin() + static_cast<std::ptrdiff_t>(6u * i + 3u));
+    }
+    return retval;
+}
+
+std::string cached::get_name() const
+{
+    return m_planet.get_name();
+}
+
+double cached::get_mu_central_body() const
+{
+    return m_planet.get_mu_central_body();
+}
+
+double cached::get_mu_self() const
+{
+    return m_planet.get_mu_self();
+}
+
+double cached::get_radius() const
+{
+    return m_planet.get_radius();
+}
+
+double cached::get_safe_radius() const
+{
+    return m_planet.get_safe_radius();
+}
+
+double cached::period(double mjd2000) const
+{
+    return m_planet.period(mjd2000);
+}
+
+std::array<double, 6> cached::elements(double mjd2000, kep3::elements_type el_type) const
+{
+    return m_planet.elements(mjd2000, el_type);
+}
+
+const kep3::planet &cached::get_planet() const
+{
+    return m_planet;
+}
+
+std::vector<double>::size_type cached::get_n_pieces() const
+{
+    return m_bounds.size() - 1u;
+}
+
+std::string cached::get_extra_info() const
+{
+    return fmt::format("Cached ephemerides in the interval (MJD2000): [{}, {}]\n", m_start, m_end)
+           + fmt::format("Relative tolerance: {}\n", m_tol) + fmt::format("Interpolation order: {}\n", m_order)
+           + fmt::format("Number of pieces: {}\n", get_n_pieces()) + m_planet.get_extra_info();
+}
+
+std::ostream &operator<<(std::ostream &os, const kep3::udpla::cached &udpla)
+{
+    os << udpla.get_extra_info() << std::endl;
+    return os;
+}
+
+} // namespace kep3::udpla
+
+// NOLINTNEXTLINE
+TANUKI_S11N_WRAP_EXPORT_IMPLEMENT(kep3::udpla::cached, kep3::detail::planet_iface)
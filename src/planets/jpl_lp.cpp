@@ -7,11 +7,17 @@
 // Public License v. 2.0. If a copy of the MPL was not distributed
 // with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
 
+#include <algorithm>
+#include <array>
 #include <cmath>
+#include <cstddef>
+#include <span>
 #include <stdexcept>
 #include <unordered_map>
+#include <vector>
 
 #include <boost/algorithm/string.hpp>
+#include <boost/safe_numerics/safe_integer.hpp>
 #include <fmt/core.h>
 #include <fmt/ranges.h>
 
@@ -19,6 +25,8 @@
 #include <kep3/core_astro/convert_anomalies.hpp>
 #include <kep3/core_astro/eq2par2eq.hpp>
 #include <kep3/core_astro/ic2par2ic.hpp>
+#include <kep3/detail/jpl_lp_data.hpp>
+#include <kep3/detail/simd_dispatch.hpp>
 #include <kep3/epoch.hpp>
 #include <kep3/planet.hpp>
 #include <kep3/planets/jpl_lp.hpp>
@@ -26,27 +34,6 @@
 namespace kep3::udpla
 {
 
-// Data from: https://ssd.jpl.nasa.gov/planets/approx_pos.html
-// a,e,i,L,W,w
-// clang-format off
-static const std::array<double, 6> mercury_el = {0.38709927, 0.20563593, 7.00497902, 252.25032350, 77.45779628, 48.33076593};
-static const std::array<double, 6> mercury_el_dot = {0.00000037, 0.00001906, -0.00594749, 149472.67411175, 0.16047689, -0.12534081};
-static const std::array<double, 6> venus_el = {0.72333566, 0.00677672, 3.39467605, 181.97909950, 131.60246718, 76.67984255};
-static const std::array<double, 6> venus_el_dot = {0.00000390, -0.00004107, -0.00078890, 58517.81538729, 0.00268329, -0.27769418};
-static const std::array<double, 6> earth_moon_el = {1.00000261, 0.01671123, -0.00001531, 100.46457166, 102.93768193, 0.0};
-static const std::array<double, 6> earth_moon_el_dot = {0.00000562, -0.00004392, -0.01294668, 35999.37244981, 0.32327364, 0.0};
-static const std::array<double, 6> mars_el = {1.52371034, 0.09339410, 1.84969142, -4.55343205, -23.94362959, 49.55953891};
-static const std::array<double, 6> mars_el_dot = {0.00001847, 0.00007882, -0.00813131, 19140.30268499, 0.44441088, -0.29257343};
-static const std::array<double, 6> jupiter_el = {5.20288700, 0.04838624, 1.30439695, 34.39644051, 14.72847983, 100.47390909};
-static const std::array<double, 6> jupiter_el_dot = {-0.00011607, -0.00013253, -0.00183714, 3034.74612775, 0.21252668, 0.20469106};
-static const std::array<double, 6> saturn_el = {9.53667594, 0.05386179, 2.48599187, 49.95424423, 92.59887831, 113.66242448};
-static const std::array<double, 6> saturn_el_dot = {-0.00125060, -0.00050991, 0.00193609, 1222.49362201, -0.41897216, -0.28867794};
-static const std::array<double, 6> uranus_el = {19.18916464, 0.04725744, 0.77263783, 313.23810451, 170.95427630, 74.01692503};
-static const std::array<double, 6> uranus_el_dot = {-0.00196176, -0.00004397, -0.00242939, 428.48202785, 0.40805281, 0.04240589};
-static const std::array<double, 6> neptune_el = {30.06992276, 0.00859048, 1.77004347, -55.12002969, 44.96476227, 131.78422574};
-static const std::array<double, 6> neptune_el_dot = {0.00026291, 0.00005105, 0.00035372, 218.45945325, -0.32241464, -0.00508664};
-// clang-format on
-
 // NOLINTNEXTLINE(cert-err58-cpp)
 const std::unordered_map<std::string, int> mapped_planets
     = {{"mercury", 1}, {"venus", 2},  {"earth", 3},   {"mars", 4}, {"jupiter", 5},
@@ -57,75 +44,24 @@ jpl_lp::jpl_lp(std::string name)
 {
 
     boost::algorithm::to_lower(m_name);
-    switch (mapped_planets.at(m_name)) {
-        case (1): {
-            m_elements = mercury_el;
-            m_elements_dot = mercury_el_dot;
-            m_radius = 2440000.;
-            m_safe_radius = 1.1 * m_radius;
-            m_mu_self = 22032e9;
-        } break;
-        case (2): {
-            m_elements = venus_el;
-            m_elements_dot = venus_el_dot;
-            m_radius = 6052000.;
-            m_safe_radius = 1.1 * m_radius;
-            m_mu_self = 324859e9;
-        } break;
-        case (3): {
-            m_elements = earth_moon_el;
-            m_elements_dot = earth_moon_el_dot;
-            m_radius = 6378000.;
-            m_safe_radius = 1.1 * m_radius;
-            m_mu_self = 398600.4418e9;
-        } break;
-        case (4): {
-            m_elements = mars_el;
-            m_elements_dot = mars_el_dot;
-            m_radius = 3397000.;
-            m_safe_radius = 1.1 * m_radius;
-            m_mu_self = 42828e9;
-        } break;
-        case (5): {
-            m_elements = jupiter_el;
-            m_elements_dot = jupiter_el_dot;
-            m_radius = 71492000.;
-            m_safe_radius = 9. * m_radius;
-            m_mu_self = 126686534e9;
-        } break;
-        case (6): {
-            m_elements = saturn_el;
-            m_elements_dot = saturn_el_dot;
-            m_radius = 60330000.;
-            m_safe_radius = 1.1 * m_radius;
-            m_mu_self = 37931187e9;
-        } break;
-        case (7): {
-            m_elements = uranus_el;
-            m_elements_dot = uranus_el_dot;
-            m_radius = 25362000.;
-            m_safe_radius = 1.1 * m_radius;
-            m_mu_self = 5793939e9;
-        } break;
-        case (8): {
-            m_elements = neptune_el;
-            m_elements_dot = neptune_el_dot;
-            m_radius = 24622000.;
-            m_safe_radius = 1.1 * m_radius;
-            m_mu_self = 6836529e9;
-        } break;
-            // LCOV_EXCL_START
-        default: {
-            throw std::logic_error("unknown planet name: ");
-            // LCOV_EXCL_END
-        }
+    const auto idx = mapped_planets.at(m_name);
+    // LCOV_EXCL_START
+    if (idx > 8) {
+        throw std::logic_error("unknown planet name: ");
     }
+    // LCOV_EXCL_END
+    const auto &data = kep3::detail::jpl_lp_bodies[static_cast<std::size_t>(idx - 1)];
+    m_elements = data.elements;
+    m_elements_dot = data.elements_dot;
+    m_radius = data.radius;
+    m_safe_radius = data.safe_radius;
+    m_mu_self = data.mu_self;
 }
 
 // Computes the kep3::KEP_F elements (osculating with true anomaly) at epoch.
 std::array<double, 6> jpl_lp::_f_elements(double mjd2000) const
 {
-    if (mjd2000 <= -73048.0 || mjd2000 >= 18263.0) {
+    if (!(mjd2000 > -73048.0 && mjd2000 < 18263.0)) {
         throw std::domain_error("Low precision Ephemeris are only valid in the "
                                 "range range [1800-2050]");
     }
@@ -152,6 +88,92 @@ std::array<std::array<double, 3>, 2> jpl_lp::eph(double mjd2000) const
     return par2ic(elements_f, get_mu_central_body());
 }
 
+// Number of epochs processed together by eph_into(). The scratch arrays of a block fit in the L1 cache.
+constexpr std::size_t eph_v_block = 256u;
+
+// Same as eph(), but the epochs are processed in blocks and each step (elements, Kepler's
+// equation, conversion to Cartesian) is a loop over the epochs of the block. Kepler's
+// equation is solved for E with Newton's iterations, starting from the same initial guess as
+// kep3::m2e, until all the epochs of the block converged. The Cartesian state is then computed
+// directly from E, which avoids the conversion to the true anomaly.
+void jpl_lp::eph_into(std::span<const double> mjd2000s, std::span<double> retval) const
+{
+    kep3::detail::check_eph_into_sizes(mjd2000s.size(), retval.size());
+    // 1 - We check the range once, upfront.
+    for (const auto mjd2000 : mjd2000s) {
+        if (!(mjd2000 > -73048.0 && mjd2000 < 18263.0)) {
+            throw std::domain_error("Low precision Ephemeris are only valid in the "
+                                    "range range [1800-2050]");
+        }
+    }
+    const auto size = mjd2000s.size();
+
+    const auto &el = m_elements;
+    const auto &el_dot = m_elements_dot;
+    const double mu = get_mu_central_body();
+    std::array<double, eph_v_block> sma{}, ecc{}, inc{}, omg{}, omp{}, M{}, E{}, sinE{}, cosE{};
+    for (std::size_t i0 = 0u; i0 < size; i0 += eph_v_block) {
+        const auto n = std::min(eph_v_block, size - i0);
+        const double *t = mjd2000s.data() + i0;
+        double *out = retval.data() + 6u * i0;
+
+        // 2 - We compute the elements (as in _f_elements), the mean anomaly in [-pi, pi]
+        // and the initial guess for E.
+        kep3_SIMD_LOOP
+        for (std::size_t l = 0u; l < n; ++l) {
+            const double dt = t[l] / 36525.; // Number of centuries passed since J2000.0
+            const double L = el[3] + el_dot[3] * dt;
+            const double varpi = el[4] + el_dot[4] * dt;
+            const double Omega = el[5] + el_dot[5] * dt;
+            sma[l] = (el[0] + el_dot[0] * dt) * kep3::AU;
+            ecc[l] = el[1] + el_dot[1] * dt;
+            inc[l] = (el[2] + el_dot[2] * dt) * kep3::DEG2RAD;
+            omg[l] = Omega * kep3::DEG2RAD;
+            omp[l] = (varpi - Omega) * kep3::DEG2RAD;
+            const double sinM = std::sin((L - varpi) * kep3::DEG2RAD), cosM = std::cos((L - varpi) * kep3::DEG2RAD);
+            const double e = ecc[l];
+            M[l] = std::atan2(sinM, cosM);
+            E[l] = M[l] + e * sinM + e * e * sinM * cosM + e * e * e * sinM * (1.5 * cosM * cosM - 0.5);
+        }
+
+        // 3 - We solve Kepler's equation.
+        double max_step = 0.;
+        unsigned iter = 0u;
+        do {
+            if (iter++ == 100u) {
+                throw std::domain_error("Maximum number of iterations exceeded when solving Kepler's "
+                                        "equation for the eccentric anomaly in jpl_lp::eph_into.");
+            }
+            max_step = 0.;
+            kep3_SIMD_LOOP_MAX(max_step)
+            for (std::size_t l = 0u; l < n; ++l) {
+                const double sin_E = std::sin(E[l]), cos_E = std::cos(E[l]);
+                const double step = (E[l] - ecc[l] * sin_E - M[l]) / (1. - ecc[l] * cos_E);
+                E[l] -= step;
+                // NOTE: the step of the last iteration is below 1e-12, so that the first order
+                // update of sin(E) and cos(E) is exact in double precision.
+                sinE[l] = sin_E - step * cos_E;
+                cosE[l] = cos_E + step * sin_E;
+                max_step = std::max(max_step, std::abs(step));
+            }
+        } while (max_step > 1e-12);
+
+        // 4 - We compute position and velocity.
+        kep3_SIMD_LOOP
+        for (std::size_t l = 0u; l < n; ++l) {
+            kep3::detail::jpl_lp_e2ic(sma[l], ecc[l], inc[l], omg[l], omp[l], sinE[l], cosE[l], mu, out + 6u * l);
+        }
+    }
+}
+
+std::vector<double> jpl_lp::eph_v(const std::vector<double> &mjd2000s) const
+{
+    std::vector<double> retval;
+    retval.resize(boost::safe_numerics::safe<std::vector<double>::size_type>(mjd2000s.size()) * 6);
+    eph_into(mjd2000s, retval);
+    return retval;
+}
+
 std::array<double, 6> jpl_lp::elements(double mjd2000, kep3::elements_type el_type) const
 {
     auto elements = _f_elements(mjd2000);
@@ -0,0 +1,227 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <boost/safe_numerics/safe_integer.hpp>
+#include <fmt/core.h>
+#include <fmt/ranges.h>
+
+#include <kep3/core_astro/constants.hpp>
+#include <kep3/core_astro/convert_anomalies.hpp>
+#include <kep3/core_astro/eq2par2eq.hpp>
+#include <kep3/detail/jpl_lp_data.hpp>
+#include <kep3/epoch.hpp>
+#include <kep3/planet.hpp>
+#include <kep3/planets/jpl_lp_static.hpp>
+
+namespace kep3::udpla
+{
+
+namespace
+{
+
+// The constants of the body B, with the unit conversions applied (SI units and radians). The
+// rates are per day and the angles are those used by kep3::par2ic (W, w and the mean anomaly).
+template <body B>
+struct jpl_lp_constants {
+    static constexpr const kep3::detail::jpl_lp_body_data &data
+        = kep3::detail::jpl_lp_bodies[static_cast<std::size_t>(B)];
+    static constexpr const auto &el = data.elements;
+    static constexpr const auto &el_dot = data.elements_dot;
+    static constexpr double sma = el[0] * kep3::AU;
+    static constexpr double sma_dot = el_dot[0] * kep3::AU / 36525.;
+    static constexpr double ecc = el[1];
+    static constexpr double ecc_dot = el_dot[1] / 36525.;
+    static constexpr double inc = el[2] * kep3::DEG2RAD;
+    static constexpr double inc_dot = el_dot[2] * kep3::DEG2RAD / 36525.;
+    static constexpr double omg = el[5] * kep3::DEG2RAD;
+    static constexpr double omg_dot = el_dot[5] * kep3::DEG2RAD / 36525.;
+    static constexpr double omp = (el[4] - el[5]) * kep3::DEG2RAD;
+    static constexpr double omp_dot = (el_dot[4] - el_dot[5]) * kep3::DEG2RAD / 36525.;
+    static constexpr double M = (el[3] - el[4]) * kep3::DEG2RAD;
+    static constexpr double M_dot = (el_dot[3] - el_dot[4]) * kep3::DEG2RAD / 36525.;
+};
+
+void check_range(double mjd2000)
+{
+    if (!(mjd2000 > -73048.0 && mjd2000 < 18263.0)) {
+        throw std::domain_error("Low precision Ephemeris are only valid in the "
+                                "range range [1800-2050]");
+    }
+}
+
+// Computes the elements at epoch, the last one being the mean anomaly (not cropped).
+template <body B>
+std::array<double, 6> m_elements(double mjd2000)
+{
+    using c = jpl_lp_constants<B>;
+    return {c::sma + c::sma_dot * mjd2000, c::ecc + c::ecc_dot * mjd2000, c::inc + c::inc_dot * mjd2000,
+            c::omg + c::omg_dot * mjd2000, c::omp + c::omp_dot * mjd2000, c::M + c::M_dot * mjd2000};
+}
+
+// Writes the position and velocity at epoch to out (no range check).
+template <body B>
+void eph_impl(double mjd2000, double *out)
+{
+    const auto el = m_elements<B>(mjd2000);
+    const double E = kep3::m2e(el[5], el[1]);
+    kep3::detail::jpl_lp_e2ic(el[0], el[1], el[2], el[3], el[4], std::sin(E), std::cos(E), kep3::MU_SUN, out);
+}
+
+} // namespace
+
+template <body B>
+std::array<std::array<double, 3>, 2> jpl_lp_static<B>::eph(double mjd2000) const
+{
+    check_range(mjd2000);
+    std::array<double, 6> pos_vel{};
+    eph_impl<B>(mjd2000, pos_vel.data());
+    return {{{pos_vel[0], pos_vel[1], pos_vel[2]}, {pos_vel[3], pos_vel[4], pos_vel[5]}}};
+}
+
+template <body B>
+void jpl_lp_static<B>::eph_into(std::span<const double> mjd2000s, std::span<double> out) const
+{
+    kep3::detail::check_eph_into_sizes(mjd2000s.size(), out.size());
+    for (const auto mjd2000 : mjd2000s) {
+        check_range(mjd2000);
+    }
+    for (decltype(mjd2000s.size()) i = 0u; i < mjd2000s.size(); ++i) {
+        eph_impl<B>(mjd2000s[i], out.data() + 6u * i);
+    }
+}
+
+template <body B>
+std::vector<double> jpl_lp_static<B>::eph_v(const std::vector<double> &mjd2000s) const
+{
+    std::vector<double> retval;
+    retval.resize(boost::safe_numerics::safe<std::vector<double>::size_type>(mjd2000s.size()) * 6);
+    eph_into(mjd2000s, retval);
+    return retval;
+}
+
+template <body B>
+std::array<double, 6> jpl_lp_static<B>::elements(double mjd2000, kep3::elements_type el_type) const
+{
+    check_range(mjd2000);
+    auto elements = m_elements<B>(mjd2000);
+    switch (el_type) {
+        case kep3::elements_type::KEP_F:
+            elements[5] = kep3::m2f(elements[5], elements[1]);
+            break;
+        case kep3::elements_type::KEP_M:
+            // Same range [-pi, pi] as kep3::udpla::jpl_lp.
+            elements[5] = std::atan2(std::sin(elements[5]), std::cos(elements[5]));
+            break;
+        case kep3::elements_type::MEQ:
+            elements[5] = kep3::m2f(elements[5], elements[1]);
+            elements = kep3::par2eq(elements, false);
+            break;
+        case kep3::elements_type::MEQ_R:
+            elements[5] = kep3::m2f(elements[5], elements[1]);
+            elements = kep3::par2eq(elements, true);
+            break;
+        default:
+            throw std::logic_error("You should not go here!");
+    }
+    return elements;
+}
+
+template <body B>
+std::string jpl_lp_static<B>::get_name() const
+{
+    return std::string(jpl_lp_constants<B>::data.name);
+}
+
+template <body B>
+double jpl_lp_static<B>::get_mu_central_body() const
+{
+    return kep3::MU_SUN;
+}
+
+template <body B>
+double jpl_lp_static<B>::get_mu_self() const
+{
+    return jpl_lp_constants<B>::data.mu_self;
+}
+
+template <body B>
+double jpl_lp_static<B>::get_radius() const
+{
+    return jpl_lp_constants<B>::data.radius;
+}
+
+template <body B>
+double jpl_lp_static<B>::get_safe_radius() const
+{
+    return jpl_lp_constants<B>::data.safe_radius;
+}
+
+template <body B>
+std::string jpl_lp_static<B>::get_extra_info() const
+{
+    auto par = elements(0.);
+    auto pos_vel = eph(0.);
+
+    std::string retval = fmt::format("\nLow-precision planet elements (compile-time body): \n")
+                         + fmt::format("Semi major axis (AU): {}\n", par[0] / kep3::AU)
+                         + fmt::format("Eccentricity: {}\n", par[1])
+                         + fmt::format("Inclination (deg.): {}\n", par[2] * kep3::RAD2DEG)
+                         + fmt::format("Big Omega (deg.): {}\n", par[3] * kep3::RAD2DEG)
+                         + fmt::format("Small omega (deg.): {}\n", par[4] * kep3::RAD2DEG)
+                         + fmt::format("True anomly (deg.): {}\n", par[5] * kep3::RAD2DEG);
+    retval += fmt::format("Mean anomly (deg.): {}\n", kep3::f2m(par[5], par[1]) * kep3::RAD2DEG);
+    retval += fmt::format("Elements reference epoch (MJD2000): {}\n", 0.)
+              + fmt::format("Elements reference epoch (date): {}\n", kep3::epoch(0.))
+              + fmt::format("r at ref. = {}\n", pos_vel[0]) + fmt::format("v at ref. = {}\n", pos_vel[1]);
+    return retval;
+}
+
+template <body B>
+std::ostream &operator<<(std::ostream &os, const kep3::udpla::jpl_lp_static<B> &udpla)
+{
+    os << udpla.get_extra_info() << std::endl;
+    return os;
+}
+
+// Explicit instantiations.
+#define KEP3_JPL_LP_STATIC_INSTANTIATE(b)                                                                              \
+    template class jpl_lp_static<body::b>;                                                                             \
+    template std::ostream &operator<<(std::ostream &, const kep3::udpla::jpl_lp_static<body::b> &);
+
+KEP3_JPL_LP_STATIC_INSTANTIATE(mercury)
+KEP3_JPL_LP_STATIC_INSTANTIATE(venus)
+KEP3_JPL_LP_STATIC_INSTANTIATE(earth)
+KEP3_JPL_LP_STATIC_INSTANTIATE(mars)
+KEP3_JPL_LP_STATIC_INSTANTIATE(jupiter)
+KEP3_JPL_LP_STATIC_INSTANTIATE(saturn)
+KEP3_JPL_LP_STATIC_INSTANTIATE(uranus)
+KEP3_JPL_LP_STATIC_INSTANTIATE(neptune)
+
+#undef KEP3_JPL_LP_STATIC_INSTANTIATE
+
+} // namespace kep3::udpla
+
+// NOLINTBEGIN
+TANUKI_S11N_WRAP_EXPORT_IMPLEMENT(kep3::udpla::jpl_lp_static<kep3::udpla::body::mercury>, kep3::detail::planet_iface)
+TANUKI_S11N_WRAP_EXPORT_IMPLEMENT(kep3::udpla::jpl_lp_static<kep3::udpla::body::venus>, kep3::detail::planet_iface)
+TANUKI_S11N_WRAP_EXPORT_IMPLEMENT(kep3::udpla::jpl_lp_static<kep3::udpla::body::earth>, kep3::detail::planet_iface)
+TANUKI_S11N_WRAP_EXPORT_IMPLEMENT(kep3::udpla::jpl_lp_static<kep3::udpla::body::mars>, kep3::detail::planet_iface)
+TANUKI_S11N_WRAP_EXPORT_IMPLEMENT(kep3::udpla::jpl_lp_static<kep3::udpla::body::jupiter>, kep3::detail::planet_iface)
+TANUKI_S11N_WRAP_EXPORT_IMPLEMENT(kep3::udpla::jpl_lp_static<kep3::udpla::body::saturn>, kep3::detail::planet_iface)
+TANUKI_S11N_WRAP_EXPORT_IMPLEMENT(kep3::udpla::jpl_lp_static<kep3::udpla::body::uranus>, kep3::detail::planet_iface)
+TANUKI_S11N_WRAP_EXPORT_IMPLEMENT(kep3::udpla::jpl_lp_static<kep3::udpla::body::neptune>, kep3::detail::planet_iface)
+// NOLINTEND
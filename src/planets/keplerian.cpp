@@ -11,9 +11,12 @@
 #include <limits>
 
 #include <chrono>
+#include <span>
 #include <stdexcept>
 #include <string>
+#include <vector>
 
+#include <boost/safe_numerics/safe_integer.hpp>
 #include <fmt/core.h>
 #include <fmt/ranges.h>
 
@@ -23,6 +26,7 @@
 #include <kep3/core_astro/ic2eq2ic.hpp>
 #include <kep3/core_astro/ic2par2ic.hpp>
 #include <kep3/core_astro/propagate_lagrangian.hpp>
+#include <kep3/core_astro/propagate_lagrangian_batch.hpp>
 #include <kep3/epoch.hpp>
 #include <kep3/planet.hpp>
 #include <kep3/planets/keplerian.hpp>
@@ -104,6 +108,44 @@ std::array<std::array<double, 3>, 2> keplerian::eph(double mjd2000) const
     return retval;
 }
 
+// The states are propagated from m_pos_vel_0 by the batch propagator, which keeps the Kepler
+// solves of many epochs in flight at once, instead of calling eph() in a loop.
+void keplerian::eph_into(std::span<const double> mjd2000s, std::span<double> out) const
+{
+    kep3::detail::check_eph_into_sizes(mjd2000s.size(), out.size());
+    const auto size = mjd2000s.size();
+    using size_type = decltype(mjd2000s.size());
+    // 1 - We prepare the batch: all states start from m_pos_vel_0.
+    std::array<std::vector<double>, 3> r, v;
+    for (auto j = 0u; j < 3u; ++j) {
+        r[j].assign(size, m_pos_vel_0[0][j]);
+        v[j].assign(size, m_pos_vel_0[1][j]);
+    }
+    std::vector<double> dts(size);
+    const double ref_mjd2000 = m_ref_epoch.mjd2000();
+    for (size_type i = 0u; i < size; ++i) {
+        dts[i] = (mjd2000s[i] - ref_mjd2000) * kep3::DAY2SEC;
+    }
+    // 2 - We propagate.
+    kep3::propagate_lagrangian_batch({{r[0], r[1], r[2]}, {v[0], v[1], v[2]}}, dts, m_mu_central_body);
+    // 3 - We interleave the result.
+    for (size_type i = 0u; i < size; ++i) {
+        for (auto j = 0u; j < 3u; ++j) {
+            out[6u * i + j] = r[j][i];
+            out[6u * i + 3u + j] = v[j][i];
+        }
+    }
+}
+
+std::vector<double> keplerian::eph_v(const std::vector<double> &mjd2000s) const
+{
+    using size_type = std::vector<double>::size_type;
+    std::vector<double> retval;
+    retval.resize(boost::safe_numerics::safe<size_type>(mjd2000s.size()) * 6);
+    eph_into(mjd2000s, retval);
+    return retval;
+}
+
 std::string keplerian::get_name() const
 {
     return m_name;
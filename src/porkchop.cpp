@@ -0,0 +1,92 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+#include <boost/safe_numerics/safe_integer.hpp>
+#include <fmt/core.h>
+#include <oneapi/tbb/blocked_range.h>
+#include <oneapi/tbb/parallel_for.h>
+
+#include <kep3/core_astro/constants.hpp>
+#include <kep3/detail/lambert_batch_buffers.hpp>
+#include <kep3/planet.hpp>
+#include <kep3/porkchop.hpp>
+
+namespace kep3
+{
+
+porkchop_data porkchop(const planet &pl0, const planet &pl1, const std::vector<double> &t0s,
+                       const std::vector<double> &tofs, double mu, bool cw)
+{
+    // 0 - Sanity checks.
+    if (mu <= 0) {
+        throw std::domain_error("porkchop: Gravity parameter is zero or negative!");
+    }
+    for (auto tof : tofs) {
+        if (!(tof > 0)) {
+            throw std::domain_error(
+                fmt::format("porkchop: all times of flight must be positive, but {} was found", tof));
+        }
+    }
+    const auto n_dep = t0s.size();
+    const auto n_tof = tofs.size();
+    using size_type = std::vector<double>::size_type;
+    const size_type n_cells = boost::safe_numerics::safe<size_type>(n_dep) * n_tof;
+
+    // 1 - Ephemerides: one call per grid axis.
+    const auto eph0 = pl0.eph_v(t0s);
+    std::vector<double> t1s(n_cells);
+    for (decltype(t0s.size()) i = 0u; i < n_dep; ++i) {
+        for (decltype(tofs.size()) j = 0u; j < n_tof; ++j) {
+            t1s[i * n_tof + j] = t0s[i] + tofs[j];
+        }
+    }
+    const auto eph1 = pl1.eph_v(t1s);
+
+    // 2 - Lambert problems, solved in parallel one row (departure epoch) at a time. Cells where
+    // the Lambert problem is not defined get NaN velocities, hence NaN delta-vs.
+    porkchop_data retval;
+    retval.n_departures = n_dep;
+    retval.n_tofs = n_tof;
+    retval.dv0.resize(n_cells);
+    retval.dv1.resize(n_cells);
+    oneapi::tbb::parallel_for(oneapi::tbb::blocked_range<size_type>(0u, n_dep), [&](const auto &range) {
+        detail::lambert_batch_buffers row(n_tof);
+        for (auto i = range.begin(); i != range.end(); ++i) {
+            const auto *e0 = eph0.data() + 6u * i;
+            for (decltype(tofs.size()) j = 0u; j < n_tof; ++j) {
+                const auto *e1 = eph1.data() + 6u * (i * n_tof + j);
+                for (auto k = 0u; k < 3u; ++k) {
+                    row.r0[k][j] = e0[k];
+                    row.r1[k][j] = e1[k];
+                }
+                row.tof[j] = tofs[j] * kep3::DAY2SEC;
+                row.mu[j] = mu;
+                row.cw[j] = cw;
+            }
+            row.solve(n_tof);
+            // 3 - Delta-vs.
+            for (decltype(tofs.size()) j = 0u; j < n_tof; ++j) {
+                const auto *e1 = eph1.data() + 6u * (i * n_tof + j);
+                const double dx0 = row.v0[0][j] - e0[3], dy0 = row.v0[1][j] - e0[4], dz0 = row.v0[2][j] - e0[5];
+                const double dx1 = row.v1[0][j] - e1[3], dy1 = row.v1[1][j] - e1[4], dz1 = row.v1[2][j] - e1[5];
+                retval.dv0[i * n_tof + j] = std::sqrt(dx0 * dx0 + dy0 * dy0 + dz0 * dz0);
+                retval.dv1[i * n_tof + j] = std::sqrt(dx1 * dx1 + dy1 * dy1 + dz1 * dz1);
+            }
+        }
+    });
+
+    return retval;
+}
+
+} // namespace kep3
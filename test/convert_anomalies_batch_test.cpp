@@ -0,0 +1,121 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <kep3/core_astro/convert_anomalies.hpp>
+#include <kep3/core_astro/convert_anomalies_batch.hpp>
+
+#include "catch.hpp"
+
+using batch_t = void (*)(std::span<const double>, std::span<const double>, std::span<double>);
+using scalar_t = double (*)(double, double);
+
+// Checks a batch conversion against its scalar version on N random pairs (x, ecc).
+void compare(batch_t batch, scalar_t scalar, std::vector<double> x, std::vector<double> ecc, double tol)
+{
+    std::vector<double> out(x.size());
+    batch(x, ecc, out);
+    for (decltype(x.size()) i = 0u; i < x.size(); ++i) {
+        const double ref = scalar(x[i], ecc[i]);
+        REQUIRE(std::abs(out[i] - ref) <= tol * std::max(1., std::abs(ref)));
+    }
+    // In place.
+    batch(x, ecc, x);
+    REQUIRE(x == out);
+}
+
+TEST_CASE("elliptic")
+{
+    // NOLINTNEXTLINE(cert-msc32-c, cert-msc51-cpp)
+    std::mt19937 rng_engine(3242342u);
+    std::uniform_real_distribution<double> M_d(-1e8, 1e8);
+    std::uniform_real_distribution<double> angle_d(-kep3::pi, kep3::pi);
+    // The number of points is not a multiple of the vector width, so that also the remainder is exercised.
+    const unsigned N = 10003u;
+    for (auto [min_ecc, max_ecc] : {std::pair{0., 0.5}, std::pair{0.5, 0.9}, std::pair{0.9, 0.999999}}) {
+        std::uniform_real_distribution<double> ecc_d(min_ecc, max_ecc);
+        std::vector<double> M(N), ecc(N), angle(N);
+        for (auto i = 0u; i < N; ++i) {
+            M[i] = M_d(rng_engine);
+            ecc[i] = ecc_d(rng_engine);
+            angle[i] = angle_d(rng_engine);
+        }
+        // Some mean anomalies beyond the fast range reduction, and close to zero.
+        M[0] = 3e10;
+        M[1] = -1e9;
+        M[2] = 1e-12;
+        M[3] = 0.;
+        compare(&kep3::m2e_batch, &kep3::m2e, M, ecc, 1e-13);
+        compare(&kep3::m2f_batch, &kep3::m2f, M, ecc, 1e-13);
+        compare(&kep3::e2m_batch, &kep3::e2m, angle, ecc, 0.);
+        compare(&kep3::f2m_batch, &kep3::f2m, angle, ecc, 0.);
+        compare(&kep3::e2f_batch, &kep3::e2f, angle, ecc, 0.);
+        compare(&kep3::f2e_batch, &kep3::f2e, angle, ecc, 0.);
+    }
+}
+
+TEST_CASE("hyperbolic")
+{
+    // NOLINTNEXTLINE(cert-msc32-c, cert-msc51-cpp)
+    std::mt19937 rng_engine(2342u);
+    std::uniform_real_distribution<double> logN_d(-6., 6.);
+    std::uniform_real_distribution<double> logecc_d(-4., 2.);
+    std::uniform_real_distribution<double> angle_d(-1., 1.);
+    const unsigned N = 10003u;
+    std::vector<double> Ns(N), ecc(N), angle(N);
+    for (auto i = 0u; i < N; ++i) {
+        Ns[i] = (i % 2u == 0u ? 1. : -1.) * std::pow(10., logN_d(rng_engine));
+        ecc[i] = 1. + std::pow(10., logecc_d(rng_engine));
+        // Within the asymptotes.
+        angle[i] = angle_d(rng_engine) * std::acos(-1. / ecc[i]);
+    }
+    compare(&kep3::n2h_batch, &kep3::n2h, Ns, ecc, 1e-12);
+    compare(&kep3::n2f_batch, &kep3::n2f, Ns, ecc, 1e-12);
+    compare(&kep3::h2n_batch, &kep3::h2n, angle, ecc, 0.);
+    compare(&kep3::f2n_batch, &kep3::f2n, angle, ecc, 0.);
+    compare(&kep3::h2f_batch, &kep3::h2f, angle, ecc, 0.);
+    compare(&kep3::f2h_batch, &kep3::f2h, angle, ecc, 0.);
+    compare(&kep3::zeta2f_batch, &kep3::zeta2f, angle, ecc, 0.);
+    compare(&kep3::f2zeta_batch, &kep3::f2zeta, angle, ecc, 0.);
+}
+
+TEST_CASE("nan_propagation")
+{
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    std::vector<double> x = {1., 1., nan, 1.};
+    std::vector<double> ecc = {0.1, 1.1, 0.1, nan};
+    std::vector<double> out(4u);
+    kep3::m2e_batch(x, ecc, out);
+    REQUIRE(std::isfinite(out[0]));
+    REQUIRE(std::isnan(out[1]));
+    REQUIRE(std::isnan(out[2]));
+    REQUIRE(std::isnan(out[3]));
+    ecc = {1.1, 0.1, 1.1, nan};
+    kep3::n2h_batch(x, ecc, out);
+    REQUIRE(std::isfinite(out[0]));
+    REQUIRE(std::isnan(out[1]));
+    REQUIRE(std::isnan(out[2]));
+    REQUIRE(std::isnan(out[3]));
+}
+
+TEST_CASE("sizes")
+{
+    std::vector<double> x(3u), ecc(2u), out(3u);
+    REQUIRE_THROWS_AS(kep3::m2e_batch(x, ecc, out), std::invalid_argument);
+    REQUIRE_THROWS_AS(kep3::f2zeta_batch(x, ecc, out), std::invalid_argument);
+    REQUIRE_NOTHROW(kep3::m2e_batch({}, {}, {}));
+}
@@ -7,11 +7,13 @@
 // Public License v. 2.0. If a copy of the MPL was not distributed
 // with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
 
+#include <algorithm>
 #include <cmath>
 #include <iostream>
 #include <random>
 
 #include <kep3/core_astro/convert_anomalies.hpp>
+#include <kep3/core_astro/kepler_equations.hpp>
 #include <stdexcept>
 
 #include "catch.hpp"
@@ -59,6 +61,58 @@ TEST_CASE("m2e")
     }
 }
 
+TEST_CASE("m2e_fixed")
+{
+    // NOLINTNEXTLINE(cert-msc32-c, cert-msc51-cpp)
+    std::mt19937 rng_engine(4563u);
+    std::uniform_real_distribution<double> M_d(-1e6, 1e6);
+    std::uniform_real_distribution<double> log_d(-12., 0.);
+    // Testing on N random calls against the Newton solver, for ecc in [0, 1) and 1 - ecc down to 1e-12.
+    unsigned N = 100000;
+    for (auto i = 0u; i < N; ++i) {
+        double mean_anom = M_d(rng_engine);
+        double ecc = (i % 2u == 0u) ? 1. - std::pow(10., log_d(rng_engine)) : std::pow(10., log_d(rng_engine));
+        double E = m2e(mean_anom, ecc);
+        double E_fixed = m2e(mean_anom, ecc, kep3::kepler_solver::fixed);
+        // Both are accurate to a few ulps times the condition number of Kepler's equation.
+        REQUIRE(std::abs(E_fixed - E) <= 2e-15 / (1. - ecc * std::cos(E)));
+        REQUIRE(kep3::m2f(mean_anom, ecc, kep3::kepler_solver::fixed) == kep3::e2f(E_fixed, ecc));
+    }
+    // Small and huge mean anomalies (the latter reduced as in the Newton solver).
+    for (double mean_anom : {0., 1e-300, -1e-10, kep3::pi, -kep3::pi, 3e8, 5e8, -1e15}) {
+        for (double ecc : {0., 0.5, 0.999999}) {
+            double E = m2e(mean_anom, ecc);
+            REQUIRE(std::abs(m2e(mean_anom, ecc, kep3::kepler_solver::fixed) - E)
+                    <= 2e-15 / (1. - ecc * std::cos(E)));
+        }
+    }
+    REQUIRE(m2e(1.2, 0.1, kep3::kepler_solver::newton) == m2e(1.2, 0.1));
+    REQUIRE(!std::isfinite(m2e(0.3, 1.1, kep3::kepler_solver::fixed)));
+    REQUIRE(!std::isfinite(kep3::m2f(0.3, 1.1, kep3::kepler_solver::fixed)));
+}
+
+TEST_CASE("n2h")
+{
+    // NOLINTNEXTLINE(cert-msc32-c, cert-msc51-cpp)
+    std::mt19937 rng_engine(4564u);
+    std::uniform_real_distribution<double> log_ecc_d(-4., 3.), log_N_d(-10., 6.);
+    // The starter brackets the solution, for ecc - 1 in [1e-4, 1e3] and |N| in [1e-10, 1e6].
+    unsigned N = 100000;
+    for (auto i = 0u; i < N; ++i) {
+        double ecc = 1. + std::pow(10., log_ecc_d(rng_engine));
+        double mean_anom = ((i % 2u == 0u) ? 1. : -1.) * std::pow(10., log_N_d(rng_engine));
+        double H = kep3::n2h(mean_anom, ecc);
+        REQUIRE(std::abs(kep3::kepH(H, mean_anom, ecc)) <= 4e-15 * std::max(1., std::abs(mean_anom)));
+        const auto [guess, lb, ub] = kep3::kepH_starter(mean_anom, ecc);
+        REQUIRE(lb <= H);
+        REQUIRE(H <= ub);
+        REQUIRE(lb <= guess);
+        REQUIRE(guess <= ub);
+    }
+    REQUIRE(kep3::n2h(0., 1.5) == 0.);
+    REQUIRE(kep3::n2h(-2.3, 1.5) == -kep3::n2h(2.3, 1.5));
+}
+
 TEST_CASE("f2e")
 {
     using Catch::Detail::Approx;
@@ -0,0 +1,196 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <random>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include <kep3/core_astro/constants.hpp>
+#include <kep3/core_astro/elements_batch.hpp>
+#include <kep3/core_astro/eq2par2eq.hpp>
+#include <kep3/core_astro/ic2eq2ic.hpp>
+#include <kep3/core_astro/ic2par2ic.hpp>
+
+#include "catch.hpp"
+
+// A batch of N entries with six components, as a structure of arrays.
+struct soa6 {
+    explicit soa6(std::size_t N) : data(6u * N), N(N) {}
+    [[nodiscard]] kep3::elements_batch_input in() const
+    {
+        return {span(0), span(1), span(2), span(3), span(4), span(5)};
+    }
+    [[nodiscard]] kep3::elements_batch_output out()
+    {
+        return {span(0), span(1), span(2), span(3), span(4), span(5)};
+    }
+    [[nodiscard]] std::span<double> span(std::size_t j)
+    {
+        return {data.data() + j * N, N};
+    }
+    [[nodiscard]] std::span<const double> span(std::size_t j) const
+    {
+        return {data.data() + j * N, N};
+    }
+    [[nodiscard]] std::array<double, 6> get(std::size_t i) const
+    {
+        return {data[i], data[N + i], data[2u * N + i], data[3u * N + i], data[4u * N + i], data[5u * N + i]};
+    }
+    void set(std::size_t i, const std::array<double, 6> &v)
+    {
+        for (auto j = 0u; j < 6u; ++j) {
+            data[j * N + i] = v[j];
+        }
+    }
+    std::vector<double> data;
+    std::size_t N;
+};
+
+std::array<double, 6> flatten(const std::array<std::array<double, 3>, 2> &pos_vel)
+{
+    return {pos_vel[0][0], pos_vel[0][1], pos_vel[0][2], pos_vel[1][0], pos_vel[1][1], pos_vel[1][2]};
+}
+
+std::array<std::array<double, 3>, 2> unflatten(const std::array<double, 6> &v)
+{
+    return {{{v[0], v[1], v[2]}, {v[3], v[4], v[5]}}};
+}
+
+std::vector<std::array<double, 6>> entries(const soa6 &b)
+{
+    std::vector<std::array<double, 6>> retval;
+    for (std::size_t i = 0u; i < b.N; ++i) {
+        retval.push_back(b.get(i));
+    }
+    return retval;
+}
+
+// Checks that the entries of the batch out are within tol (relative to max(1, |ref|)) of the references.
+void check(const soa6 &out, const std::vector<std::array<double, 6>> &refs, double tol)
+{
+    for (decltype(refs.size()) i = 0u; i < refs.size(); ++i) {
+        const auto v = out.get(i);
+        for (auto j = 0u; j < 6u; ++j) {
+            REQUIRE(std::abs(v[j] - refs[i][j]) <= tol * std::max(1., std::abs(refs[i][j])));
+        }
+    }
+}
+
+// Random elliptic and hyperbolic orbits, as Keplerian elements. The number of entries is
+// not a multiple of the block size.
+soa6 random_elements(std::size_t N)
+{
+    // NOLINTNEXTLINE(cert-msc32-c, cert-msc51-cpp)
+    std::mt19937 rng_engine(1231u);
+    std::uniform_real_distribution<double> sma_d(1.1, 10.), ecc_d(0.01, 0.9), hecc_d(1.1, 3.);
+    std::uniform_real_distribution<double> inc_d(0.01, kep3::pi - 0.01), angle_d(0.01, 2 * kep3::pi - 0.01);
+    std::uniform_real_distribution<double> unit_d(0.01, 0.9);
+    soa6 retval(N);
+    for (std::size_t i = 0u; i < N; ++i) {
+        const bool hyperbolic = i % 3u == 0u;
+        const double ecc = hyperbolic ? hecc_d(rng_engine) : ecc_d(rng_engine);
+        const double sma = hyperbolic ? -sma_d(rng_engine) : sma_d(rng_engine);
+        // For hyperbolae, the true anomaly within the asymptotes.
+        const double f = hyperbolic ? unit_d(rng_engine) * std::acos(-1. / ecc) : angle_d(rng_engine);
+        retval.set(i, {sma, ecc, inc_d(rng_engine), angle_d(rng_engine), angle_d(rng_engine), f});
+    }
+    return retval;
+}
+
+TEST_CASE("ic2par_par2ic")
+{
+    const std::size_t N = 1001u;
+    const auto par = random_elements(N);
+    std::vector<std::array<double, 6>> ref_ic, ref_par;
+    for (std::size_t i = 0u; i < N; ++i) {
+        ref_ic.push_back(flatten(kep3::par2ic(par.get(i), 1.3)));
+        ref_par.push_back(kep3::ic2par(unflatten(ref_ic.back()), 1.3));
+    }
+    soa6 ic(N), par_back(N);
+    kep3::par2ic_batch(par.in(), 1.3, ic.out());
+    check(ic, ref_ic, 1e-14);
+    kep3::ic2par_batch(ic.in(), 1.3, par_back.out());
+    check(par_back, ref_par, 1e-12);
+    check(par_back, entries(par), 1e-9);
+    // In place.
+    auto buf = ic;
+    kep3::ic2par_batch(buf.in(), 1.3, buf.out());
+    REQUIRE(buf.data == par_back.data);
+    kep3::par2ic_batch(buf.in(), 1.3, buf.out());
+    soa6 ic2(N);
+    kep3::par2ic_batch(par_back.in(), 1.3, ic2.out());
+    REQUIRE(buf.data == ic2.data);
+    // Invalid elements.
+    auto bad = par;
+    bad.set(500u, {1., 1.5, 0.1, 0.1, 0.1, 0.1});
+    REQUIRE_THROWS_AS(kep3::par2ic_batch(bad.in(), 1.3, ic.out()), std::domain_error);
+    bad.set(500u, {-1., 1.5, 0.1, 0.1, 0.1, kep3::pi});
+    REQUIRE_THROWS_AS(kep3::par2ic_batch(bad.in(), 1.3, ic.out()), std::domain_error);
+    // Sizes.
+    soa6 small(3u);
+    REQUIRE_THROWS_AS(kep3::ic2par_batch(ic.in(), 1.3, small.out()), std::invalid_argument);
+    // Empty batches.
+    soa6 empty(0u);
+    REQUIRE_NOTHROW(kep3::ic2par_batch(empty.in(), 1.3, empty.out()));
+}
+
+TEST_CASE("ic2eq_eq2ic")
+{
+    const std::size_t N = 1001u;
+    const auto par = random_elements(N);
+    soa6 ic(N);
+    kep3::par2ic_batch(par.in(), 1.3, ic.out());
+    for (const bool retrogade : {false, true}) {
+        std::vector<std::array<double, 6>> ref_eq, ref_ic;
+        for (std::size_t i = 0u; i < N; ++i) {
+            ref_eq.push_back(kep3::ic2eq(unflatten(ic.get(i)), 1.3, retrogade));
+            ref_ic.push_back(flatten(kep3::eq2ic(ref_eq.back(), 1.3, retrogade)));
+        }
+        soa6 eq(N), ic_back(N);
+        kep3::ic2eq_batch(ic.in(), 1.3, retrogade, eq.out());
+        check(eq, ref_eq, 1e-12);
+        kep3::eq2ic_batch(eq.in(), 1.3, retrogade, ic_back.out());
+        check(ic_back, ref_ic, 1e-11);
+        check(ic_back, entries(ic), 1e-11);
+        // In place.
+        auto buf = ic;
+        kep3::ic2eq_batch(buf.in(), 1.3, retrogade, buf.out());
+        REQUIRE(buf.data == eq.data);
+        kep3::eq2ic_batch(buf.in(), 1.3, retrogade, buf.out());
+        REQUIRE(buf.data == ic_back.data);
+    }
+}
+
+TEST_CASE("par2eq_eq2par")
+{
+    const std::size_t N = 1001u;
+    const auto par = random_elements(N);
+    for (const bool retrogade : {false, true}) {
+        std::vector<std::array<double, 6>> ref_eq, ref_par;
+        for (std::size_t i = 0u; i < N; ++i) {
+            ref_eq.push_back(kep3::par2eq(par.get(i), retrogade));
+            ref_par.push_back(kep3::eq2par(ref_eq.back(), retrogade));
+        }
+        soa6 eq(N), par_back(N);
+        kep3::par2eq_batch(par.in(), retrogade, eq.out());
+        check(eq, ref_eq, 1e-15);
+        kep3::eq2par_batch(eq.in(), retrogade, par_back.out());
+        check(par_back, ref_par, 1e-15);
+        // In place.
+        auto buf = par;
+        kep3::par2eq_batch(buf.in(), retrogade, buf.out());
+        REQUIRE(buf.data == eq.data);
+        kep3::eq2par_batch(buf.in(), retrogade, buf.out());
+        REQUIRE(buf.data == par_back.data);
+    }
+}
@@ -0,0 +1,109 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <numeric>
+#include <thread>
+
+#include <kep3/core_astro/convert_anomalies.hpp>
+#include <kep3/core_astro/propagate_lagrangian.hpp>
+#include <kep3/detail/lambert_batch_buffers.hpp>
+#include <kep3/instrumentation.hpp>
+#include <kep3/lambert_batch.hpp>
+#include <kep3/lambert_problem.hpp>
+
+#include "catch.hpp"
+
+namespace ki = kep3::instrumentation;
+
+// Total number of calls recorded for the solver s.
+unsigned long long calls(const ki::snapshot &snap, ki::solver s)
+{
+    const auto &h = snap.iters[static_cast<unsigned>(s)];
+    return std::accumulate(h.begin(), h.end(), 0ull);
+}
+
+unsigned long long count(const ki::snapshot &snap, ki::event e)
+{
+    return snap.events[static_cast<unsigned>(e)];
+}
+
+TEST_CASE("counters")
+{
+    ki::reset();
+    // Some solver calls.
+    kep3::m2e(0.3, 0.1);
+    kep3::m2e(1.3, 0.5);
+    kep3::n2h(2.3, 1.5);
+    std::array<std::array<double, 3>, 2> pos_vel = {{{1., 0.1, 0.}, {0.1, 1., 0.}}};
+    kep3::propagate_lagrangian(pos_vel, 10., 1.);
+    pos_vel = {{{1., 0.1, 0.}, {0.1, 2., 0.}}};
+    kep3::propagate_lagrangian(pos_vel, 10., 1.);
+    const kep3::lambert_problem lp({1., 0., 0.}, {0., 1., 0.}, 20., 1., false, 2u);
+    // ... also from another thread.
+    std::thread([]() { kep3::m2e(2.3, 0.9); }).join();
+
+    const auto snap = ki::get_snapshot();
+    if (ki::enabled()) {
+        REQUIRE(calls(snap, ki::solver::m2e) == 3u);
+        REQUIRE(calls(snap, ki::solver::n2h) == 1u);
+        REQUIRE(calls(snap, ki::solver::propagate_lagrangian_elliptic) == 1u);
+        REQUIRE(calls(snap, ki::solver::propagate_lagrangian_hyperbolic) == 1u);
+        REQUIRE(calls(snap, ki::solver::lambert_householder) == 5u);
+        // The histogram matches the iterations reported by the Lambert problem.
+        for (auto it : lp.get_iters()) {
+            REQUIRE(snap.iters[static_cast<unsigned>(ki::solver::lambert_householder)][it] > 0u);
+        }
+        REQUIRE(count(snap, ki::event::x2tof_battin) + count(snap, ki::event::x2tof_lagrange)
+                    + count(snap, ki::event::x2tof_lancaster)
+                > 0u);
+        REQUIRE(count(snap, ki::event::m2e_throw) == 0u);
+    } else {
+        REQUIRE(snap.iters == decltype(snap.iters){});
+        REQUIRE(snap.events == decltype(snap.events){});
+    }
+
+    // Reset.
+    ki::reset();
+    REQUIRE(ki::get_snapshot().iters == decltype(snap.iters){});
+    REQUIRE(ki::get_snapshot().events == decltype(snap.events){});
+}
+
+TEST_CASE("batch_lambert")
+{
+    // The batch Lambert solver records the same iterations and events as kep3::lambert_problem.
+    const std::size_t N = 37u;
+    kep3::detail::lambert_batch_buffers buf(N);
+    for (std::size_t i = 0u; i < N; ++i) {
+        const double theta = 0.1 + 0.15 * static_cast<double>(i);
+        buf.r0[0][i] = 1.;
+        buf.r1[0][i] = 1.5 * std::cos(theta);
+        buf.r1[1][i] = 1.5 * std::sin(theta);
+        buf.r1[2][i] = 0.1;
+        buf.tof[i] = 0.3 + 0.25 * static_cast<double>(i);
+        buf.mu[i] = 1.;
+        buf.cw[i] = static_cast<std::uint8_t>(i % 2u);
+    }
+    ki::reset();
+    kep3::lambert_solve_batch(buf.input(), buf.output());
+    const auto batch = ki::get_snapshot();
+    ki::reset();
+    for (std::size_t i = 0u; i < N; ++i) {
+        const kep3::lambert_problem lp({buf.r0[0][i], buf.r0[1][i], buf.r0[2][i]},
+                                       {buf.r1[0][i], buf.r1[1][i], buf.r1[2][i]}, buf.tof[i], buf.mu[i],
+                                       buf.cw[i] != 0u, 0u);
+    }
+    const auto scalar = ki::get_snapshot();
+    REQUIRE(batch.iters == scalar.iters);
+    REQUIRE(batch.events == scalar.events);
+    ki::reset();
+}
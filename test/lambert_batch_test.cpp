@@ -0,0 +1,91 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <array>
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include <kep3/detail/lambert_batch_buffers.hpp>
+#include <kep3/lambert_batch.hpp>
+#include <kep3/lambert_problem.hpp>
+
+#include "catch.hpp"
+#include "test_helpers.hpp"
+
+using batch_data = kep3::detail::lambert_batch_buffers;
+
+TEST_CASE("batch_vs_object")
+{
+    // Here we test that the batch solver returns the same zero revolutions
+    // solutions as kep3::lambert_problem on randomly generated problems. N is
+    // not a multiple of the lane width, so that also the remainder is exercised.
+    const unsigned N = 10003u;
+    batch_data data(N);
+
+    // NOLINTNEXTLINE(cert-msc32-c, cert-msc51-cpp)
+    std::mt19937 rng_engine(12201203u);
+    std::uniform_int_distribution<unsigned> cw_d(0, 1);
+    std::uniform_real_distribution<double> r_d(-2, 2);
+    std::uniform_real_distribution<double> tof_d(0.1, 40.);
+    std::uniform_real_distribution<double> mu_d(0.9, 1.1);
+    for (auto i = 0u; i < N; ++i) {
+        for (auto j = 0u; j < 3u; ++j) {
+            data.r0[j][i] = r_d(rng_engine);
+            data.r1[j][i] = r_d(rng_engine);
+        }
+        data.tof[i] = tof_d(rng_engine);
+        data.mu[i] = mu_d(rng_engine);
+        data.cw[i] = static_cast<std::uint8_t>(cw_d(rng_engine));
+    }
+    kep3::lambert_solve_batch(data.input(), data.output());
+
+    for (auto i = 0u; i < N; ++i) {
+        kep3::lambert_problem lp({data.r0[0][i], data.r0[1][i], data.r0[2][i]},
+                                 {data.r1[0][i], data.r1[1][i], data.r1[2][i]}, data.tof[i], data.mu[i],
+                                 data.cw[i] != 0u, 0u);
+        REQUIRE(kep3_tests::floating_point_error(lp.get_x()[0], data.x[i]) < 1e-12);
+        REQUIRE(lp.get_iters()[0] == data.iters[i]);
+        REQUIRE(kep3_tests::floating_point_error_vector(lp.get_v0()[0], {data.v0[0][i], data.v0[1][i], data.v0[2][i]})
+                < 1e-12);
+        REQUIRE(kep3_tests::floating_point_error_vector(lp.get_v1()[0], {data.v1[0][i], data.v1[1][i], data.v1[2][i]})
+                < 1e-12);
+    }
+}
+
+TEST_CASE("batch_throws")
+{
+    batch_data data(2u);
+    data.r0[0] = {1., 1.};
+    data.r1[1] = {1., 1.};
+    data.tof = {1., 1.};
+    data.mu = {1., 1.};
+    REQUIRE_NOTHROW(kep3::lambert_solve_batch(data.input(), data.output()));
+    // Inconsistent sizes.
+    auto out = data.output();
+    out.x = out.x.first(1);
+    REQUIRE_THROWS_AS(kep3::lambert_solve_batch(data.input(), out), std::invalid_argument);
+    // Non positive times of flight and gravity parameters.
+    data.tof[1] = -1.;
+    REQUIRE_THROWS_AS(kep3::lambert_solve_batch(data.input(), data.output()), std::domain_error);
+    data.tof[1] = 1.;
+    data.mu[0] = 0.;
+    REQUIRE_THROWS_AS(kep3::lambert_solve_batch(data.input(), data.output()), std::domain_error);
+    // Undefined direction of motion, detected before any output is written.
+    data.mu[0] = 1.;
+    data.r1[1][1] = 0.;
+    data.r1[2][1] = 1.;
+    data.x = {42., 42.};
+    REQUIRE_THROWS_AS(kep3::lambert_solve_batch(data.input(), data.output()), std::domain_error);
+    REQUIRE(data.x[0] == 42.);
+    // Empty batches are allowed.
+    batch_data empty(0u);
+    REQUIRE_NOTHROW(kep3::lambert_solve_batch(empty.input(), empty.output()));
+}
@@ -0,0 +1,112 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <stdexcept>
+
+#include <kep3/lambert_problem.hpp>
+#include <kep3/lambert_problem_fixed.hpp>
+
+#include "catch.hpp"
+#include "test_helpers.hpp"
+
+// We count the calls to the global allocator, to check that the fixed
+// capacity Lambert solver never uses it.
+static std::atomic<unsigned long> n_allocations{0u};
+
+void *operator new(std::size_t size)
+{
+    ++n_allocations;
+    if (void *ptr = std::malloc(size == 0u ? 1u : size)) {
+        return ptr;
+    }
+    throw std::bad_alloc{};
+}
+
+void operator delete(void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+TEST_CASE("construct")
+{
+    REQUIRE_NOTHROW(kep3::lambert_problem_fixed<5>{{1., 0., 0.}, {0., 1., 0.}, 3 * kep3::pi / 2, 1., true});
+    REQUIRE_THROWS_AS((kep3::lambert_problem_fixed<5>{{1., 0., 0.}, {0., 1., 0.}, 3 * kep3::pi / 2, -1.2, true}),
+                      std::domain_error);
+    REQUIRE_THROWS_AS((kep3::lambert_problem_fixed<5>{{1., 0., 0.}, {0., 1., 0.}, -3 * kep3::pi / 2, 1.2, true}),
+                      std::domain_error);
+    REQUIRE_THROWS_AS((kep3::lambert_problem_fixed<5>{{0, 0., 1.}, {0., 1., 0.}, 3 * kep3::pi / 2, 1.2, true}),
+                      std::domain_error);
+    // The number of revolutions is cropped to the capacity.
+    kep3::lambert_problem_fixed<2> lp{{1., 0., 0.}, {0., 1., 0.}, 100., 1., false, 100u};
+    REQUIRE(lp.get_Nmax() == 2u);
+    REQUIRE(lp.get_x().size() == 5u);
+    REQUIRE(lp.get_v0().size() == 5u);
+    REQUIRE(lp.get_v1().size() == 5u);
+    REQUIRE(lp.get_iters().size() == 5u);
+    kep3::lambert_problem_fixed<0> lp0{};
+    REQUIRE(lp0.get_Nmax() == 0u);
+    REQUIRE(lp0.get_x().size() == 1u);
+}
+
+TEST_CASE("fixed_vs_object")
+{
+    // Here we test that on randomly generated problems the fixed capacity solver
+    // returns the same solutions as kep3::lambert_problem.
+    // NOLINTNEXTLINE(cert-msc32-c, cert-msc51-cpp)
+    std::mt19937 rng_engine(12201203u);
+    std::uniform_int_distribution<unsigned> cw_d(0, 1);
+    std::uniform_real_distribution<double> r_d(-2, 2);
+    std::uniform_real_distribution<double> tof_d(2., 40.);
+    std::uniform_real_distribution<double> mu_d(0.9, 1.1);
+    for (auto i = 0u; i < 1000u; ++i) {
+        const std::array<double, 3> r0{{r_d(rng_engine), r_d(rng_engine), r_d(rng_engine)}};
+        const std::array<double, 3> r1{{r_d(rng_engine), r_d(rng_engine), r_d(rng_engine)}};
+        const double tof = tof_d(rng_engine);
+        const double mu = mu_d(rng_engine);
+        const bool cw = static_cast<bool>(cw_d(rng_engine));
+        const kep3::lambert_problem lp(r0, r1, tof, mu, cw, 5u);
+        const kep3::lambert_problem_fixed<5> lpf(r0, r1, tof, mu, cw);
+        REQUIRE(lp.get_Nmax() == lpf.get_Nmax());
+        for (auto j = 0u; j < lp.get_x().size(); ++j) {
+            REQUIRE(lp.get_x()[j] == lpf.get_x()[j]);
+            REQUIRE(lp.get_iters()[j] == lpf.get_iters()[j]);
+            REQUIRE(lp.get_v0()[j] == lpf.get_v0()[j]);
+            REQUIRE(lp.get_v1()[j] == lpf.get_v1()[j]);
+        }
+    }
+}
+
+TEST_CASE("no_allocations")
+{
+    // NOLINTNEXTLINE(cert-msc32-c, cert-msc51-cpp)
+    std::mt19937 rng_engine(12201203u);
+    std::uniform_real_distribution<double> r_d(-2, 2);
+    std::uniform_real_distribution<double> tof_d(2., 40.);
+    double checksum = 0.;
+    const auto before = n_allocations.load();
+    for (auto i = 0u; i < 100u; ++i) {
+        const kep3::lambert_problem_fixed<10> lp({r_d(rng_engine), r_d(rng_engine), r_d(rng_engine)},
+                                                 {r_d(rng_engine), r_d(rng_engine), r_d(rng_engine)},
+                                                 tof_d(rng_engine));
+        checksum += lp.get_v0()[0][0];
+    }
+    const auto after = n_allocations.load();
+    REQUIRE(after == before);
+    REQUIRE(std::isfinite(checksum));
+}
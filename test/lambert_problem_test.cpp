@@ -7,8 +7,14 @@
 // Public License v. 2.0. If a copy of the MPL was not distributed
 // with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
 
+#include <algorithm>
+#include <array>
+#include <cmath>
 #include <iostream>
+#include <limits>
+#include <random>
 #include <stdexcept>
+#include <vector>
 
 #include <fmt/core.h>
 #include <fmt/ranges.h>
@@ -95,6 +101,129 @@ TEST_CASE("methods")
     REQUIRE(lp.get_Nmax() == 0u);
 }
 
+TEST_CASE("jacobians")
+{
+    // Here we test the analytic Jacobians against central differences on random problems,
+    // including multiple revolutions and retrograde transfers.
+    // NOLINTNEXTLINE(cert-msc32-c, cert-msc51-cpp)
+    std::mt19937 rng_engine(1231u);
+    std::uniform_int_distribution<unsigned> cw_d(0, 1);
+    std::uniform_real_distribution<double> r_d(-2, 2);
+    std::uniform_real_distribution<double> tof_d(2., 40.);
+    std::uniform_real_distribution<double> mu_d(0.9, 1.1);
+    const double h = 1e-6;
+
+    // Without request, no Jacobians.
+    REQUIRE(kep3::lambert_problem{}.get_v0_jacobian().empty());
+    REQUIRE(kep3::lambert_problem{}.get_v1_jacobian().empty());
+
+    for (auto i = 0u; i < 100u; ++i) {
+        std::array<double, 7> in{};
+        for (auto &item : in) {
+            item = r_d(rng_engine);
+        }
+        in[6] = tof_d(rng_engine);
+        const bool cw = static_cast<bool>(cw_d(rng_engine));
+        const double mu = mu_d(rng_engine);
+        auto solve = [cw, mu](const std::array<double, 7> &x, bool jac) {
+            return kep3::lambert_problem{{x[0], x[1], x[2]}, {x[3], x[4], x[5]}, x[6], mu, cw, 5u, jac};
+        };
+        const auto lp = solve(in, true);
+        REQUIRE(lp.get_v0_jacobian().size() == lp.get_v0().size());
+        REQUIRE(lp.get_v1_jacobian().size() == lp.get_v1().size());
+        for (auto k = 0u; k < 7u; ++k) {
+            auto in_p = in, in_m = in;
+            in_p[k] += h;
+            in_m[k] -= h;
+            const auto lp_p = solve(in_p, false);
+            const auto lp_m = solve(in_m, false);
+            // The perturbation may change the number of solutions.
+            const auto n_sol = std::min(lp_p.get_v0().size(), lp_m.get_v0().size());
+            for (decltype(lp.get_v0().size()) j = 0u; j < std::min(n_sol, lp.get_v0().size()); ++j) {
+                // The derivatives are large close to the boundary N_max.
+                const double scale = std::max(1., std::abs(lp.get_v0_jacobian()[j][k]));
+                for (auto l = 0u; l < 3u; ++l) {
+                    const double fd0 = (lp_p.get_v0()[j][l] - lp_m.get_v0()[j][l]) / (2 * h);
+                    const double fd1 = (lp_p.get_v1()[j][l] - lp_m.get_v1()[j][l]) / (2 * h);
+                    REQUIRE(std::abs(lp.get_v0_jacobian()[j][7u * l + k] - fd0) < 1e-6 * scale);
+                    REQUIRE(std::abs(lp.get_v1_jacobian()[j][7u * l + k] - fd1) < 1e-6 * scale);
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("warm_start")
+{
+    // Here we sweep the time of flight, warm starting each problem from the previous solutions.
+    const std::array<double, 3> r0 = {{1.23, 0.1253232342323, 0.57235553354}};
+    const std::array<double, 3> r1 = {{0.234233423, 1.8645645645, 0.234234234}};
+    std::vector<double> x_prev;
+    unsigned iters_cold = 0u, iters_warm = 0u;
+    for (auto i = 0u; i < 200u; ++i) {
+        const double tof = 25. + 0.01 * i;
+        const kep3::lambert_problem lp_cold{r0, r1, tof, 1., false, 3u};
+        const kep3::lambert_problem lp_warm{r0, r1, tof, 1., false, 3u, false, x_prev};
+        REQUIRE(lp_warm.get_Nmax() == lp_cold.get_Nmax());
+        for (decltype(lp_cold.get_x().size()) j = 0u; j < lp_cold.get_x().size(); ++j) {
+            REQUIRE(kep3_tests::floating_point_error(lp_warm.get_x()[j], lp_cold.get_x()[j]) < 1e-13);
+            REQUIRE(kep3_tests::floating_point_error_vector(lp_warm.get_v0()[j], lp_cold.get_v0()[j]) < 1e-13);
+            REQUIRE(kep3_tests::floating_point_error_vector(lp_warm.get_v1()[j], lp_cold.get_v1()[j]) < 1e-13);
+            iters_cold += lp_cold.get_iters()[j];
+            iters_warm += lp_warm.get_iters()[j];
+        }
+        x_prev = lp_warm.get_x();
+    }
+    REQUIRE(iters_warm < iters_cold);
+    // Guesses outside the branch domains, or in excess, are ignored.
+    const kep3::lambert_problem lp{r0, r1, 25., 1., false, 3u};
+    const kep3::lambert_problem lp_bad{
+        r0, r1, 25., 1., false, 3u, false, {std::numeric_limits<double>::quiet_NaN(), 2., -1., 0., 0., 0., 0., 0., 0.}};
+    REQUIRE(lp_bad.get_x().size() == lp.get_x().size());
+    for (decltype(lp.get_x().size()) j = 0u; j < 3u; ++j) {
+        REQUIRE(lp_bad.get_x()[j] == lp.get_x()[j]);
+        REQUIRE(lp_bad.get_iters()[j] == lp.get_iters()[j]);
+    }
+}
+
+TEST_CASE("solve_branch")
+{
+    // Here we test that each branch is solved as in lambert_problem, on random problems.
+    // NOLINTNEXTLINE(cert-msc32-c, cert-msc51-cpp)
+    std::mt19937 rng_engine(4534u);
+    std::uniform_int_distribution<unsigned> cw_d(0, 1);
+    std::uniform_real_distribution<double> r_d(-2, 2);
+    std::uniform_real_distribution<double> tof_d(2., 40.);
+    std::uniform_real_distribution<double> mu_d(0.9, 1.1);
+    for (auto i = 0u; i < 1000u; ++i) {
+        const std::array<double, 3> r0 = {{r_d(rng_engine), r_d(rng_engine), r_d(rng_engine)}};
+        const std::array<double, 3> r1 = {{r_d(rng_engine), r_d(rng_engine), r_d(rng_engine)}};
+        const double tof = tof_d(rng_engine);
+        const bool cw = static_cast<bool>(cw_d(rng_engine));
+        const double mu = mu_d(rng_engine);
+        const kep3::lambert_problem lp(r0, r1, tof, mu, cw, 20u);
+        for (auto N = 0u; N <= lp.get_Nmax(); ++N) {
+            for (auto right : {false, true}) {
+                const auto j = (N == 0u) ? 0u : 2u * N - 1u + static_cast<unsigned>(right);
+                for (auto check : {true, false}) {
+                    const auto sol = kep3::lambert_solve_branch(r0, r1, tof, mu, cw, N, right, check);
+                    REQUIRE(sol.x == lp.get_x()[j]);
+                    REQUIRE(sol.iters == lp.get_iters()[j]);
+                    REQUIRE(sol.v0 == lp.get_v0()[j]);
+                    REQUIRE(sol.v1 == lp.get_v1()[j]);
+                }
+            }
+        }
+        // The first branch that does not exist (unless N_max was cropped).
+        if (lp.get_Nmax() < 20u) {
+            REQUIRE_THROWS_AS(kep3::lambert_solve_branch(r0, r1, tof, mu, cw, lp.get_Nmax() + 1u),
+                              std::domain_error);
+        }
+    }
+    REQUIRE_THROWS_AS(kep3::lambert_solve_branch({1., 0., 0.}, {0., 1., 0.}, -1., 1., false, 0u), std::domain_error);
+    REQUIRE_THROWS_AS(kep3::lambert_solve_branch({1., 0., 0.}, {0., 1., 0.}, 1., 0., false, 0u), std::domain_error);
+}
+
 TEST_CASE("serialization_test")
 {
     // Instantiate a generic lambert problem
@@ -119,4 +248,74 @@ TEST_CASE("serialization_test")
     auto after = boost::lexical_cast<std::string>(lp2);
     // Compare the string represetation
     REQUIRE(before == after);
-}
\ No newline at end of file
+}
+
+// The layout of kep3::lambert_problem in version 0 archives, which did not store the Jacobians.
+struct lambert_problem_v0 {
+    template <class Archive>
+    void serialize(Archive &ar, const unsigned int version)
+    {
+        ar & r0;
+        ar & r1;
+        ar & tof;
+        ar & mu;
+        ar & v0;
+        ar & v1;
+        ar & iters;
+        ar & x;
+        ar & s;
+        ar & c;
+        ar & lambda;
+        ar & iters;
+        ar & Nmax;
+        ar & has_converged;
+        ar & multi_revs;
+        if (version >= 1u) {
+            ar & v0_jac;
+            ar & v1_jac;
+        }
+    }
+    std::array<double, 3> r0{}, r1{};
+    double tof = 0., mu = 0.;
+    std::vector<std::array<double, 3>> v0, v1;
+    std::vector<unsigned> iters;
+    std::vector<double> x;
+    double s = 0., c = 0., lambda = 0.;
+    unsigned Nmax = 0u;
+    bool has_converged = false;
+    unsigned multi_revs = 0u;
+    std::vector<std::array<double, 21>> v0_jac, v1_jac;
+};
+
+TEST_CASE("serialization_versions")
+{
+    kep3::lambert_problem lp{{1.23, 0.1253232342323, 0.57235553354}, {0.234233423, 1.8645645645, 0.234234234},
+                             25.254856435, 1., true, 10, true};
+    // The Jacobians are part of the current archives.
+    std::stringstream ss;
+    {
+        boost::archive::binary_oarchive oarchive(ss);
+        oarchive << lp;
+    }
+    lambert_problem_v0 old;
+    {
+        boost::archive::binary_iarchive iarchive(ss);
+        iarchive >> old;
+    }
+    REQUIRE(old.v0_jac == lp.get_v0_jacobian());
+    REQUIRE(old.v1_jac == lp.get_v1_jacobian());
+    // Version 0 archives are loaded without them.
+    std::stringstream ss0;
+    {
+        boost::archive::binary_oarchive oarchive(ss0);
+        oarchive << old;
+    }
+    kep3::lambert_problem lp2{};
+    {
+        boost::archive::binary_iarchive iarchive(ss0);
+        iarchive >> lp2;
+    }
+    REQUIRE(boost::lexical_cast<std::string>(lp2) == boost::lexical_cast<std::string>(lp));
+    REQUIRE(lp2.get_v0_jacobian().empty());
+    REQUIRE(lp2.get_v1_jacobian().empty());
+}
@@ -0,0 +1,144 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <array>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include <kep3/core_astro/constants.hpp>
+#include <kep3/core_astro/flyby.hpp>
+#include <kep3/lambert_problem.hpp>
+#include <kep3/mga.hpp>
+#include <kep3/planet.hpp>
+#include <kep3/planets/jpl_lp.hpp>
+#include <kep3/planets/keplerian.hpp>
+
+#include "catch.hpp"
+#include "test_helpers.hpp"
+
+using kep3::udpla::jpl_lp;
+
+std::vector<kep3::planet> jpl_lp_sequence(const std::vector<const char *> &names)
+{
+    std::vector<kep3::planet> retval;
+    for (const auto *name : names) {
+        retval.emplace_back(jpl_lp{name});
+    }
+    return retval;
+}
+
+TEST_CASE("fb_dv")
+{
+    // Same magnitude and a deflection within the reach of the hyperbola: no delta-v.
+    REQUIRE(kep3::fb_dv({1., 0., 0.}, {std::cos(0.1), std::sin(0.1), 0.}, 1., 1.) < 1e-15);
+    // No deflection: only the change of magnitude costs.
+    REQUIRE(kep3_tests::floating_point_error(kep3::fb_dv({1., 0., 0.}, {1.5, 0., 0.}, 1., 1.), 0.5) < 1e-15);
+    // With rp |v|^2 / mu = 1 the maximum deflection is pi / 3: turning by pi / 2 misses pi / 6.
+    REQUIRE(kep3_tests::floating_point_error(kep3::fb_dv({1., 0., 0.}, {0., 1., 0.}, 1., 1.),
+                                             std::sqrt(2. - 2. * std::cos(kep3::pi / 6.)))
+            < 1e-14);
+    // A lighter planet deflects less.
+    REQUIRE(kep3::fb_dv({1., 0., 0.}, {0., 1., 0.}, 0.1, 1.) > kep3::fb_dv({1., 0., 0.}, {0., 1., 0.}, 1., 1.));
+}
+
+TEST_CASE("mga_vs_lambert_problem")
+{
+    // Here we test the delta-vs of an Earth-Venus-Venus-Earth-Jupiter trajectory against
+    // those computed by hand with kep3::lambert_problem.
+    const auto seq = jpl_lp_sequence({"earth", "venus", "venus", "earth", "jupiter"});
+    const std::vector<double> x{-800., 150., 450., 420., 1200.};
+    const auto res = kep3::mga(seq, x, kep3::MU_SUN);
+    REQUIRE(res.dvs.size() == 5u);
+    std::vector<std::array<std::array<double, 3>, 2>> ephs;
+    double t = x[0];
+    for (auto i = 0u; i < seq.size(); ++i) {
+        t += i == 0u ? 0. : x[i];
+        ephs.push_back(seq[i].eph(t));
+    }
+    std::vector<std::array<double, 3>> v0s, v1s;
+    for (auto i = 1u; i < seq.size(); ++i) {
+        const kep3::lambert_problem lp(ephs[i - 1u][0], ephs[i][0], x[i] * kep3::DAY2SEC, kep3::MU_SUN, false, 0u);
+        v0s.push_back(lp.get_v0()[0]);
+        v1s.push_back(lp.get_v1()[0]);
+    }
+    const auto rel = [](const std::array<double, 3> &v, const std::array<double, 3> &v_pl) {
+        return std::array<double, 3>{v[0] - v_pl[0], v[1] - v_pl[1], v[2] - v_pl[2]};
+    };
+    const auto norm = [](const std::array<double, 3> &v) { return std::sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]); };
+    double total = norm(rel(v0s[0], ephs[0][1]));
+    REQUIRE(kep3_tests::floating_point_error(res.dvs[0], total) < 1e-10);
+    for (auto i = 1u; i < 4u; ++i) {
+        const double dv = kep3::fb_dv(rel(v1s[i - 1u], ephs[i][1]), rel(v0s[i], ephs[i][1]), seq[i].get_mu_self(),
+                                      seq[i].get_safe_radius());
+        REQUIRE(kep3_tests::floating_point_error(res.dvs[i], dv) < 1e-10);
+        total += dv;
+    }
+    const double dv_arr = norm(rel(v1s[3], ephs[4][1]));
+    REQUIRE(kep3_tests::floating_point_error(res.dvs[4], dv_arr) < 1e-10);
+    total += dv_arr;
+    REQUIRE(kep3_tests::floating_point_error(res.total, total) < 1e-10);
+}
+
+TEST_CASE("mga_batch")
+{
+    // The batch version must return the same values as the scalar one, up to the round-off
+    // of the vectorised Lambert kernels (the velocities are of the order of 1e4 m/s).
+    const auto seq = jpl_lp_sequence({"earth", "venus", "earth", "mars"});
+    // NOLINTNEXTLINE(cert-msc32-c, cert-msc51-cpp)
+    std::mt19937 rng_engine(1231u);
+    std::uniform_real_distribution<double> t0_d(-1000., 1000.), tof_d(50., 500.);
+    const std::size_t N = 1001u;
+    std::vector<double> xs;
+    for (std::size_t k = 0u; k < N; ++k) {
+        xs.push_back(t0_d(rng_engine));
+        for (auto i = 1u; i < seq.size(); ++i) {
+            xs.push_back(tof_d(rng_engine));
+        }
+    }
+    std::vector<double> dv(N), dvs(N * seq.size());
+    kep3::mga_batch(seq, xs, kep3::MU_SUN, false, dv, dvs);
+    for (std::size_t k = 0u; k < N; ++k) {
+        const auto res
+            = kep3::mga(seq, std::vector<double>(xs.begin() + 4 * k, xs.begin() + 4 * (k + 1)), kep3::MU_SUN);
+        REQUIRE(std::abs(res.total - dv[k]) < 1e-7);
+        for (auto i = 0u; i < seq.size(); ++i) {
+            REQUIRE(std::abs(res.dvs[i] - dvs[k * seq.size() + i]) < 1e-7);
+        }
+    }
+    // Empty batches are allowed.
+    REQUIRE_NOTHROW(kep3::mga_batch(seq, {}, kep3::MU_SUN, false, {}, {}));
+    // Sizes.
+    REQUIRE_THROWS_AS(kep3::mga_batch(seq, xs, kep3::MU_SUN, false, std::span<double>(dv.data(), N - 1u), dvs),
+                      std::invalid_argument);
+    REQUIRE_THROWS_AS(kep3::mga_batch(seq, xs, kep3::MU_SUN, false, dv, std::span<double>(dvs.data(), 4u)),
+                      std::invalid_argument);
+    // Invalid times of flight.
+    auto bad = xs;
+    bad[4u * 500u + 2u] = -1.;
+    REQUIRE_THROWS_AS(kep3::mga_batch(seq, bad, kep3::MU_SUN, false, dv, dvs), std::domain_error);
+}
+
+TEST_CASE("mga_throws")
+{
+    const kep3::planet earth{jpl_lp{"earth"}};
+    const kep3::planet mars{jpl_lp{"mars"}};
+    REQUIRE_THROWS_AS(kep3::mga({earth}, {0.}, kep3::MU_SUN), std::invalid_argument);
+    REQUIRE_THROWS_AS(kep3::mga({earth, mars}, {0., 100., 100.}, kep3::MU_SUN), std::invalid_argument);
+    REQUIRE_THROWS_AS(kep3::mga({earth, mars}, {0., 0.}, kep3::MU_SUN), std::domain_error);
+    REQUIRE_THROWS_AS(kep3::mga({earth, mars}, {0., 100.}, 0.), std::domain_error);
+    // A flyby planet without mu_self.
+    const kep3::planet kep{kep3::udpla::keplerian{}};
+    REQUIRE_THROWS_AS(kep3::mga({earth, kep, mars}, {0., 100., 100.}, kep3::MU_SUN), std::domain_error);
+    // Without flybys, an mga is a porkchop cell.
+    const auto res = kep3::mga({earth, mars}, {7000., 200.}, kep3::MU_SUN);
+    REQUIRE(res.dvs.size() == 2u);
+    REQUIRE(res.total == res.dvs[0] + res.dvs[1]);
+}
@@ -0,0 +1,111 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+#include <boost/lexical_cast.hpp>
+
+#include <kep3/core_astro/constants.hpp>
+#include <kep3/planet.hpp>
+#include <kep3/planets/cached.hpp>
+#include <kep3/planets/jpl_lp.hpp>
+
+#include "catch.hpp"
+#include "test_helpers.hpp"
+
+using kep3::udpla::cached;
+using kep3::udpla::jpl_lp;
+
+TEST_CASE("constructor")
+{
+    REQUIRE_NOTHROW(cached{});
+    const kep3::planet earth{jpl_lp{"earth"}};
+    REQUIRE_NOTHROW(cached{earth, 0., 100.});
+    REQUIRE_NOTHROW(kep3::planet{cached{earth, 0., 100.}});
+    REQUIRE_THROWS_AS((cached{earth, 100., 100.}), std::domain_error);
+    REQUIRE_THROWS_AS((cached{earth, 0., 100., 0.}), std::domain_error);
+    REQUIRE_THROWS_AS((cached{earth, 0., 100., 1e-12, 0u}), std::domain_error);
+    // The wrapped planet errors are propagated.
+    REQUIRE_THROWS_AS((cached{earth, 0., 1e5}), std::domain_error);
+}
+
+TEST_CASE("eph")
+{
+    // We test that the interpolated ephemerides are within the requested tolerance.
+    for (const auto *name : {"mercury", "earth", "jupiter"}) {
+        const kep3::planet pl{jpl_lp{name}};
+        for (auto tol : {1e-8, 1e-12}) {
+            const cached udpla{pl, -1000., 3000., tol};
+            for (auto i = 0u; i <= 10000u; ++i) {
+                const double mjd2000 = -1000. + 0.4 * i;
+                const auto [r, v] = udpla.eph(mjd2000);
+                const auto [r_true, v_true] = pl.eph(mjd2000);
+                REQUIRE(kep3_tests::floating_point_error_vector(r_true, r) < 10 * tol);
+                REQUIRE(kep3_tests::floating_point_error_vector(v_true, v) < 10 * tol);
+            }
+        }
+    }
+    const cached udpla{kep3::planet{jpl_lp{"mars"}}, 0., 100.};
+    REQUIRE_THROWS_AS(udpla.eph(-1.), std::domain_error);
+    REQUIRE_THROWS_AS(udpla.eph(100.1), std::domain_error);
+    REQUIRE_NOTHROW(udpla.eph(100.));
+    // eph_v is consistent with eph.
+    const std::vector<double> mjd2000s = {0., 12.3, 45.6, 100.};
+    const auto res = kep3::planet{udpla}.eph_v(mjd2000s);
+    for (decltype(mjd2000s.size()) i = 0u; i < mjd2000s.size(); ++i) {
+        const auto [r, v] = udpla.eph(mjd2000s[i]);
+        REQUIRE(res[6 * i] == r[0]);
+        REQUIRE(res[6 * i + 4] == v[1]);
+    }
+}
+
+TEST_CASE("getters")
+{
+    const kep3::planet pl{jpl_lp{"neptune"}};
+    const cached udpla{pl, 0., 100.};
+    REQUIRE(udpla.get_name() == pl.get_name());
+    REQUIRE(udpla.get_mu_central_body() == pl.get_mu_central_body());
+    REQUIRE(udpla.get_mu_self() == pl.get_mu_self());
+    REQUIRE(udpla.get_radius() == pl.get_radius());
+    REQUIRE(udpla.get_safe_radius() == pl.get_safe_radius());
+    REQUIRE(udpla.period(10.) == pl.period(10.));
+    REQUIRE(udpla.elements(10.) == pl.elements(10.));
+    REQUIRE(tanuki::value_isa<jpl_lp>(udpla.get_planet()));
+}
+
+TEST_CASE("stream_operator")
+{
+    REQUIRE_NOTHROW((std::cout << cached{} << '\n'));
+}
+
+TEST_CASE("serialization_test")
+{
+    const kep3::planet pl{cached{kep3::planet{jpl_lp{"venus"}}, 0., 300.}};
+
+    // Store the string representation.
+    std::stringstream ss;
+    auto before = boost::lexical_cast<std::string>(pl);
+    // Now serialize
+    {
+        boost::archive::binary_oarchive oarchive(ss);
+        oarchive << pl;
+    }
+    // Deserialize
+    kep3::planet pl2{};
+    {
+        boost::archive::binary_iarchive iarchive(ss);
+        iarchive >> pl2;
+    }
+    auto after = boost::lexical_cast<std::string>(pl2);
+    // Compare the string represetation
+    REQUIRE(before == after);
+    REQUIRE(pl.eph(123.4) == pl2.eph(123.4));
+}
@@ -0,0 +1,117 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <cmath>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <boost/lexical_cast.hpp>
+
+#include <kep3/core_astro/constants.hpp>
+#include <kep3/core_astro/eq2par2eq.hpp>
+#include <kep3/planet.hpp>
+#include <kep3/planets/jpl_lp.hpp>
+#include <kep3/planets/jpl_lp_static.hpp>
+
+#include "catch.hpp"
+#include "test_helpers.hpp"
+
+using kep3::udpla::body;
+using kep3::udpla::jpl_lp;
+using kep3::udpla::jpl_lp_static;
+
+// Checks that the compile-time body B matches jpl_lp{name} across the whole validity range.
+// NOTE: the rates are converted to per day upfront, hence the results differ by round-off
+// (mostly in the mean anomaly, which for Mercury grows to ~6000 rad).
+template <body B>
+void compare_with_jpl_lp(const std::string &name)
+{
+    const jpl_lp ref{name};
+    const kep3::planet pla{jpl_lp_static<B>{}};
+    REQUIRE(pla.get_name() == ref.get_name());
+    REQUIRE(pla.get_mu_central_body() == ref.get_mu_central_body());
+    REQUIRE(pla.get_mu_self() == ref.get_mu_self());
+    REQUIRE(pla.get_radius() == ref.get_radius());
+    REQUIRE(pla.get_safe_radius() == ref.get_safe_radius());
+    std::vector<double> mjd2000s;
+    for (double mjd2000 = -73000.; mjd2000 < 18200.; mjd2000 += 91.2) {
+        mjd2000s.push_back(mjd2000);
+    }
+    const auto pos_vels = pla.eph_v(mjd2000s);
+    for (decltype(mjd2000s.size()) i = 0u; i < mjd2000s.size(); ++i) {
+        auto [r, v] = ref.eph(mjd2000s[i]);
+        auto [r_s, v_s] = pla.eph(mjd2000s[i]);
+        REQUIRE(kep3_tests::floating_point_error_vector(r, r_s) < 1e-11);
+        REQUIRE(kep3_tests::floating_point_error_vector(v, v_s) < 1e-11);
+        REQUIRE(r_s == std::array<double, 3>{pos_vels[6 * i], pos_vels[6 * i + 1], pos_vels[6 * i + 2]});
+        REQUIRE(v_s == std::array<double, 3>{pos_vels[6 * i + 3], pos_vels[6 * i + 4], pos_vels[6 * i + 5]});
+    }
+}
+
+TEST_CASE("eph")
+{
+    compare_with_jpl_lp<body::mercury>("mercury");
+    compare_with_jpl_lp<body::venus>("venus");
+    compare_with_jpl_lp<body::earth>("earth");
+    compare_with_jpl_lp<body::mars>("mars");
+    compare_with_jpl_lp<body::jupiter>("jupiter");
+    compare_with_jpl_lp<body::saturn>("saturn");
+    compare_with_jpl_lp<body::uranus>("uranus");
+    compare_with_jpl_lp<body::neptune>("neptune");
+    jpl_lp_static<body::uranus> udpla{};
+    REQUIRE_THROWS_AS(udpla.eph(5347534.), std::domain_error);
+    REQUIRE_THROWS_AS(udpla.eph_v({0., 5347534.}), std::domain_error);
+    REQUIRE_THROWS_AS(udpla.eph(std::numeric_limits<double>::quiet_NaN()), std::domain_error);
+    REQUIRE_THROWS_AS(udpla.eph_v({0., std::numeric_limits<double>::quiet_NaN()}), std::domain_error);
+}
+
+TEST_CASE("elements")
+{
+    double ref_epoch = 12.22;
+    jpl_lp ref{"neptune"};
+    jpl_lp_static<body::neptune> udpla{};
+    for (auto el_type : {kep3::elements_type::KEP_F, kep3::elements_type::KEP_M, kep3::elements_type::MEQ,
+                         kep3::elements_type::MEQ_R}) {
+        auto par = udpla.elements(ref_epoch, el_type);
+        auto par_ref = ref.elements(ref_epoch, el_type);
+        for (auto i = 0u; i < 6u; ++i) {
+            REQUIRE(std::abs(par[i] - par_ref[i]) <= 1e-13 * std::max(1., std::abs(par_ref[i])));
+        }
+    }
+    REQUIRE_THROWS_AS(udpla.elements(ref_epoch, kep3::elements_type::POSVEL), std::logic_error);
+}
+
+TEST_CASE("stream_operator")
+{
+    REQUIRE_NOTHROW((std::cout << jpl_lp_static<body::earth>{} << '\n'));
+}
+
+TEST_CASE("serialization_test")
+{
+    // Serialize a planet holding a compile-time body.
+    kep3::planet pla{jpl_lp_static<body::mars>{}};
+    std::stringstream ss;
+    auto before = boost::lexical_cast<std::string>(pla);
+    {
+        boost::archive::binary_oarchive oarchive(ss);
+        oarchive << pla;
+    }
+    // Deserialize
+    kep3::planet pla2{};
+    {
+        boost::archive::binary_iarchive iarchive(ss);
+        iarchive >> pla2;
+    }
+    auto after = boost::lexical_cast<std::string>(pla2);
+    REQUIRE(before == after);
+    REQUIRE(pla2.extract<jpl_lp_static<body::mars>>() != nullptr);
+}
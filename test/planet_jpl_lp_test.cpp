@@ -9,7 +9,9 @@
 
 #include <fmt/core.h>
 #include <fmt/ranges.h>
+#include <limits>
 #include <stdexcept>
+#include <vector>
 
 #include <kep3/core_astro/constants.hpp>
 #include <kep3/core_astro/convert_anomalies.hpp>
@@ -131,6 +133,36 @@ TEST_CASE("eph")
     REQUIRE_THROWS_AS(udpla.eph(5347534.), std::domain_error);
 }
 
+TEST_CASE("eph_v")
+{
+    // The vectorised ephemerides must match eph() for all planets. The number of
+    // epochs is not a multiple of the block size, so that also the remainder is exercised.
+    std::vector<double> mjd2000s(1003u);
+    for (decltype(mjd2000s.size()) i = 0u; i < mjd2000s.size(); ++i) {
+        mjd2000s[i] = -73000. + 91. * static_cast<double>(i);
+    }
+    for (const auto *name : {"mercury", "venus", "earth", "mars", "jupiter", "saturn", "uranus", "neptune"}) {
+        jpl_lp udpla{name};
+        auto pos_vels = udpla.eph_v(mjd2000s);
+        REQUIRE(pos_vels.size() == 6u * mjd2000s.size());
+        for (decltype(mjd2000s.size()) i = 0u; i < mjd2000s.size(); ++i) {
+            auto [r, v] = udpla.eph(mjd2000s[i]);
+            REQUIRE(kep3_tests::floating_point_error_vector(r, {pos_vels[6 * i], pos_vels[6 * i + 1],
+                                                                pos_vels[6 * i + 2]})
+                    < 1e-13);
+            REQUIRE(kep3_tests::floating_point_error_vector(v, {pos_vels[6 * i + 3], pos_vels[6 * i + 4],
+                                                                pos_vels[6 * i + 5]})
+                    < 1e-13);
+        }
+    }
+    jpl_lp udpla{"uranus"};
+    REQUIRE(udpla.eph_v({}).empty());
+    REQUIRE_THROWS_AS(udpla.eph_v({0., 5347534.}), std::domain_error);
+    // NaN epochs are rejected as eph() does.
+    REQUIRE_THROWS_AS(udpla.eph(std::numeric_limits<double>::quiet_NaN()), std::domain_error);
+    REQUIRE_THROWS_AS(udpla.eph_v({0., std::numeric_limits<double>::quiet_NaN()}), std::domain_error);
+}
+
 TEST_CASE("elements")
 {
     double ref_epoch = 12.22;
@@ -10,6 +10,7 @@
 #include <fmt/core.h>
 #include <fmt/ranges.h>
 #include <stdexcept>
+#include <vector>
 
 #include <kep3/core_astro/constants.hpp>
 #include <kep3/core_astro/convert_anomalies.hpp>
@@ -104,6 +105,32 @@ TEST_CASE("eph")
     REQUIRE(kep3_tests::floating_point_error_vector(v, pos_vel_0[1]) < 1e-13);
 }
 
+TEST_CASE("eph_v")
+{
+    // The vectorised ephemerides must match eph(), on an ellipse and on an hyperbola.
+    kep3::epoch ref_epoch{12.22, kep3::epoch::julian_type::MJD2000};
+    std::vector<double> mjd2000s(103u);
+    for (decltype(mjd2000s.size()) i = 0u; i < mjd2000s.size(); ++i) {
+        mjd2000s[i] = -1000. + 19.7 * static_cast<double>(i);
+    }
+    for (const auto &pos_vel_0 : {std::array<std::array<double, 3>, 2>{{{kep3::AU, 0., 1e10}, {0., 2.5e4, 3e3}}},
+                                  std::array<std::array<double, 3>, 2>{{{kep3::AU, 0., 1e10}, {0., 6e4, 3e3}}}}) {
+        keplerian udpla{ref_epoch, pos_vel_0, kep3::MU_SUN};
+        auto pos_vels = udpla.eph_v(mjd2000s);
+        REQUIRE(pos_vels.size() == 6u * mjd2000s.size());
+        for (decltype(mjd2000s.size()) i = 0u; i < mjd2000s.size(); ++i) {
+            auto [r, v] = udpla.eph(mjd2000s[i]);
+            REQUIRE(kep3_tests::floating_point_error_vector(r, {pos_vels[6 * i], pos_vels[6 * i + 1],
+                                                                pos_vels[6 * i + 2]})
+                    < 1e-10);
+            REQUIRE(kep3_tests::floating_point_error_vector(v, {pos_vels[6 * i + 3], pos_vels[6 * i + 4],
+                                                                pos_vels[6 * i + 5]})
+                    < 1e-10);
+        }
+    }
+    REQUIRE(keplerian{}.eph_v({}).empty());
+}
+
 TEST_CASE("elements")
 {
     kep3::epoch ref_epoch{12.22, kep3::epoch::julian_type::MJD2000};
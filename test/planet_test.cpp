@@ -7,9 +7,12 @@
 // Public License v. 2.0. If a copy of the MPL was not distributed
 // with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
 
+#include <algorithm>
 #include <array>
+#include <span>
 #include <stdexcept>
 #include <string>
+#include <vector>
 
 #include <fmt/core.h>
 
@@ -192,6 +195,31 @@ private:
 
 TANUKI_S11N_WRAP_EXPORT(complete_udpla, kep3::detail::planet_iface)
 
+// A udpla writing its ephemerides in the caller's memory. The position is (t, 0, 0), the velocity (0, t, 0).
+struct span_udpla {
+    static std::array<std::array<double, 3>, 2> eph(double mjd2000)
+    {
+        return {{{mjd2000, 0., 0.}, {0., mjd2000, 0.}}};
+    };
+    static void eph_into(std::span<const double> mjd2000s, std::span<double> out)
+    {
+        for (decltype(mjd2000s.size()) i = 0u; i < mjd2000s.size(); ++i) {
+            const auto pos_vel = eph(mjd2000s[i]);
+            std::copy(pos_vel[0].begin(), pos_vel[0].end(), out.begin() + 6 * i);
+            std::copy(pos_vel[1].begin(), pos_vel[1].end(), out.begin() + 6 * i + 3);
+        }
+    };
+
+private:
+    friend class boost::serialization::access;
+    template <typename Archive>
+    void serialize(Archive &, unsigned)
+    {
+    }
+};
+
+TANUKI_S11N_WRAP_EXPORT(span_udpla, kep3::detail::planet_iface)
+
 TEST_CASE("construction")
 {
     {
@@ -322,6 +350,39 @@ TEST_CASE("construction")
     REQUIRE(value_isa<null_udpla>(p2));
 }
 
+TEST_CASE("eph_into")
+{
+    const std::vector<double> mjd2000s = {1., 2.};
+    std::vector<double> out(12u);
+    {
+        // Default implementation (a loop over eph).
+        planet pla{simple_udpla{}};
+        pla.eph_into(mjd2000s, out);
+        REQUIRE(out == pla.eph_v(mjd2000s));
+    }
+    {
+        // From the eph_v of the udpla.
+        planet pla{complete_udpla({1., 2., -1., 4.})};
+        std::fill(out.begin(), out.end(), -1.);
+        pla.eph_into(mjd2000s, out);
+        REQUIRE(out == std::vector<double>{1., 0., 0., 0., 1., 0., 1., 0., 0., 0., 1., 0.});
+        // The eph_v of the udpla always returns two states.
+        REQUIRE_THROWS_AS(pla.eph_into(std::vector<double>{1.}, std::span<double>(out.data(), 6u)),
+                          std::invalid_argument);
+    }
+    {
+        // From the eph_into of the udpla, which is also used by eph_v.
+        planet pla{span_udpla{}};
+        pla.eph_into(mjd2000s, out);
+        REQUIRE(out == std::vector<double>{1., 0., 0., 0., 1., 0., 2., 0., 0., 0., 2., 0.});
+        REQUIRE(pla.eph_v(mjd2000s) == out);
+        // Sizes.
+        REQUIRE_THROWS_AS(pla.eph_into(mjd2000s, std::span<double>(out.data(), 6u)), std::invalid_argument);
+        REQUIRE_THROWS_AS(pla.eph_into(std::span<const double>{}, out), std::invalid_argument);
+        REQUIRE_NOTHROW(pla.eph_into(std::span<const double>{}, std::span<double>{}));
+    }
+}
+
 TEST_CASE("planet_extract_is_test")
 {
     // We instantiate a planet
@@ -0,0 +1,72 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+#include <kep3/core_astro/constants.hpp>
+#include <kep3/lambert_problem.hpp>
+#include <kep3/planet.hpp>
+#include <kep3/planets/jpl_lp.hpp>
+#include <kep3/porkchop.hpp>
+
+#include "catch.hpp"
+#include "test_helpers.hpp"
+
+using kep3::udpla::jpl_lp;
+
+TEST_CASE("porkchop_vs_lambert_problem")
+{
+    // Here we test that each cell of the porkchop matches the delta-vs computed
+    // by hand with kep3::lambert_problem.
+    const kep3::planet earth{jpl_lp{"earth"}};
+    const kep3::planet mars{jpl_lp{"mars"}};
+    std::vector<double> t0s, tofs;
+    for (auto i = 0u; i < 37u; ++i) {
+        t0s.push_back(7000. + 10. * i);
+    }
+    for (auto j = 0u; j < 23u; ++j) {
+        tofs.push_back(100. + 15. * j);
+    }
+    const auto res = kep3::porkchop(earth, mars, t0s, tofs, kep3::MU_SUN);
+    REQUIRE(res.n_departures == t0s.size());
+    REQUIRE(res.n_tofs == tofs.size());
+    REQUIRE(res.dv0.size() == t0s.size() * tofs.size());
+    REQUIRE(res.dv1.size() == t0s.size() * tofs.size());
+    for (auto i = 0u; i < t0s.size(); ++i) {
+        for (auto j = 0u; j < tofs.size(); ++j) {
+            const auto [r0, v_pl0] = earth.eph(t0s[i]);
+            const auto [r1, v_pl1] = mars.eph(t0s[i] + tofs[j]);
+            const kep3::lambert_problem lp(r0, r1, tofs[j] * kep3::DAY2SEC, kep3::MU_SUN, false, 0u);
+            const auto &v0 = lp.get_v0()[0];
+            const auto &v1 = lp.get_v1()[0];
+            const double dv0
+                = std::sqrt((v0[0] - v_pl0[0]) * (v0[0] - v_pl0[0]) + (v0[1] - v_pl0[1]) * (v0[1] - v_pl0[1])
+                            + (v0[2] - v_pl0[2]) * (v0[2] - v_pl0[2]));
+            const double dv1
+                = std::sqrt((v1[0] - v_pl1[0]) * (v1[0] - v_pl1[0]) + (v1[1] - v_pl1[1]) * (v1[1] - v_pl1[1])
+                            + (v1[2] - v_pl1[2]) * (v1[2] - v_pl1[2]));
+            REQUIRE(kep3_tests::floating_point_error(res.dv0[i * tofs.size() + j], dv0) < 1e-10);
+            REQUIRE(kep3_tests::floating_point_error(res.dv1[i * tofs.size() + j], dv1) < 1e-10);
+        }
+    }
+}
+
+TEST_CASE("porkchop_throws")
+{
+    const kep3::planet earth{jpl_lp{"earth"}};
+    const kep3::planet mars{jpl_lp{"mars"}};
+    REQUIRE_THROWS_AS(kep3::porkchop(earth, mars, {0.}, {100., -1.}, kep3::MU_SUN), std::domain_error);
+    REQUIRE_THROWS_AS(kep3::porkchop(earth, mars, {0.}, {100.}, 0.), std::domain_error);
+    // Empty grids are allowed.
+    const auto res = kep3::porkchop(earth, mars, {}, {100.}, kep3::MU_SUN);
+    REQUIRE(res.dv0.empty());
+    REQUIRE(res.dv1.empty());
+}
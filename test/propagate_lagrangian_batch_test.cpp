@@ -0,0 +1,297 @@
+// Copyright 2023, 2024 Dario Izzo (dario.izzo@gmail.com), Francesco Biscani
+// (bluescarni@gmail.com)
+//
+// This file is part of the kep3 library.
+//
+// This Source Code Form is subject to the terms of the Mozilla
+// Public License v. 2.0. If a copy of the MPL was not distributed
+// with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include <kep3/core_astro/constants.hpp>
+#include <kep3/core_astro/ic2par2ic.hpp>
+#include <kep3/core_astro/propagate_lagrangian.hpp>
+#include <kep3/core_astro/propagate_lagrangian_batch.hpp>
+
+#include "catch.hpp"
+#include "test_helpers.hpp"
+
+// A structure of arrays holding N Cartesian states.
+struct states_data {
+    explicit states_data(std::size_t N)
+        : r{std::vector<double>(N), std::vector<double>(N), std::vector<double>(N)},
+          v{std::vector<double>(N), std::vector<double>(N), std::vector<double>(N)}
+    {
+    }
+    [[nodiscard]] kep3::pos_vel_batch view()
+    {
+        return {{r[0], r[1], r[2]}, {v[0], v[1], v[2]}};
+    }
+    std::array<std::vector<double>, 3> r, v;
+};
+
+TEST_CASE("batch_vs_scalar")
+{
+    // Here we test that the batch propagator returns the same states as
+    // kep3::propagate_lagrangian on a random mix of ellipses and hyperbolae.
+    // N is not a multiple of the lane width, so that also the remainder is exercised.
+    const unsigned N = 10003u;
+    states_data data(N);
+    std::vector<std::array<std::array<double, 3>, 2>> pos_vels(N);
+    std::vector<double> dts(N);
+
+    // NOLINTNEXTLINE(cert-msc32-c, cert-msc51-cpp)
+    std::mt19937 rng_engine(1220202343u);
+    std::uniform_real_distribution<double> sma_d(1.1, 10.);
+    std::uniform_real_distribution<double> ecc_ell_d(0, 0.9);
+    std::uniform_real_distribution<double> ecc_hyp_d(2., 20.);
+    std::uniform_real_distribution<double> angle_d(0., kep3::pi);
+    std::uniform_real_distribution<double> f_d(0, 2 * kep3::pi);
+    std::uniform_real_distribution<double> time_d(-20., 20.);
+    for (auto i = 0u; i < N; ++i) {
+        std::array<double, 6> par{};
+        if (i % 3u == 0u) {
+            // Hyperbola, with a true anomaly within the asymptotes.
+            par = {-sma_d(rng_engine), ecc_hyp_d(rng_engine), angle_d(rng_engine), angle_d(rng_engine),
+                   angle_d(rng_engine), 0.};
+            par[5] = std::acos(-1. / par[1]) * (f_d(rng_engine) / kep3::pi - 1.) * 0.9;
+        } else {
+            par = {sma_d(rng_engine),   ecc_ell_d(rng_engine), angle_d(rng_engine),
+                   angle_d(rng_engine), angle_d(rng_engine),   f_d(rng_engine)};
+        }
+        pos_vels[i] = kep3::par2ic(par, 1.);
+        dts[i] = time_d(rng_engine);
+        for (auto j = 0u; j < 3u; ++j) {
+            data.r[j][i] = pos_vels[i][0][j];
+            data.v[j][i] = pos_vels[i][1][j];
+        }
+    }
+
+    kep3::propagate_lagrangian_batch(data.view(), dts, 1.);
+
+    for (auto i = 0u; i < N; ++i) {
+        kep3::propagate_lagrangian(pos_vels[i], dts[i], 1.);
+        REQUIRE(kep3_tests::floating_point_error_vector(pos_vels[i][0], {data.r[0][i], data.r[1][i], data.r[2][i]})
+                < 1e-10);
+        REQUIRE(kep3_tests::floating_point_error_vector(pos_vels[i][1], {data.v[0][i], data.v[1][i], data.v[2][i]})
+                < 1e-10);
+    }
+}
+
+TEST_CASE("batch_hyperbolae")
+{
+    // Here we test the hyperbolic lanes alone, from nearly parabolic to very eccentric orbits
+    // and over long times, against kep3::propagate_lagrangian.
+    const unsigned N = 10003u;
+    states_data data(N);
+    std::vector<std::array<std::array<double, 3>, 2>> pos_vels(N);
+    std::vector<double> dts(N);
+
+    // NOLINTNEXTLINE(cert-msc32-c, cert-msc51-cpp)
+    std::mt19937 rng_engine(31415u);
+    std::uniform_real_distribution<double> sma_d(1.1, 10.);
+    std::uniform_real_distribution<double> log_ecc_d(std::log(1.01), std::log(100.));
+    std::uniform_real_distribution<double> angle_d(0., kep3::pi);
+    std::uniform_real_distribution<double> f_d(0, 2 * kep3::pi);
+    std::uniform_real_distribution<double> time_d(-1000., 1000.);
+    for (auto i = 0u; i < N; ++i) {
+        std::array<double, 6> par = {-sma_d(rng_engine),  std::exp(log_ecc_d(rng_engine)), angle_d(rng_engine),
+                                     angle_d(rng_engine), angle_d(rng_engine),             0.};
+        par[5] = std::acos(-1. / par[1]) * (f_d(rng_engine) / kep3::pi - 1.) * 0.9;
+        pos_vels[i] = kep3::par2ic(par, 1.);
+        dts[i] = time_d(rng_engine);
+        for (auto j = 0u; j < 3u; ++j) {
+            data.r[j][i] = pos_vels[i][0][j];
+            data.v[j][i] = pos_vels[i][1][j];
+        }
+    }
+
+    kep3::propagate_lagrangian_batch(data.view(), dts, 1.);
+
+    for (auto i = 0u; i < N; ++i) {
+        kep3::propagate_lagrangian(pos_vels[i], dts[i], 1.);
+        REQUIRE(kep3_tests::floating_point_error_vector(pos_vels[i][0], {data.r[0][i], data.r[1][i], data.r[2][i]})
+                < 1e-10);
+        REQUIRE(kep3_tests::floating_point_error_vector(pos_vels[i][1], {data.v[0][i], data.v[1][i], data.v[2][i]})
+                < 1e-10);
+    }
+}
+
+TEST_CASE("batch_stm_vs_scalar")
+{
+    // Here we test that the batch propagator returns the same states and state
+    // transition matrices as kep3::propagate_lagrangian_stm.
+    const unsigned N = 1003u;
+    states_data data(N);
+    std::vector<std::array<std::array<double, 3>, 2>> pos_vels(N);
+    std::vector<double> dts(N);
+    std::vector<double> stms(36u * N);
+
+    // NOLINTNEXTLINE(cert-msc32-c, cert-msc51-cpp)
+    std::mt19937 rng_engine(7654u);
+    std::uniform_real_distribution<double> sma_d(1.1, 10.);
+    std::uniform_real_distribution<double> ecc_ell_d(0, 0.9);
+    std::uniform_real_distribution<double> ecc_hyp_d(2., 20.);
+    std::uniform_real_distribution<double> angle_d(0., kep3::pi);
+    std::uniform_real_distribution<double> f_d(0, 2 * kep3::pi);
+    std::uniform_real_distribution<double> time_d(-100., 100.);
+    for (auto i = 0u; i < N; ++i) {
+        std::array<double, 6> par{};
+        if (i % 3u == 0u) {
+            par = {-sma_d(rng_engine), ecc_hyp_d(rng_engine), angle_d(rng_engine), angle_d(rng_engine),
+                   angle_d(rng_engine), 0.};
+            par[5] = std::acos(-1. / par[1]) * (f_d(rng_engine) / kep3::pi - 1.) * 0.9;
+        } else {
+            par = {sma_d(rng_engine),   ecc_ell_d(rng_engine), angle_d(rng_engine),
+                   angle_d(rng_engine), angle_d(rng_engine),   f_d(rng_engine)};
+        }
+        pos_vels[i] = kep3::par2ic(par, 1.);
+        dts[i] = time_d(rng_engine);
+        for (auto j = 0u; j < 3u; ++j) {
+            data.r[j][i] = pos_vels[i][0][j];
+            data.v[j][i] = pos_vels[i][1][j];
+        }
+    }
+
+    kep3::propagate_lagrangian_stm_batch(data.view(), dts, 1., stms);
+
+    for (auto i = 0u; i < N; ++i) {
+        const auto stm = kep3::propagate_lagrangian_stm(pos_vels[i], dts[i], 1.);
+        REQUIRE(kep3_tests::floating_point_error_vector(pos_vels[i][0], {data.r[0][i], data.r[1][i], data.r[2][i]})
+                < 1e-10);
+        REQUIRE(kep3_tests::floating_point_error_vector(pos_vels[i][1], {data.v[0][i], data.v[1][i], data.v[2][i]})
+                < 1e-10);
+        double max_abs = 0.;
+        for (auto el : stm) {
+            max_abs = std::max(max_abs, std::abs(el));
+        }
+        for (auto j = 0u; j < 36u; ++j) {
+            REQUIRE(std::abs(stms[36u * i + j] - stm[j]) <= 1e-9 * max_abs);
+        }
+    }
+}
+
+TEST_CASE("batch_circular")
+{
+    states_data data(2u);
+    data.r[0] = {1., 1.};
+    data.v[1] = {1., 1.};
+    const std::vector<double> dts = {kep3::pi / 2., -kep3::pi / 2.};
+    kep3::propagate_lagrangian_batch(data.view(), dts, 1.);
+    REQUIRE(kep3_tests::floating_point_error_vector({data.r[0][0], data.r[1][0], data.r[2][0]}, {0., 1., 0.}) < 1e-14);
+    REQUIRE(kep3_tests::floating_point_error_vector({data.v[0][0], data.v[1][0], data.v[2][0]}, {-1., 0., 0.}) < 1e-14);
+    REQUIRE(kep3_tests::floating_point_error_vector({data.r[0][1], data.r[1][1], data.r[2][1]}, {0., -1., 0.}) < 1e-14);
+    REQUIRE(kep3_tests::floating_point_error_vector({data.v[0][1], data.v[1][1], data.v[2][1]}, {1., 0., 0.}) < 1e-14);
+}
+
+TEST_CASE("batch_throws")
+{
+    states_data data(3u);
+    const std::vector<double> dts(2u, 1.);
+    REQUIRE_THROWS_AS(kep3::propagate_lagrangian_batch(data.view(), dts, 1.), std::invalid_argument);
+    std::vector<double> stms(36u * 3u);
+    REQUIRE_THROWS_AS(kep3::propagate_lagrangian_stm_batch(data.view(), dts, 1., stms), std::invalid_argument);
+    const std::vector<double> dts3(3u, 1.);
+    REQUIRE_THROWS_AS(kep3::propagate_lagrangian_stm_batch(data.view(), dts3, 1., {stms.data(), 36u * 2u}),
+                      std::invalid_argument);
+    // Empty batches are allowed.
+    states_data empty(0u);
+    REQUIRE_NOTHROW(kep3::propagate_lagrangian_batch(empty.view(), {}, 1.));
+}
+
+TEST_CASE("batch_failures")
+{
+    // A state for which Kepler's equation cannot be solved (here, a NaN time) must be
+    // left unchanged, and the others propagated, before throwing.
+    const unsigned N = 11u;
+    for (auto stm : {false, true}) {
+        states_data data(N);
+        std::fill(data.r[0].begin(), data.r[0].end(), 1.);
+        std::fill(data.v[1].begin(), data.v[1].end(), 1.);
+        std::vector<double> dts(N, kep3::pi / 2.);
+        dts[5] = std::numeric_limits<double>::quiet_NaN();
+        std::vector<double> stms(36u * N, 42.);
+        if (stm) {
+            REQUIRE_THROWS_AS(kep3::propagate_lagrangian_stm_batch(data.view(), dts, 1., stms), std::domain_error);
+        } else {
+            REQUIRE_THROWS_AS(kep3::propagate_lagrangian_batch(data.view(), dts, 1.), std::domain_error);
+        }
+        for (auto i = 0u; i < N; ++i) {
+            if (i == 5u) {
+                REQUIRE(data.r[0][i] == 1.);
+                REQUIRE(data.v[1][i] == 1.);
+                REQUIRE(stms[36u * i] == 42.);
+            } else {
+                REQUIRE(std::abs(data.r[1][i] - 1.) < 1e-14);
+                REQUIRE(std::abs(data.v[0][i] + 1.) < 1e-14);
+                REQUIRE((stms[36u * i] != 42.) == stm);
+            }
+        }
+    }
+}
+
+TEST_CASE("parallel_vs_scalar")
+{
+    // Here we test that the parallel driver returns the same states as the
+    // sequential calls, for both the propagators.
+    const unsigned N = 5003u;
+    std::vector<std::array<std::array<double, 3>, 2>> pos_vels(N);
+    std::vector<double> dts(N);
+    // NOLINTNEXTLINE(cert-msc32-c, cert-msc51-cpp)
+    std::mt19937 rng_engine(23456u);
+    std::uniform_real_distribution<double> sma_d(1.1, 10.);
+    std::uniform_real_distribution<double> ecc_d(0, 0.9);
+    std::uniform_real_distribution<double> angle_d(0., kep3::pi);
+    std::uniform_real_distribution<double> time_d(-20., 20.);
+    for (auto i = 0u; i < N; ++i) {
+        pos_vels[i] = kep3::par2ic({sma_d(rng_engine), ecc_d(rng_engine), angle_d(rng_engine), angle_d(rng_engine),
+                                    angle_d(rng_engine), 2 * angle_d(rng_engine)},
+                                   1.);
+        dts[i] = time_d(rng_engine);
+    }
+    for (auto *propagate : {&kep3::propagate_lagrangian, &kep3::propagate_lagrangian_u}) {
+        auto pos_vels_par = pos_vels;
+        const auto status = kep3::propagate_lagrangian_parallel(pos_vels_par, dts, 1., propagate);
+        REQUIRE(status.size() == N);
+        for (auto i = 0u; i < N; ++i) {
+            auto pos_vel = pos_vels[i];
+            propagate(pos_vel, dts[i], 1.);
+            REQUIRE(status[i] == kep3::propagate_status::success);
+            REQUIRE(pos_vel == pos_vels_par[i]);
+        }
+    }
+}
+
+TEST_CASE("parallel_failures")
+{
+    // A failing state must not stop the others and must be left unchanged.
+    std::vector<std::array<std::array<double, 3>, 2>> pos_vels(3000u, {{{1., 0., 0.}, {0., 1., 0.}}});
+    std::vector<double> dts(3000u, kep3::pi / 2.);
+    dts[1234] = -1.;
+    const auto status = kep3::propagate_lagrangian_parallel(
+        pos_vels, dts, 1., [](std::array<std::array<double, 3>, 2> &pos_vel, double dt, double mu) {
+            if (dt < 0) {
+                pos_vel[0][0] = 42.;
+                throw std::domain_error("failure");
+            }
+            kep3::propagate_lagrangian(pos_vel, dt, mu);
+        });
+    for (auto i = 0u; i < 3000u; ++i) {
+        if (i == 1234u) {
+            REQUIRE(status[i] == kep3::propagate_status::failure);
+            REQUIRE(pos_vels[i][0][0] == 1.);
+        } else {
+            REQUIRE(status[i] == kep3::propagate_status::success);
+            REQUIRE(std::abs(pos_vels[i][0][1] - 1.) < 1e-14);
+        }
+    }
+    REQUIRE_THROWS_AS(kep3::propagate_lagrangian_parallel(pos_vels, std::vector<double>(2u, 1.), 1.),
+                      std::invalid_argument);
+}
@@ -7,8 +7,13 @@
 // Public License v. 2.0. If a copy of the MPL was not distributed
 // with this file, You can obtain one at http://mozilla.org/MPL/2.0/.
 
+#include <algorithm>
+#include <array>
+#include <cmath>
 #include <functional>
+#include <random>
 #include <stdexcept>
+#include <vector>
 
 #include <fmt/core.h>
 #include <fmt/ranges.h>
@@ -19,6 +24,7 @@
 #include <kep3/core_astro/ic2par2ic.hpp>
 #include <kep3/core_astro/kepler_equations.hpp>
 #include <kep3/core_astro/propagate_lagrangian.hpp>
+#include <kep3/core_astro/special_functions.hpp>
 
 #include "catch.hpp"
 #include "test_helpers.hpp"
@@ -143,6 +149,44 @@ void test_propagate_lagrangian(
     }
 }
 
+// Checks the state transition matrix returned by propagate_lagrangian_stm against central finite differences
+// and its symplecticity (Phi^T J Phi = J, with J = [[0, I], [-I, 0]]).
+void test_stm(const std::array<std::array<double, 3>, 2> &pos_vel, double tof)
+{
+    auto pos_vel_after = pos_vel;
+    const auto stm = kep3::propagate_lagrangian_stm(pos_vel_after, tof, 1.);
+    auto pos_vel_ref = pos_vel;
+    propagate_lagrangian(pos_vel_ref, tof, 1.);
+    REQUIRE(pos_vel_after == pos_vel_ref);
+
+    double max_abs = 0.;
+    for (auto el : stm) {
+        max_abs = std::max(max_abs, std::abs(el));
+    }
+    for (auto j = 0u; j < 6u; ++j) {
+        const double h = 1e-6 * std::max(1., std::abs(pos_vel[j / 3u][j % 3u]));
+        auto plus = pos_vel, minus = pos_vel;
+        plus[j / 3u][j % 3u] += h;
+        minus[j / 3u][j % 3u] -= h;
+        propagate_lagrangian(plus, tof, 1.);
+        propagate_lagrangian(minus, tof, 1.);
+        for (auto i = 0u; i < 6u; ++i) {
+            const double fd = (plus[i / 3u][i % 3u] - minus[i / 3u][i % 3u]) / (2 * h);
+            REQUIRE_THAT(stm[6u * i + j], WithinAbs(fd, 1e-5 * max_abs));
+        }
+    }
+    for (auto i = 0u; i < 6u; ++i) {
+        for (auto j = 0u; j < 6u; ++j) {
+            double res = 0.;
+            for (auto k = 0u; k < 3u; ++k) {
+                res += stm[6u * k + i] * stm[6u * (k + 3u) + j] - stm[6u * (k + 3u) + i] * stm[6u * k + j];
+            }
+            const double J = (j == i + 3u) ? 1. : ((i == j + 3u) ? -1. : 0.);
+            REQUIRE_THAT(res, WithinAbs(J, 1e-12 * max_abs * max_abs));
+        }
+    }
+}
+
 TEST_CASE("propagate_lagrangian")
 {
     // We test both Normal and Universal variables version with the same data.
@@ -150,6 +194,100 @@ TEST_CASE("propagate_lagrangian")
     test_propagate_lagrangian(&propagate_lagrangian_u, 10000u);
 }
 
+TEST_CASE("hyperbolic_starter")
+{
+    // Near parabolic and very eccentric hyperbolas, over long times of flight: both propagators,
+    // which now share the starter of the hyperbolic Kepler's equation, must agree.
+    // NOLINTNEXTLINE(cert-msc32-c, cert-msc51-cpp)
+    std::mt19937 rng_engine(2024u);
+    std::uniform_real_distribution<double> log_ecc_d(-2., 2.), log_tof_d(-2., 3.), angle_d(0., 2 * pi);
+    for (auto i = 0u; i < 10000u; ++i) {
+        const double ecc = 1. + std::pow(10., log_ecc_d(rng_engine));
+        double f = angle_d(rng_engine);
+        while (std::cos(f) < -1. / ecc) {
+            f = angle_d(rng_engine);
+        }
+        const auto pos_vel = kep3::par2ic(
+            {-1.5, ecc, angle_d(rng_engine) / 2, angle_d(rng_engine), angle_d(rng_engine), f}, 1.);
+        const double tof = ((i % 2u == 0u) ? 1. : -1.) * std::pow(10., log_tof_d(rng_engine));
+        auto pos_vel_l = pos_vel, pos_vel_u = pos_vel;
+        propagate_lagrangian(pos_vel_l, tof, 1.);
+        propagate_lagrangian_u(pos_vel_u, tof, 1.);
+        REQUIRE(kep3_tests::floating_point_error_vector(pos_vel_l[0], pos_vel_u[0]) < 1e-10);
+    }
+}
+
+TEST_CASE("propagate_lagrangian_grid")
+{
+    // NOLINTNEXTLINE(cert-msc32-c, cert-msc51-cpp)
+    std::mt19937 rng_engine(1224u);
+    std::uniform_real_distribution<double> dt_d(-50., 50.);
+    for (const auto &par : {std::array<double, 6>{1.3, 0.1, 0.3, 0.2, 0.1, 0.5}, {2., 0.97, 1.3, 2.2, 4.1, 3.},
+                            {-1.5, 1.3, 0.3, 0.2, 0.1, 0.5}, {-3., 6., 2.3, 1.2, 0.1, -0.1}}) {
+        const auto pos_vel = kep3::par2ic(par, 1.1);
+        // Sorted, with a zero and a large gap, then in random order.
+        std::vector<double> dts;
+        for (auto i = 0u; i <= 500u; ++i) {
+            dts.push_back(0.04 * (static_cast<double>(i) - 500.));
+        }
+        dts.push_back(1000.);
+        for (auto i = 0u; i < 500u; ++i) {
+            dts.push_back(dt_d(rng_engine));
+        }
+        std::vector<double> out(6u * dts.size());
+        kep3::propagate_lagrangian_grid(pos_vel, dts, 1.1, out);
+        for (decltype(dts.size()) i = 0u; i < dts.size(); ++i) {
+            auto ref = pos_vel;
+            propagate_lagrangian(ref, dts[i], 1.1);
+            REQUIRE(kep3_tests::floating_point_error_vector(ref[0], {out[6u * i], out[6u * i + 1u], out[6u * i + 2u]})
+                    < 1e-13);
+            REQUIRE(kep3_tests::floating_point_error_vector(
+                        ref[1], {out[6u * i + 3u], out[6u * i + 4u], out[6u * i + 5u]})
+                    < 1e-13);
+        }
+        REQUIRE_THAT(out[6u * 500u], WithinAbs(pos_vel[0][0], 1e-15));
+    }
+    const std::array<std::array<double, 3>, 2> pos_vel = {{{1., 0, 0.}, {0., 1., 0.}}};
+    std::vector<double> dts = {1., 2.}, out(11u);
+    REQUIRE_THROWS_AS(kep3::propagate_lagrangian_grid(pos_vel, dts, 1., out), std::invalid_argument);
+    REQUIRE_NOTHROW(kep3::propagate_lagrangian_grid(pos_vel, {}, 1., {}));
+}
+
+TEST_CASE("stumpff")
+{
+    // Against the closed forms in long double, away from z = 0 and across the switch to the series.
+    for (double z : {-50., -3., -1.0001, -1., -0.9999, -0.5, -1e-3, 1e-3, 0.5, 0.9999, 1., 1.0001, 3., 50.}) {
+        const auto [C, S] = kep3::stumpff(z);
+        const long double x = std::sqrt(std::abs(static_cast<long double>(z)));
+        const long double C_ref = z > 0 ? (1 - std::cos(x)) / (x * x) : (std::cosh(x) - 1) / (x * x);
+        const long double S_ref = z > 0 ? (x - std::sin(x)) / (x * x * x) : (std::sinh(x) - x) / (x * x * x);
+        REQUIRE_THAT(C, WithinAbs(static_cast<double>(C_ref), 1e-15 * std::abs(C)));
+        REQUIRE_THAT(S, WithinAbs(static_cast<double>(S_ref), 1e-14 * std::abs(S)));
+    }
+    // Close to z = 0, against the first terms of the series.
+    for (double z : {0., 1e-12, -1e-12, 1e-8, -1e-8}) {
+        const auto [C, S] = kep3::stumpff(z);
+        REQUIRE_THAT(C, WithinAbs(0.5 - z / 24., 1e-16));
+        REQUIRE_THAT(S, WithinAbs(1. / 6. - z / 120., 1e-16));
+    }
+    // The derivatives of Kepler's equation in DS, against central finite differences.
+    for (double alpha : {0.7, -0.4, 1e-9}) {
+        for (double DS : {0.3, 1.5}) {
+            const double h = 1e-6;
+            const double d_fd
+                = (kep3::kepDS(DS + h, 1.2, 1.1, 0.2, alpha, 1.3) - kep3::kepDS(DS - h, 1.2, 1.1, 0.2, alpha, 1.3))
+                  / (2 * h);
+            const double dd_fd
+                = (kep3::d_kepDS(DS + h, 1.1, 0.2, alpha, 1.3) - kep3::d_kepDS(DS - h, 1.1, 0.2, alpha, 1.3)) / (2 * h);
+            REQUIRE_THAT(kep3::d_kepDS(DS, 1.1, 0.2, alpha, 1.3), WithinAbs(d_fd, 1e-8));
+            REQUIRE_THAT(kep3::dd_kepDS(DS, 1.1, 0.2, alpha, 1.3), WithinAbs(dd_fd, 1e-8));
+            const auto [f, df] = kep3::kepDS_d_kepDS(DS, 1.2, 1.1, 1.1 * 0.2 / std::sqrt(1.3), alpha, std::sqrt(1.3));
+            REQUIRE_THAT(f, WithinAbs(kep3::kepDS(DS, 1.2, 1.1, 0.2, alpha, 1.3), 1e-15));
+            REQUIRE_THAT(df, WithinAbs(kep3::d_kepDS(DS, 1.1, 0.2, alpha, 1.3), 1e-15));
+        }
+    }
+}
+
 TEST_CASE("extreme_orbit_H")
 {
     std::array<std::array<double, 3>, 2> pos_vel = {{{-0.3167755980094844, -1.916113450769878, 0.899028670370861},
@@ -160,4 +298,39 @@ TEST_CASE("extreme_orbit_H")
     REQUIRE(
         kep3_tests::floating_point_error_vector(pos_vel[0], {0.6049892513157507, 1.314038087851452, 1.747826097602214})
         < 1e-11);
-}
\ No newline at end of file
+}
+
+TEST_CASE("propagate_lagrangian_stm")
+{
+    // NOLINTNEXTLINE(cert-msc32-c, cert-msc51-cpp)
+    std::mt19937 rng_engine(4353u);
+    std::uniform_real_distribution<double> sma_d(1.1, 10.);
+    std::uniform_real_distribution<double> ecc_ell_d(0, 0.9);
+    std::uniform_real_distribution<double> ecc_hyp_d(2., 20.);
+    std::uniform_real_distribution<double> angle_d(0., pi);
+    std::uniform_real_distribution<double> f_d(0, 2 * pi);
+    // Short and long (multiple revolutions) times of flight, forward and backward.
+    std::uniform_real_distribution<double> time_d(-100., 100.);
+    for (auto i = 0u; i < 300u; ++i) {
+        std::array<double, 6> par{};
+        if (i % 2u == 0u) {
+            par = {sma_d(rng_engine),   ecc_ell_d(rng_engine), angle_d(rng_engine),
+                   angle_d(rng_engine), angle_d(rng_engine),   f_d(rng_engine)};
+        } else {
+            // Hyperbola, with a true anomaly within the asymptotes.
+            par = {-sma_d(rng_engine), ecc_hyp_d(rng_engine), angle_d(rng_engine), angle_d(rng_engine),
+                   angle_d(rng_engine), 0.};
+            par[5] = std::acos(-1. / par[1]) * (f_d(rng_engine) / pi - 1.) * 0.9;
+        }
+        const auto pos_vel = kep3::par2ic(par, 1.);
+        test_stm(pos_vel, time_d(rng_engine) / (i % 3u == 0u ? 1000. : 1.));
+    }
+    // Zero time of flight.
+    std::array<std::array<double, 3>, 2> pos_vel = {{{1., 0.1, 0.}, {0., 1., 0.2}}};
+    const auto stm = kep3::propagate_lagrangian_stm(pos_vel, 0., 1.);
+    for (auto i = 0u; i < 6u; ++i) {
+        for (auto j = 0u; j < 6u; ++j) {
+            REQUIRE_THAT(stm[6u * i + j], WithinAbs(i == j ? 1. : 0., 1e-15));
+        }
+    }
+}